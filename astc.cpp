@@ -0,0 +1,143 @@
+/**
+ * OpenGL ES 2.0 memory performance estimator
+ * Copyright (C) 2012 Google
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * \author Sami Kyöstilä <skyostil@google.com>
+ *
+ * ASTC texture compression
+ */
+#include "astc.h"
+#include "util.h"
+
+#include <algorithm>
+#include <string.h>
+
+/** Block mode for a 4x4 weight grid with weights in the range 0..3 */
+static const int blockMode = 0x042;
+
+/** LDR RGBA direct color endpoint mode */
+static const int endpointMode = 12;
+
+static const int gridSize = 4;
+
+/**
+ *  Write the low bits of a value into a little-endian bit stream
+ */
+static void writeBits(unsigned char* block, int offset, int count, int value)
+{
+    for (int i = 0; i < count; i++, offset++)
+    {
+        if (value & (1 << i))
+        {
+            block[offset / 8] |= 1 << (offset % 8);
+        }
+    }
+}
+
+static void encodeBlock(const unsigned char* rgba, int width, int height,
+                        int x0, int y0, int blockWidth, int blockHeight,
+                        unsigned char* out)
+{
+    int low[4] = {255, 255, 255, 255};
+    int high[4] = {0, 0, 0, 0};
+
+    for (int y = 0; y < blockHeight; y++)
+    {
+        for (int x = 0; x < blockWidth; x++)
+        {
+            const unsigned char* p = rgba +
+                (std::min(y0 + y, height - 1) * width + std::min(x0 + x, width - 1)) * 4;
+            for (int c = 0; c < 4; c++)
+            {
+                low[c] = std::min(low[c], static_cast<int>(p[c]));
+                high[c] = std::max(high[c], static_cast<int>(p[c]));
+            }
+        }
+    }
+
+    memset(out, 0, 16);
+    writeBits(out, 0, 11, blockMode);
+    writeBits(out, 11, 2, 0);
+    writeBits(out, 13, 4, endpointMode);
+
+    // Endpoints interleaved as r0 r1 g0 g1 b0 b1 a0 a1 with eight bits each.
+    // The second endpoint is never darker than the first, so the decoder
+    // does not apply blue contraction.
+    for (int c = 0; c < 4; c++)
+    {
+        writeBits(out, 17 + c * 16, 8, low[c]);
+        writeBits(out, 17 + c * 16 + 8, 8, high[c]);
+    }
+
+    // Weights project each grid sample onto the line between the endpoints.
+    // The weight stream is stored bit-reversed from the top of the block.
+    int axis[4], length = 0;
+    for (int c = 0; c < 4; c++)
+    {
+        axis[c] = high[c] - low[c];
+        length += axis[c] * axis[c];
+    }
+
+    for (int t = 0; t < gridSize; t++)
+    {
+        for (int s = 0; s < gridSize; s++)
+        {
+            int x = std::min(x0 + s * (blockWidth - 1) / (gridSize - 1), width - 1);
+            int y = std::min(y0 + t * (blockHeight - 1) / (gridSize - 1), height - 1);
+            const unsigned char* p = rgba + (y * width + x) * 4;
+            int dot = 0;
+
+            for (int c = 0; c < 4; c++)
+            {
+                dot += (p[c] - low[c]) * axis[c];
+            }
+
+            int weight = length ? (dot * 3 + length / 2) / length : 0;
+            weight = std::max(0, std::min(3, weight));
+
+            int bit = (t * gridSize + s) * 2;
+            for (int i = 0; i < 2; i++)
+            {
+                if (weight & (1 << i))
+                {
+                    int offset = 127 - (bit + i);
+                    out[offset / 8] |= 1 << (offset % 8);
+                }
+            }
+        }
+    }
+}
+
+void encodeASTC(const unsigned char* rgba, int width, int height,
+                int blockWidth, int blockHeight, std::vector<unsigned char>& out)
+{
+    ASSERT(blockWidth >= gridSize && blockHeight >= gridSize);
+
+    int blocksX = (width + blockWidth - 1) / blockWidth;
+    int blocksY = (height + blockHeight - 1) / blockHeight;
+
+    out.resize(blocksX * blocksY * 16);
+
+    for (int by = 0; by < blocksY; by++)
+    {
+        for (int bx = 0; bx < blocksX; bx++)
+        {
+            encodeBlock(rgba, width, height, bx * blockWidth, by * blockHeight,
+                        blockWidth, blockHeight, &out[(by * blocksX + bx) * 16]);
+        }
+    }
+}
@@ -0,0 +1,45 @@
+/**
+ * OpenGL ES 2.0 memory performance estimator
+ * Copyright (C) 2012 Google
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * \author Sami Kyöstilä <skyostil@google.com>
+ *
+ * ASTC texture compression
+ */
+#ifndef ASTC_H
+#define ASTC_H
+
+#include <vector>
+
+/**
+ *  Compress an image to LDR ASTC. Every block uses a single partition with
+ *  RGBA endpoints and a 4x4 grid of 2-bit weights, regardless of the block
+ *  footprint. This is fast and gives representative data sizes rather than
+ *  good quality. Edge blocks are padded by repeating the last row and
+ *  column.
+ *
+ *  @param rgba                 Source pixels in RGBA8888
+ *  @param width                Image width in pixels
+ *  @param height               Image height in pixels
+ *  @param blockWidth           Block footprint width, at least 4
+ *  @param blockHeight          Block footprint height, at least 4
+ *  @param out                  Output: 16 bytes per block
+ */
+void encodeASTC(const unsigned char* rgba, int width, int height,
+                int blockWidth, int blockHeight, std::vector<unsigned char>& out);
+
+#endif // ASTC_H
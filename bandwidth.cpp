@@ -0,0 +1,268 @@
+/**
+ * OpenGL ES 2.0 memory performance estimator
+ * Copyright (C) 2012 Google
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * \author Sami Kyöstilä <skyostil@google.com>
+ *
+ * CPU memory bandwidth measurement
+ */
+#include "bandwidth.h"
+#include "util.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <vector>
+
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#define BANDWIDTH_NEON
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define BANDWIDTH_SSE2
+#endif
+
+static const char* kernelNames[BANDWIDTH_KERNEL_COUNT] =
+{
+    "copy", "scale", "add", "triad"
+};
+
+/** Number of arrays each kernel reads and writes */
+static const int kernelArrays[BANDWIDTH_KERNEL_COUNT] =
+{
+    2, 2, 3, 3
+};
+
+/**
+ *  A slice of the arrays processed by one thread
+ */
+struct BandwidthJob
+{
+    BandwidthKernel kernel;
+    float* a;
+    float* b;
+    float* c;
+    size_t count;
+};
+
+// The kernels use NEON or SSE2 explicitly since compilers won't vectorize
+// float arithmetic for NEON without -ffast-math. Each one finishes the last
+// few elements with the scalar loop.
+
+static void copyKernel(float* __restrict__ c, const float* __restrict__ a, size_t n)
+{
+    size_t i = 0;
+#if defined(BANDWIDTH_NEON)
+    for (; i + 4 <= n; i += 4)
+    {
+        vst1q_f32(c + i, vld1q_f32(a + i));
+    }
+#elif defined(BANDWIDTH_SSE2)
+    for (; i + 4 <= n; i += 4)
+    {
+        _mm_storeu_ps(c + i, _mm_loadu_ps(a + i));
+    }
+#endif
+    for (; i < n; i++)
+    {
+        c[i] = a[i];
+    }
+}
+
+static void scaleKernel(float* __restrict__ b, const float* __restrict__ c, float s, size_t n)
+{
+    size_t i = 0;
+#if defined(BANDWIDTH_NEON)
+    for (; i + 4 <= n; i += 4)
+    {
+        vst1q_f32(b + i, vmulq_n_f32(vld1q_f32(c + i), s));
+    }
+#elif defined(BANDWIDTH_SSE2)
+    const __m128 scale = _mm_set1_ps(s);
+    for (; i + 4 <= n; i += 4)
+    {
+        _mm_storeu_ps(b + i, _mm_mul_ps(_mm_loadu_ps(c + i), scale));
+    }
+#endif
+    for (; i < n; i++)
+    {
+        b[i] = s * c[i];
+    }
+}
+
+static void addKernel(float* __restrict__ c, const float* __restrict__ a,
+                      const float* __restrict__ b, size_t n)
+{
+    size_t i = 0;
+#if defined(BANDWIDTH_NEON)
+    for (; i + 4 <= n; i += 4)
+    {
+        vst1q_f32(c + i, vaddq_f32(vld1q_f32(a + i), vld1q_f32(b + i)));
+    }
+#elif defined(BANDWIDTH_SSE2)
+    for (; i + 4 <= n; i += 4)
+    {
+        _mm_storeu_ps(c + i, _mm_add_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+    }
+#endif
+    for (; i < n; i++)
+    {
+        c[i] = a[i] + b[i];
+    }
+}
+
+static void triadKernel(float* __restrict__ a, const float* __restrict__ b,
+                        const float* __restrict__ c, float s, size_t n)
+{
+    size_t i = 0;
+#if defined(BANDWIDTH_NEON)
+    for (; i + 4 <= n; i += 4)
+    {
+        vst1q_f32(a + i, vmlaq_n_f32(vld1q_f32(b + i), vld1q_f32(c + i), s));
+    }
+#elif defined(BANDWIDTH_SSE2)
+    const __m128 scale = _mm_set1_ps(s);
+    for (; i + 4 <= n; i += 4)
+    {
+        _mm_storeu_ps(a + i, _mm_add_ps(_mm_loadu_ps(b + i),
+                                        _mm_mul_ps(_mm_loadu_ps(c + i), scale)));
+    }
+#endif
+    for (; i < n; i++)
+    {
+        a[i] = b[i] + s * c[i];
+    }
+}
+
+static void* runJob(void* arg)
+{
+    const BandwidthJob* job = static_cast<const BandwidthJob*>(arg);
+    const float s = 3.0f;
+
+    switch (job->kernel)
+    {
+    case BANDWIDTH_COPY:
+        copyKernel(job->c, job->a, job->count);
+        break;
+    case BANDWIDTH_SCALE:
+        scaleKernel(job->b, job->c, s, job->count);
+        break;
+    case BANDWIDTH_ADD:
+        addKernel(job->c, job->a, job->b, job->count);
+        break;
+    case BANDWIDTH_TRIAD:
+        triadKernel(job->a, job->b, job->c, s, job->count);
+        break;
+    }
+    return 0;
+}
+
+BandwidthResult measureBandwidth(size_t arraySize, int threads, int repeats)
+{
+    size_t count = arraySize / sizeof(float);
+    std::vector<float> a(count, 1.0f), b(count, 2.0f), c(count, 0.0f);
+    std::vector<BandwidthJob> jobs(threads);
+    std::vector<pthread_t> workers(threads);
+    BandwidthResult result;
+
+    ASSERT(threads >= 1 && repeats >= 1 && count >= static_cast<size_t>(threads));
+    result.threads = threads;
+
+    for (int k = 0; k < BANDWIDTH_KERNEL_COUNT; k++)
+    {
+        int64_t best = 0;
+
+        for (int t = 0; t < threads; t++)
+        {
+            size_t first = count * t / threads;
+            jobs[t].kernel = static_cast<BandwidthKernel>(k);
+            jobs[t].a = &a[first];
+            jobs[t].b = &b[first];
+            jobs[t].c = &c[first];
+            jobs[t].count = count * (t + 1) / threads - first;
+        }
+
+        for (int r = 0; r < repeats; r++)
+        {
+            struct timespec start, end;
+
+            int started = 1;
+
+            // The calling thread processes the first slice itself
+            clock_gettime(CLOCK_MONOTONIC, &start);
+            while (started < threads && !pthread_create(&workers[started], 0, runJob, &jobs[started]))
+            {
+                started++;
+            }
+            runJob(&jobs[0]);
+            for (int t = 1; t < started; t++)
+            {
+                pthread_join(workers[t], 0);
+            }
+            clock_gettime(CLOCK_MONOTONIC, &end);
+
+            // Only the threads that were actually created are joined
+            ASSERT(started == threads);
+
+            int64_t elapsed = timeDiff(start, end);
+            if (!best || elapsed < best)
+            {
+                best = elapsed;
+            }
+        }
+
+        result.bytesPerSecond[k] =
+            (1000 * 1000 * 1000.0 * kernelArrays[k] * count * sizeof(float)) / best;
+    }
+    return result;
+}
+
+double peakBandwidth(const BandwidthResult& result)
+{
+    double peak = 0;
+
+    for (int k = 0; k < BANDWIDTH_KERNEL_COUNT; k++)
+    {
+        if (result.bytesPerSecond[k] > peak)
+        {
+            peak = result.bytesPerSecond[k];
+        }
+    }
+    return peak;
+}
+
+std::string bandwidthSummary(const BandwidthResult& result)
+{
+    std::string summary;
+    char label[16], buf[32];
+
+    snprintf(label, sizeof(label), "%d thread%s:", result.threads, (result.threads > 1) ? "s" : "");
+    snprintf(buf, sizeof(buf), "%-12s", label);
+    summary = buf;
+    for (int k = 0; k < BANDWIDTH_KERNEL_COUNT; k++)
+    {
+        snprintf(buf, sizeof(buf), " %s %6.2f", kernelNames[k], result.bytesPerSecond[k] / 1e9);
+        summary += buf;
+    }
+    return summary + " GB/s";
+}
+
+int cpuCount()
+{
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return (count > 0) ? static_cast<int>(count) : 1;
+}
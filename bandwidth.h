@@ -0,0 +1,76 @@
+/**
+ * OpenGL ES 2.0 memory performance estimator
+ * Copyright (C) 2012 Google
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * \author Sami Kyöstilä <skyostil@google.com>
+ *
+ * CPU memory bandwidth measurement
+ */
+#ifndef BANDWIDTH_H
+#define BANDWIDTH_H
+
+#include <string>
+#include <stddef.h>
+
+/**
+ *  STREAM kernels over the arrays a, b and c with a scalar s
+ */
+enum BandwidthKernel
+{
+    BANDWIDTH_COPY,             //< c = a
+    BANDWIDTH_SCALE,            //< b = s * c
+    BANDWIDTH_ADD,              //< c = a + b
+    BANDWIDTH_TRIAD,            //< a = b + s * c
+};
+
+const int BANDWIDTH_KERNEL_COUNT = 4;
+
+struct BandwidthResult
+{
+    int threads;
+    double bytesPerSecond[BANDWIDTH_KERNEL_COUNT];  //< Best of all repetitions
+};
+
+/**
+ *  Measure the CPU memory bandwidth with STREAM style kernels. Each kernel
+ *  is run over the whole arrays, which are split evenly between the
+ *  threads.
+ *
+ *  @param arraySize            Size of each of the three arrays in bytes
+ *  @param threads              Number of threads
+ *  @param repeats              Number of times each kernel is run
+ *
+ *  @returns the bandwidth of each kernel
+ */
+BandwidthResult measureBandwidth(size_t arraySize, int threads, int repeats = 5);
+
+/**
+ *  @returns the highest bandwidth of any kernel in bytes per second
+ */
+double peakBandwidth(const BandwidthResult& result);
+
+/**
+ *  @returns a one-line description of the bandwidth of each kernel
+ */
+std::string bandwidthSummary(const BandwidthResult& result);
+
+/**
+ *  @returns the number of online CPUs
+ */
+int cpuCount();
+
+#endif // BANDWIDTH_H
@@ -0,0 +1,151 @@
+/**
+ * OpenGL ES 2.0 memory performance estimator
+ * Copyright (C) 2012 Google
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * \author Sami Kyöstilä <skyostil@google.com>
+ *
+ * Blend mode test
+ */
+#include "blendtest.h"
+#include "util.h"
+
+#include <sstream>
+
+BlendTest::BlendTest(BlendMode mode, int layers, GLenum format, GLenum type,
+                     int width, int height, const std::string& fileName):
+    BlitTest(format, type, width, height, fileName),
+    m_mode(mode),
+    m_layers(layers),
+    m_layerBytes(0)
+{
+    ASSERT(m_layers >= 1);
+}
+
+void BlendTest::prepare()
+{
+    BlitTest::prepare();
+
+    switch (m_mode)
+    {
+    case BLEND_NONE:
+        break;
+    case BLEND_PREMULTIPLIED:
+        glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+        break;
+    case BLEND_STRAIGHT:
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        break;
+    case BLEND_ADDITIVE:
+        glBlendFunc(GL_ONE, GL_ONE);
+        break;
+    case BLEND_MULTIPLY:
+        glBlendFunc(GL_DST_COLOR, GL_ZERO);
+        break;
+    case BLEND_SEPARATE:
+        glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA,
+                            GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+        break;
+    }
+
+    if (m_mode != BLEND_NONE)
+    {
+        glEnable(GL_BLEND);
+    }
+    ASSERT_GL();
+
+    // Every layer covers the whole surface; a blended layer reads the
+    // destination pixel before writing it back
+    EGLint width, height, colorBits;
+    eglQuerySurface(ctx.dpy, ctx.surface, EGL_WIDTH, &width);
+    eglQuerySurface(ctx.dpy, ctx.surface, EGL_HEIGHT, &height);
+    eglGetConfigAttrib(ctx.dpy, ctx.config, EGL_BUFFER_SIZE, &colorBits);
+    ASSERT_EGL();
+
+    m_layerBytes = static_cast<int64_t>(width) * height * ((colorBits + 7) / 8);
+    if (m_mode != BLEND_NONE)
+    {
+        m_layerBytes *= 2;
+    }
+}
+
+void BlendTest::operator()(int frame)
+{
+    glClear(GL_COLOR_BUFFER_BIT);
+    for (int i = 0; i < m_layers; i++)
+    {
+        render(frame);
+    }
+}
+
+void BlendTest::teardown()
+{
+    glBlendFunc(GL_ONE, GL_ZERO);
+    glDisable(GL_BLEND);
+    BlitTest::teardown();
+}
+
+int64_t BlendTest::bytesPerFrame() const
+{
+    return m_layerBytes * m_layers;
+}
+
+std::string BlendTest::nameForMode(BlendMode mode) const
+{
+    std::stringstream s;
+
+    s << "blend_";
+    switch (mode)
+    {
+    case BLEND_NONE:
+        s << "none";
+        break;
+    case BLEND_PREMULTIPLIED:
+        s << "premul";
+        break;
+    case BLEND_STRAIGHT:
+        s << "straight";
+        break;
+    case BLEND_ADDITIVE:
+        s << "additive";
+        break;
+    case BLEND_MULTIPLY:
+        s << "multiply";
+        break;
+    case BLEND_SEPARATE:
+        s << "separate";
+        break;
+    }
+    s << "_" << m_layers << "layer";
+    s << "_" << textureFormatName(m_format, m_type);
+    s << "_" << m_width << "x" << m_height;
+
+    return s.str();
+}
+
+std::string BlendTest::name() const
+{
+    return nameForMode(m_mode);
+}
+
+std::string BlendTest::baselineName() const
+{
+    if (m_mode == BLEND_NONE)
+    {
+        return "";
+    }
+    return nameForMode(BLEND_NONE);
+}
@@ -0,0 +1,69 @@
+/**
+ * OpenGL ES 2.0 memory performance estimator
+ * Copyright (C) 2012 Google
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * \author Sami Kyöstilä <skyostil@google.com>
+ *
+ * Blend mode test
+ */
+#ifndef BLENDTEST_H
+#define BLENDTEST_H
+
+#include "blittest.h"
+
+enum BlendMode
+{
+    BLEND_NONE,                 //< Blending disabled
+    BLEND_PREMULTIPLIED,        //< ONE, ONE_MINUS_SRC_ALPHA
+    BLEND_STRAIGHT,             //< SRC_ALPHA, ONE_MINUS_SRC_ALPHA
+    BLEND_ADDITIVE,             //< ONE, ONE
+    BLEND_MULTIPLY,             //< DST_COLOR, ZERO
+    BLEND_SEPARATE,             //< Straight color, premultiplied alpha
+};
+
+class BlendTest: public BlitTest
+{
+protected:
+    BlendMode m_mode;
+    int m_layers;
+    int64_t m_layerBytes;
+
+public:
+    /**
+     *  @param mode             Blending mode
+     *  @param layers           Number of full-screen layers drawn per frame
+     *  @param format           Texture format
+     *  @param type             Texture type
+     *  @param width            Texture width in pixels
+     *  @param height           Texture height in pixels
+     *  @param fileName         Texture data
+     */
+    BlendTest(BlendMode mode, int layers, GLenum format, GLenum type,
+              int width, int height, const std::string& fileName);
+
+    void prepare();
+    void operator()(int frame);
+    void teardown();
+    std::string name() const;
+    std::string baselineName() const;
+    int64_t bytesPerFrame() const;
+
+protected:
+    std::string nameForMode(BlendMode mode) const;
+};
+
+#endif // BLENDTEST_H
@@ -21,6 +21,7 @@
  * Generic blitter
  */
 #include "blittest.h"
+#include "texgen.h"
 #include "util.h"
 
 #include <sstream>
@@ -59,6 +60,7 @@ BlitTest::BlitTest(int width, int height,
     m_quadH(quadH),
     m_rotate(rotate),
     m_blend(blend),
+    m_generated(false),
     m_vertSource(defaultVertSource),
     m_fragSource(defaultFragSource)
 {
@@ -78,6 +80,7 @@ BlitTest::BlitTest(GLenum format, GLenum type, int width, int height, const std:
     m_rotate(rotate),
     m_blend(blend),
     m_fileName(fileName),
+    m_generated(fileName.empty() || !fileExists(fileName)),
     m_vertSource(defaultVertSource),
     m_fragSource(defaultFragSource)
 {
@@ -103,18 +106,50 @@ void BlitTest::teardown()
     }
 }
 
+std::string BlitTest::unsupportedReason() const
+{
+    if (m_generated && m_format >= 0x8c00 && !isGeneratedCompressedFormat(m_format))
+    {
+        return "Data file missing and format cannot be generated";
+    }
+    if ((m_fileName.size() || m_generated) && m_format >= 0x8c00 &&
+        !isCompressedFormatSupported(m_format))
+    {
+        return "Compressed format not supported";
+    }
+    return "";
+}
+
 void BlitTest::prepare()
 {
     initializeBlitter();
-    if (m_fileName.size())
+    if (m_generated)
+    {
+        // Generated content stands in for data files that are not installed
+        if (m_format >= 0x8c00)
+        {
+            ASSERT(generateCompressedTexture(GL_TEXTURE_2D, 0, m_format, m_width, m_height));
+        }
+        else
+        {
+            ASSERT(generateTexture(GL_TEXTURE_2D, 0, m_format, m_width, m_height, m_format, m_type));
+        }
+    }
+    else if (m_fileName.size())
     {
+        bool loaded;
         if (m_format >= 0x8c00)
         {
-            loadCompressedTexture(GL_TEXTURE_2D, 0, m_format, m_width, m_height, m_fileName);
+            loaded = loadCompressedTexture(GL_TEXTURE_2D, 0, m_format, m_width, m_height, m_fileName);
         }
         else
         {
-            loadRawTexture(GL_TEXTURE_2D, 0, m_format, m_width, m_height, m_format, m_type, m_fileName);
+            loaded = loadRawTexture(GL_TEXTURE_2D, 0, m_format, m_width, m_height, m_format, m_type, m_fileName);
+        }
+        if (!loaded)
+        {
+            teardown();
+            fail("Unable to load " + m_fileName);
         }
     }
     ASSERT_GL();
@@ -179,6 +214,11 @@ std::string BlitTest::name() const
     s << textureFormatName(m_format, m_type);
     s << "_" << m_width << "x" << m_height;
 
+    if (m_generated)
+    {
+        s << "_gen";
+    }
+
     return s.str();
 }
 
@@ -41,6 +41,7 @@ protected:
     bool m_rotate;
     bool m_blend;
     std::string m_fileName;
+    bool m_generated;
     std::string m_vertSource;
     std::string m_fragSource;
 
@@ -49,10 +50,17 @@ public:
              bool rotate = false, float texW = 1.0f, float texH = 1.0f,
              float quadW = 1.0f, float quadH = 1.0f, bool blend = false);
 
+    /**
+     *  @param fileName         Raw texture data to load, or an empty string
+     *                          to use generated content. Generated content
+     *                          is also used if the file does not exist, in
+     *                          which case the test name ends in "_gen".
+     */
     BlitTest(GLenum format, GLenum type, int width, int height, const std::string& fileName,
              bool rotate = false, float texW = 1.0f, float texH = 1.0f,
              float quadW = 1.0f, float quadH = 1.0f, bool blend = false);
 
+    std::string unsupportedReason() const;
     void prepare();
     void operator()(int frame);
     void teardown();
@@ -0,0 +1,374 @@
+/**
+ * OpenGL ES 2.0 memory performance estimator
+ * Copyright (C) 2012 Google
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * \author Sami Kyöstilä <skyostil@google.com>
+ *
+ * Parametric Gaussian blur test
+ */
+#include "blurtest.h"
+#include "ext.h"
+
+#include <algorithm>
+#include <sstream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+static const char* vertSourceBlur =
+    "precision mediump float;\n"
+    "attribute vec2 in_position;\n"
+    "attribute vec2 in_texcoord;\n"
+    "varying vec2 texcoord;\n"
+    "\n"
+    "void main()\n"
+    "{\n"
+    "	gl_Position = vec4(in_position, 0.0, 1.0);\n"
+    "	texcoord = in_texcoord;\n"
+    "}\n";
+
+static const char* fragSourceCopy =
+    "precision mediump float;\n"
+    "varying vec2 texcoord;\n"
+    "uniform sampler2D texture;\n"
+    "\n"
+    "void main()\n"
+    "{\n"
+    "	gl_FragColor = texture2D(texture, texcoord);\n"
+    "}\n";
+
+enum
+{
+    POSITION_ATTR = 0,
+    TEXCOORD_ATTR = 1,
+};
+
+/**
+ *  Create a program with the attribute locations fixed so that all the
+ *  programs used by the test can share the same vertex arrays.
+ */
+static GLint createBlurTestProgram(const std::string& fragSource)
+{
+    GLint program = createProgram(vertSourceBlur, fragSource);
+    glBindAttribLocation(program, POSITION_ATTR, "in_position");
+    glBindAttribLocation(program, TEXCOORD_ATTR, "in_texcoord");
+    glLinkProgram(program);
+
+    GLint success = 0;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    ASSERT(success);
+
+    glUseProgram(program);
+    glUniform1i(glGetUniformLocation(program, "texture"), 0);
+    ASSERT_GL();
+    return program;
+}
+
+static void emitHeader(std::stringstream& s)
+{
+    s << "precision mediump float;\n"
+         "varying vec2 texcoord;\n"
+         "uniform sampler2D texture;\n"
+         "\n"
+         "void main()\n"
+         "{\n"
+         "	lowp vec3 color = vec3(0.0, 0.0, 0.0);\n";
+}
+
+static void emitTap(std::stringstream& s, float dx, float dy, float weight)
+{
+    s << "	color += texture2D(texture, texcoord + vec2("
+      << dx << ", " << dy << ")).rgb * " << weight << ";\n";
+}
+
+static void emitFooter(std::stringstream& s)
+{
+    s << "	gl_FragColor = vec4(color, 1.0);\n"
+         "}\n";
+}
+
+BlurTest::BlurTest(BlurMethod method, int taps, int downSample, int passes,
+                   int width, int height):
+    m_method(method),
+    m_taps(taps | 1),
+    m_downSample(downSample),
+    m_passes(passes),
+    m_width(width),
+    m_height(height),
+    m_copyProgram(0)
+{
+    m_blurPrograms[0] = m_blurPrograms[1] = 0;
+}
+
+std::string BlurTest::unsupportedReason() const
+{
+    // An NxN kernel of more than 81 samples exceeds the texture fetch and
+    // instruction limits of typical ES2 fragment shaders
+    if (m_method == BLUR_NAIVE_2D && m_taps > 9)
+    {
+        return "Naive 2D blur limited to 9 taps";
+    }
+    return Test::unsupportedReason();
+}
+
+void BlurTest::computeWeights(std::vector<float>& weights) const
+{
+    int radius = m_taps / 2;
+    float sigma = radius / 2.0f + 0.5f;
+    float sum = 0;
+
+    // weights[i] is the weight of the texel i steps away from the center
+    weights.resize(radius + 1);
+    for (int i = 0; i <= radius; i++)
+    {
+        weights[i] = expf(-(i * i) / (2 * sigma * sigma));
+        sum += (i == 0) ? weights[i] : 2 * weights[i];
+    }
+
+    for (int i = 0; i <= radius; i++)
+    {
+        weights[i] /= sum;
+    }
+}
+
+GLint BlurTest::createBlurProgram(float dx, float dy)
+{
+    std::vector<float> weights;
+    std::stringstream s;
+    int radius = m_taps / 2;
+
+    computeWeights(weights);
+    s.setf(std::ios::fixed);
+    s.precision(8);
+    emitHeader(s);
+    emitTap(s, 0, 0, weights[0]);
+
+    if (m_method == BLUR_SEPARABLE_LINEAR)
+    {
+        // Let the texture unit combine two neighboring taps by sampling
+        // between them at an offset proportional to their weights
+        for (int i = 1; i <= radius; i += 2)
+        {
+            float w1 = weights[i];
+            float w2 = (i + 1 <= radius) ? weights[i + 1] : 0;
+            float offset = (i * w1 + (i + 1) * w2) / (w1 + w2);
+            emitTap(s,  offset * dx,  offset * dy, w1 + w2);
+            emitTap(s, -offset * dx, -offset * dy, w1 + w2);
+        }
+    }
+    else
+    {
+        for (int i = 1; i <= radius; i++)
+        {
+            emitTap(s,  i * dx,  i * dy, weights[i]);
+            emitTap(s, -i * dx, -i * dy, weights[i]);
+        }
+    }
+
+    emitFooter(s);
+    return createBlurTestProgram(s.str());
+}
+
+GLint BlurTest::createBlurProgram2D(float dx, float dy)
+{
+    std::vector<float> weights;
+    std::stringstream s;
+    int radius = m_taps / 2;
+
+    computeWeights(weights);
+    s.setf(std::ios::fixed);
+    s.precision(8);
+    emitHeader(s);
+
+    for (int y = -radius; y <= radius; y++)
+    {
+        for (int x = -radius; x <= radius; x++)
+        {
+            emitTap(s, x * dx, y * dy, weights[abs(x)] * weights[abs(y)]);
+        }
+    }
+
+    emitFooter(s);
+    return createBlurTestProgram(s.str());
+}
+
+void BlurTest::prepare()
+{
+    glGetIntegerv(GL_VIEWPORT, m_savedViewport);
+    glClearColor(.2, .4, .6, 1.0);
+
+    m_fboWidth = m_width / m_downSample;
+    m_fboHeight = m_height / m_downSample;
+
+    float dx = 1.0f / m_fboWidth;
+    float dy = 1.0f / m_fboHeight;
+
+    m_copyProgram = createBlurTestProgram(fragSourceCopy);
+    switch (m_method)
+    {
+    case BLUR_NAIVE_2D:
+        m_blurPrograms[0] = createBlurProgram2D(dx, dy);
+        break;
+    case BLUR_SEPARABLE:
+    case BLUR_SEPARABLE_LINEAR:
+        m_blurPrograms[0] = createBlurProgram(dx, 0);
+        m_blurPrograms[1] = createBlurProgram(0, dy);
+        break;
+    }
+
+    glGenTextures(1, &m_texture);
+    glBindTexture(GL_TEXTURE_2D, m_texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    loadCompressedTexture(GL_TEXTURE_2D, 0, GL_ETC1_RGB8_OES, 1024, 512, "data/blur_1024x512_etc1.raw");
+    m_texW = std::min(1.0f, m_width / 1024.0f);
+    m_texH = std::min(1.0f, m_height / 512.0f);
+    ASSERT_GL();
+
+    glGenTextures(2, m_fboTextures);
+    glGenFramebuffers(2, m_framebuffers);
+    for (int i = 0; i < 2; i++)
+    {
+        glBindTexture(GL_TEXTURE_2D, m_fboTextures[i]);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, m_fboWidth, m_fboHeight, 0,
+                     GL_RGB, GL_UNSIGNED_SHORT_5_6_5, NULL);
+        ASSERT_GL();
+
+        glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffers[i]);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_fboTextures[i], 0);
+        GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+        ASSERT(status == GL_FRAMEBUFFER_COMPLETE);
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    glEnableVertexAttribArray(POSITION_ATTR);
+    glEnableVertexAttribArray(TEXCOORD_ATTR);
+    ASSERT_GL();
+}
+
+void BlurTest::drawQuad(GLint program, GLuint texture, float texW, float texH)
+{
+    // A negative texH flips the image vertically
+    float t0 = (texH < 0) ? -texH : 0;
+    float t1 = (texH < 0) ? 0 : texH;
+
+    const GLfloat texcoords[] =
+    {
+         0,     t0,
+         0,     t1,
+         texW,  t0,
+         texW,  t1
+    };
+
+    const GLfloat vertices[] =
+    {
+        -1, -1,
+        -1,  1,
+         1, -1,
+         1,  1
+    };
+
+    glUseProgram(program);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glVertexAttribPointer(POSITION_ATTR, 2, GL_FLOAT, GL_FALSE, 0, vertices);
+    glVertexAttribPointer(TEXCOORD_ATTR, 2, GL_FLOAT, GL_FALSE, 0, texcoords);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+}
+
+void BlurTest::operator()(int frame)
+{
+    int current = 0;
+
+    // Downsample the source image
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffers[current]);
+    glViewport(0, 0, m_fboWidth, m_fboHeight);
+    drawQuad(m_copyProgram, m_texture, m_texW, -m_texH);
+
+    for (int pass = 0; pass < m_passes; pass++)
+    {
+        if (m_method == BLUR_NAIVE_2D)
+        {
+            glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffers[!current]);
+            drawQuad(m_blurPrograms[0], m_fboTextures[current], 1, 1);
+            current = !current;
+        }
+        else
+        {
+            glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffers[!current]);
+            drawQuad(m_blurPrograms[0], m_fboTextures[current], 1, 1);
+            glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffers[current]);
+            drawQuad(m_blurPrograms[1], m_fboTextures[!current], 1, 1);
+        }
+    }
+
+    // Upsample the result to the screen
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(0, 0, m_width, m_height);
+    glClear(GL_COLOR_BUFFER_BIT);
+    drawQuad(m_copyProgram, m_fboTextures[current], 1, 1);
+}
+
+void BlurTest::teardown()
+{
+    glUseProgram(0);
+    glDisableVertexAttribArray(POSITION_ATTR);
+    glDisableVertexAttribArray(TEXCOORD_ATTR);
+    glDeleteProgram(m_copyProgram);
+    for (int i = 0; i < 2; i++)
+    {
+        if (m_blurPrograms[i])
+        {
+            glDeleteProgram(m_blurPrograms[i]);
+            m_blurPrograms[i] = 0;
+        }
+    }
+    glDeleteFramebuffers(2, m_framebuffers);
+    glDeleteTextures(2, m_fboTextures);
+    glDeleteTextures(1, &m_texture);
+    glViewport(m_savedViewport[0], m_savedViewport[1], m_savedViewport[2], m_savedViewport[3]);
+}
+
+std::string BlurTest::name() const
+{
+    std::stringstream s;
+
+    s << "blur_";
+
+    switch (m_method)
+    {
+    case BLUR_NAIVE_2D:
+        s << "2d";
+        break;
+    case BLUR_SEPARABLE:
+        s << "sep";
+        break;
+    case BLUR_SEPARABLE_LINEAR:
+        s << "seplin";
+        break;
+    }
+
+    s << "_" << m_taps << "tap";
+    s << "_ds" << m_downSample;
+    s << "_" << m_passes << "pass";
+    s << "_" << m_width << "x" << m_height;
+
+    return s.str();
+}
@@ -0,0 +1,81 @@
+/**
+ * OpenGL ES 2.0 memory performance estimator
+ * Copyright (C) 2012 Google
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * \author Sami Kyöstilä <skyostil@google.com>
+ *
+ * Parametric Gaussian blur test
+ */
+#ifndef BLURTEST_H
+#define BLURTEST_H
+
+#include "test.h"
+#include "util.h"
+#include <GLES2/gl2.h>
+#include <vector>
+
+enum BlurMethod
+{
+    BLUR_NAIVE_2D,              //< One pass with a full NxN kernel
+    BLUR_SEPARABLE,             //< Horizontal and vertical pass with N taps each
+    BLUR_SEPARABLE_LINEAR,      //< Separable, adjacent taps merged with bilinear filtering
+};
+
+class BlurTest: public Test
+{
+protected:
+    BlurMethod m_method;
+    int m_taps;
+    int m_downSample;
+    int m_passes;
+    int m_width, m_height;
+    int m_fboWidth, m_fboHeight;
+    float m_texW, m_texH;
+    GLint m_copyProgram;
+    GLint m_blurPrograms[2];
+    GLuint m_texture;
+    GLuint m_framebuffers[2];
+    GLuint m_fboTextures[2];
+    GLint m_savedViewport[4];
+
+public:
+    /**
+     *  @param method           Blur kernel implementation
+     *  @param taps             Kernel width in texels (odd, 3-31; at most 9
+     *                          for BLUR_NAIVE_2D)
+     *  @param downSample       Framebuffer downsampling factor
+     *  @param passes           Number of times the kernel is applied
+     *  @param width            Output width in pixels
+     *  @param height           Output height in pixels
+     */
+    BlurTest(BlurMethod method, int taps, int downSample, int passes,
+             int width, int height);
+
+    std::string unsupportedReason() const;
+    void prepare();
+    void operator()(int frame);
+    void teardown();
+    std::string name() const;
+
+protected:
+    GLint createBlurProgram(float dx, float dy);
+    GLint createBlurProgram2D(float dx, float dy);
+    void computeWeights(std::vector<float>& weights) const;
+    void drawQuad(GLint program, GLuint texture, float texW, float texH);
+};
+
+#endif // BLURTEST_H
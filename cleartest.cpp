@@ -21,19 +21,332 @@
  * Clear test
  */
 #include "cleartest.h"
-#include <GLES2/gl2.h>
+#include "util.h"
 
-ClearTest::ClearTest()
+#include <GLES2/gl2ext.h>
+#include <math.h>
+#include <sstream>
+
+ClearTest::ClearTest(GLbitfield mask, float area, ClearMethod method):
+    m_mask(mask),
+    m_area(area),
+    m_method(method),
+    m_useFramebuffer(false),
+    m_format(0),
+    m_type(0),
+    m_width(0),
+    m_height(0),
+    m_bytesPerPixel(0),
+    m_program(0),
+    m_framebuffer(0),
+    m_texture(0),
+    m_depthbuffer(0),
+    m_stencilbuffer(0)
+{
+    ASSERT(m_area > 0.0f && m_area <= 1.0f);
+}
+
+ClearTest::ClearTest(GLenum format, GLenum type, int width, int height,
+                     GLbitfield mask, float area, ClearMethod method):
+    m_mask(mask),
+    m_area(area),
+    m_method(method),
+    m_useFramebuffer(true),
+    m_format(format),
+    m_type(type),
+    m_width(width),
+    m_height(height),
+    m_bytesPerPixel(0),
+    m_program(0),
+    m_framebuffer(0),
+    m_texture(0),
+    m_depthbuffer(0),
+    m_stencilbuffer(0)
+{
+    ASSERT(m_area > 0.0f && m_area <= 1.0f);
+}
+
+std::string ClearTest::unsupportedReason() const
 {
+    bool depth = (m_mask & GL_DEPTH_BUFFER_BIT) != 0;
+    bool stencil = (m_mask & GL_STENCIL_BUFFER_BIT) != 0;
+
+    if (m_useFramebuffer)
+    {
+        // Separate depth and stencil attachments are rarely supported
+        if (depth && stencil && !isGLExtensionSupported("GL_OES_packed_depth_stencil"))
+        {
+            return "GL_OES_packed_depth_stencil not supported";
+        }
+        return Test::unsupportedReason();
+    }
+
+    EGLint depthBits = 0, stencilBits = 0;
+    eglGetConfigAttrib(ctx.dpy, ctx.config, EGL_DEPTH_SIZE, &depthBits);
+    eglGetConfigAttrib(ctx.dpy, ctx.config, EGL_STENCIL_SIZE, &stencilBits);
+
+    if (depth && !depthBits)
+    {
+        return "Window has no depth buffer";
+    }
+    if (stencil && !stencilBits)
+    {
+        return "Window has no stencil buffer";
+    }
+    return Test::unsupportedReason();
+}
+
+void ClearTest::prepareFramebuffer()
+{
+    // The byte count outlives teardown() so that bytesPerFrame() stays valid
+    m_bytesPerPixel = 0;
+
+    glGenTextures(1, &m_texture);
+    glBindTexture(GL_TEXTURE_2D, m_texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexImage2D(GL_TEXTURE_2D, 0, m_format, m_width, m_height, 0,
+                 m_format, m_type, NULL);
+    ASSERT_GL();
+
+    glGenFramebuffers(1, &m_framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                           GL_TEXTURE_2D, m_texture, 0);
+
+    bool depth = (m_mask & GL_DEPTH_BUFFER_BIT) != 0;
+    bool stencil = (m_mask & GL_STENCIL_BUFFER_BIT) != 0;
+
+    // Depth and stencil together always use a packed buffer
+    if (depth && stencil)
+    {
+        glGenRenderbuffers(1, &m_depthbuffer);
+        glBindRenderbuffer(GL_RENDERBUFFER, m_depthbuffer);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8_OES, m_width, m_height);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,
+                                  GL_RENDERBUFFER, m_depthbuffer);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_STENCIL_ATTACHMENT,
+                                  GL_RENDERBUFFER, m_depthbuffer);
+        m_bytesPerPixel += 4;
+    }
+    else
+    {
+        if (depth)
+        {
+            glGenRenderbuffers(1, &m_depthbuffer);
+            glBindRenderbuffer(GL_RENDERBUFFER, m_depthbuffer);
+            glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT16, m_width, m_height);
+            glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,
+                                      GL_RENDERBUFFER, m_depthbuffer);
+            m_bytesPerPixel += 2;
+        }
+        if (stencil)
+        {
+            glGenRenderbuffers(1, &m_stencilbuffer);
+            glBindRenderbuffer(GL_RENDERBUFFER, m_stencilbuffer);
+            glRenderbufferStorage(GL_RENDERBUFFER, GL_STENCIL_INDEX8, m_width, m_height);
+            glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_STENCIL_ATTACHMENT,
+                                      GL_RENDERBUFFER, m_stencilbuffer);
+            m_bytesPerPixel += 1;
+        }
+    }
+    ASSERT_GL();
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    {
+        // teardown() is not called for a test that fails to prepare
+        glBindRenderbuffer(GL_RENDERBUFFER, 0);
+        teardownFramebuffer();
+        fail("Framebuffer configuration not supported");
+    }
+
+    if (m_mask & GL_COLOR_BUFFER_BIT)
+    {
+        m_bytesPerPixel += (m_type != GL_UNSIGNED_BYTE) ? 2 : (m_format == GL_RGB) ? 3 : 4;
+    }
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+    glViewport(0, 0, m_width, m_height);
+}
+
+void ClearTest::prepare()
+{
+    if (m_useFramebuffer)
+    {
+        prepareFramebuffer();
+    }
+    else
+    {
+        EGLint width, height, colorBits, depthBits, stencilBits;
+        eglQuerySurface(ctx.dpy, ctx.surface, EGL_WIDTH, &width);
+        eglQuerySurface(ctx.dpy, ctx.surface, EGL_HEIGHT, &height);
+        eglGetConfigAttrib(ctx.dpy, ctx.config, EGL_BUFFER_SIZE, &colorBits);
+        eglGetConfigAttrib(ctx.dpy, ctx.config, EGL_DEPTH_SIZE, &depthBits);
+        eglGetConfigAttrib(ctx.dpy, ctx.config, EGL_STENCIL_SIZE, &stencilBits);
+        ASSERT_EGL();
+
+        m_width = width;
+        m_height = height;
+        m_bytesPerPixel =
+            ((m_mask & GL_COLOR_BUFFER_BIT) ? colorBits : 0) +
+            ((m_mask & GL_DEPTH_BUFFER_BIT) ? depthBits : 0) +
+            ((m_mask & GL_STENCIL_BUFFER_BIT) ? stencilBits : 0);
+        m_bytesPerPixel = (m_bytesPerPixel + 7) / 8;
+    }
+
     glClearColor(1.0f, 0.27f, 0.0f, 1.0f);
+    glClearDepthf(1.0f);
+    glClearStencil(0x55);
+
+    if (m_area < 1.0f)
+    {
+        // Centered scissor rectangle with the same aspect ratio as the target
+        float scale = sqrtf(m_area);
+        int w = static_cast<int>(m_width * scale);
+        int h = static_cast<int>(m_height * scale);
+        glScissor((m_width - w) / 2, (m_height - h) / 2, w, h);
+        glEnable(GL_SCISSOR_TEST);
+    }
+
+    if (m_method == CLEAR_QUAD)
+    {
+        const char* vertSrc =
+            "attribute vec2 in_position;\n"
+            "void main()\n"
+            "{\n"
+            "    gl_Position = vec4(in_position, 0.0, 1.0);\n"
+            "}\n";
+        const char* fragSrc =
+            "precision mediump float;\n"
+            "void main()\n"
+            "{\n"
+            "    gl_FragColor = vec4(1.0, 0.27, 0.0, 1.0);\n"
+            "}\n";
+
+        m_program = createProgram(vertSrc, fragSrc);
+        m_positionAttr = glGetAttribLocation(m_program, "in_position");
+        glUseProgram(m_program);
+        glEnableVertexAttribArray(m_positionAttr);
+
+        // Only the buffers named in the mask are written
+        GLboolean color = (m_mask & GL_COLOR_BUFFER_BIT) ? GL_TRUE : GL_FALSE;
+        glColorMask(color, color, color, color);
+        if (m_mask & GL_DEPTH_BUFFER_BIT)
+        {
+            glEnable(GL_DEPTH_TEST);
+            glDepthFunc(GL_ALWAYS);
+        }
+        if (m_mask & GL_STENCIL_BUFFER_BIT)
+        {
+            glEnable(GL_STENCIL_TEST);
+            glStencilFunc(GL_ALWAYS, 0x55, 0xff);
+            glStencilOp(GL_REPLACE, GL_REPLACE, GL_REPLACE);
+        }
+    }
+    ASSERT_GL();
 }
 
 void ClearTest::operator()(int frame)
 {
-    glClear(GL_COLOR_BUFFER_BIT);
+    if (m_method == CLEAR_GLCLEAR)
+    {
+        glClear(m_mask);
+        return;
+    }
+
+    const GLfloat vertices[] =
+    {
+        -1, -1,
+        -1,  1,
+         1, -1,
+         1,  1
+    };
+
+    glVertexAttribPointer(m_positionAttr, 2, GL_FLOAT, GL_FALSE, 0, vertices);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+}
+
+void ClearTest::teardown()
+{
+    if (m_program)
+    {
+        glUseProgram(0);
+        glDisableVertexAttribArray(m_positionAttr);
+        glDeleteProgram(m_program);
+        m_program = 0;
+    }
+    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+    glDepthFunc(GL_LESS);
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_STENCIL_TEST);
+    glDisable(GL_SCISSOR_TEST);
+
+    if (m_useFramebuffer)
+    {
+        EGLint width, height;
+        eglQuerySurface(ctx.dpy, ctx.surface, EGL_WIDTH, &width);
+        eglQuerySurface(ctx.dpy, ctx.surface, EGL_HEIGHT, &height);
+
+        teardownFramebuffer();
+        glViewport(0, 0, width, height);
+    }
+}
+
+void ClearTest::teardownFramebuffer()
+{
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glDeleteFramebuffers(1, &m_framebuffer);
+    glDeleteRenderbuffers(1, &m_depthbuffer);
+    glDeleteRenderbuffers(1, &m_stencilbuffer);
+    glDeleteTextures(1, &m_texture);
+    m_framebuffer = m_texture = m_depthbuffer = m_stencilbuffer = 0;
+}
+
+bool ClearTest::capturesWindow() const
+{
+    // Only a full color clear of the window leaves known contents
+    return !m_useFramebuffer && m_area >= 1.0f && (m_mask & GL_COLOR_BUFFER_BIT);
+}
+
+int64_t ClearTest::bytesPerFrame() const
+{
+    float scale = sqrtf(m_area);
+    int64_t w = static_cast<int64_t>(m_width * scale);
+    int64_t h = static_cast<int64_t>(m_height * scale);
+    return w * h * m_bytesPerPixel;
 }
 
 std::string ClearTest::name() const
 {
-    return "clear";
+    std::stringstream s;
+
+    s << "clear";
+    if (m_useFramebuffer)
+    {
+        s << "_fbo_" << textureFormatName(m_format, m_type) << "_" << m_width << "x" << m_height;
+    }
+    if (m_mask != GL_COLOR_BUFFER_BIT)
+    {
+        if (m_mask & GL_COLOR_BUFFER_BIT)
+        {
+            s << "_color";
+        }
+        if (m_mask & GL_DEPTH_BUFFER_BIT)
+        {
+            s << "_depth";
+        }
+        if (m_mask & GL_STENCIL_BUFFER_BIT)
+        {
+            s << "_stencil";
+        }
+    }
+    if (m_area < 1.0f)
+    {
+        s << "_scissor" << static_cast<int>(m_area * 100.0f + 0.5f);
+    }
+    if (m_method == CLEAR_QUAD)
+    {
+        s << "_quad";
+    }
+
+    return s.str();
 }
@@ -24,13 +24,69 @@
 #define CLEARTEST_H
 
 #include "test.h"
+#include <GLES2/gl2.h>
+
+enum ClearMethod
+{
+    CLEAR_GLCLEAR,              //< Clear with glClear()
+    CLEAR_QUAD,                 //< Draw a quad over the cleared area
+};
 
 class ClearTest: public Test
 {
+protected:
+    GLbitfield m_mask;
+    float m_area;
+    ClearMethod m_method;
+    bool m_useFramebuffer;
+    GLenum m_format, m_type;
+    int m_width, m_height;
+    int m_bytesPerPixel;
+
+    GLint m_program;
+    GLint m_positionAttr;
+    GLuint m_framebuffer;
+    GLuint m_texture;
+    GLuint m_depthbuffer;
+    GLuint m_stencilbuffer;
+
 public:
-    ClearTest();
+    /**
+     *  Clear the window
+     *
+     *  @param mask             Buffers to clear
+     *  @param area             Cleared fraction of the surface area
+     *  @param method           Clearing method
+     */
+    ClearTest(GLbitfield mask = GL_COLOR_BUFFER_BIT, float area = 1.0f,
+              ClearMethod method = CLEAR_GLCLEAR);
+
+    /**
+     *  Clear a framebuffer object with a texture color attachment
+     *
+     *  @param format           Color texture format
+     *  @param type             Color texture type
+     *  @param width            Framebuffer width in pixels
+     *  @param height           Framebuffer height in pixels
+     *  @param mask             Buffers to clear
+     *  @param area             Cleared fraction of the surface area
+     *  @param method           Clearing method
+     */
+    ClearTest(GLenum format, GLenum type, int width, int height,
+              GLbitfield mask = GL_COLOR_BUFFER_BIT, float area = 1.0f,
+              ClearMethod method = CLEAR_GLCLEAR);
+
+    std::string unsupportedReason() const;
+    void prepare();
     void operator()(int frame);
+    void teardown();
     std::string name() const;
+    int64_t bytesPerFrame() const;
+    bool capturesWindow() const;
+
+protected:
+    void prepareFramebuffer();
+    void teardownFramebuffer();
 };
 
 #endif // CLEARTEST_H
@@ -0,0 +1,498 @@
+/**
+ * OpenGL ES 2.0 memory performance estimator
+ * Copyright (C) 2012 Google
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * \author Sami Kyöstilä <skyostil@google.com>
+ *
+ * Rounded rectangle clipping test
+ */
+#include "cliptest.h"
+#include "texgen.h"
+#include "util.h"
+
+#include <GLES2/gl2ext.h>
+#include <math.h>
+#include <sstream>
+
+static const char* clipVertSource =
+    "precision mediump float;\n"
+    "attribute vec2 in_position;\n"
+    "attribute vec2 in_texcoord;\n"
+    "varying vec2 texcoord;\n"
+    "\n"
+    "void main()\n"
+    "{\n"
+    "	gl_Position = vec4(in_position, 0.0, 1.0);\n"
+    "	texcoord = in_texcoord;\n"
+    "}\n";
+
+static const char* clipStencilVertSource =
+    "attribute vec2 in_position;\n"
+    "\n"
+    "void main()\n"
+    "{\n"
+    "	gl_Position = vec4(in_position, 0.0, 1.0);\n"
+    "}\n";
+
+static const char* clipStencilFragSource =
+    "precision mediump float;\n"
+    "\n"
+    "void main()\n"
+    "{\n"
+    "	gl_FragColor = vec4(1.0);\n"
+    "}\n";
+
+// Window coordinates need more precision than mediump guarantees
+static const char* clipFragHeader =
+    "#ifdef GL_FRAGMENT_PRECISION_HIGH\n"
+    "precision highp float;\n"
+    "#else\n"
+    "precision mediump float;\n"
+    "#endif\n"
+    "varying vec2 texcoord;\n"
+    "uniform sampler2D texture;\n";
+
+// Signed distance from the fragment to the edge of the rounded rectangle
+static const char* clipShapeDistanceSource =
+    "uniform vec2 center;\n"
+    "uniform vec2 halfSize;\n"
+    "uniform float radius;\n"
+    "\n"
+    "float shapeDistance()\n"
+    "{\n"
+    "	vec2 q = abs(gl_FragCoord.xy - center) - halfSize + radius;\n"
+    "	return length(max(q, 0.0)) + min(max(q.x, q.y), 0.0) - radius;\n"
+    "}\n";
+
+static const char* clipCopySource =
+    "\n"
+    "void main()\n"
+    "{\n"
+    "	gl_FragColor = texture2D(texture, texcoord);\n"
+    "}\n";
+
+static const char* clipDiscardSource =
+    "\n"
+    "void main()\n"
+    "{\n"
+    "	if (shapeDistance() > 0.0)\n"
+    "		discard;\n"
+    "	gl_FragColor = texture2D(texture, texcoord);\n"
+    "}\n";
+
+static const char* clipMaskSource =
+    "uniform sampler2D mask;\n"
+    "\n"
+    "void main()\n"
+    "{\n"
+    "	gl_FragColor = vec4(texture2D(texture, texcoord).rgb,\n"
+    "	                    texture2D(mask, texcoord).a);\n"
+    "}\n";
+
+static const char* clipSDFSource =
+    "\n"
+    "void main()\n"
+    "{\n"
+    "	float coverage = clamp(0.5 - shapeDistance(), 0.0, 1.0);\n"
+    "	gl_FragColor = vec4(texture2D(texture, texcoord).rgb, coverage);\n"
+    "}\n";
+
+/** Line segments used for each corner of the stencil shape */
+static const int cornerSegments = 8;
+
+/**
+ *  Same distance function as in the shaders, with the origin at the center
+ *  of the rectangle
+ */
+static float shapeDistance(float x, float y, float halfW, float halfH, float radius)
+{
+    float qx = fabsf(x) - halfW + radius;
+    float qy = fabsf(y) - halfH + radius;
+    float ox = (qx > 0.0f) ? qx : 0.0f;
+    float oy = (qy > 0.0f) ? qy : 0.0f;
+    float inside = (qx > qy) ? qx : qy;
+
+    return sqrtf(ox * ox + oy * oy) + ((inside < 0.0f) ? inside : 0.0f) - radius;
+}
+
+ClipTest::ClipTest(ClipMethod method, int percent, int radius):
+    m_method(method),
+    m_percent(percent),
+    m_radius(radius),
+    m_width(0),
+    m_height(0),
+    m_clipWidth(0),
+    m_clipHeight(0),
+    m_program(0),
+    m_stencilProgram(0),
+    m_texture(0),
+    m_maskTexture(0),
+    m_framebuffer(0),
+    m_colorTexture(0),
+    m_stencilbuffer(0)
+{
+    ASSERT(m_percent > 0 && m_percent <= 100);
+    ASSERT(m_radius >= 0);
+}
+
+void ClipTest::prepareFramebuffer()
+{
+    glGenTextures(1, &m_colorTexture);
+    glBindTexture(GL_TEXTURE_2D, m_colorTexture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, m_width, m_height, 0,
+                 GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    ASSERT_GL();
+
+    glGenFramebuffers(1, &m_framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                           GL_TEXTURE_2D, m_colorTexture, 0);
+
+    // Stand-alone stencil buffers are not supported everywhere, so fall back
+    // to a packed depth and stencil buffer if needed
+    glGenRenderbuffers(1, &m_stencilbuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, m_stencilbuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_STENCIL_INDEX8, m_width, m_height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_STENCIL_ATTACHMENT,
+                              GL_RENDERBUFFER, m_stencilbuffer);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE &&
+        isGLExtensionSupported("GL_OES_packed_depth_stencil"))
+    {
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8_OES, m_width, m_height);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,
+                                  GL_RENDERBUFFER, m_stencilbuffer);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_STENCIL_ATTACHMENT,
+                                  GL_RENDERBUFFER, m_stencilbuffer);
+    }
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+    ASSERT_GL();
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    {
+        // teardown() is not called for a test that fails to prepare
+        teardownFramebuffer();
+        fail("Framebuffer configuration not supported");
+    }
+
+    glGetIntegerv(GL_VIEWPORT, m_savedViewport);
+    glViewport(0, 0, m_width, m_height);
+}
+
+void ClipTest::teardownFramebuffer()
+{
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glDeleteFramebuffers(1, &m_framebuffer);
+    glDeleteRenderbuffers(1, &m_stencilbuffer);
+    glDeleteTextures(1, &m_colorTexture);
+    m_framebuffer = m_stencilbuffer = m_colorTexture = 0;
+}
+
+void ClipTest::prepareShape()
+{
+    float left = (m_width - m_clipWidth) / 2;
+    float bottom = (m_height - m_clipHeight) / 2;
+    float cornerX[] = {left + m_clipWidth - m_radius, left + m_radius,
+                       left + m_radius, left + m_clipWidth - m_radius};
+    float cornerY[] = {bottom + m_clipHeight - m_radius, bottom + m_clipHeight - m_radius,
+                       bottom + m_radius, bottom + m_radius};
+
+    // Triangle fan around the center of the rectangle going counterclockwise
+    // from the top right corner
+    m_shape.clear();
+    m_shape.push_back(0.0f);
+    m_shape.push_back(0.0f);
+    for (int corner = 0; corner < 4; corner++)
+    {
+        for (int i = 0; i <= cornerSegments; i++)
+        {
+            float angle = (corner + static_cast<float>(i) / cornerSegments) * M_PI / 2;
+            float x = cornerX[corner] + cosf(angle) * m_radius;
+            float y = cornerY[corner] + sinf(angle) * m_radius;
+            m_shape.push_back(2.0f * x / m_width - 1.0f);
+            m_shape.push_back(2.0f * y / m_height - 1.0f);
+        }
+    }
+    m_shape.push_back(m_shape[2]);
+    m_shape.push_back(m_shape[3]);
+}
+
+void ClipTest::prepareMask()
+{
+    std::vector<unsigned char> pixels(m_clipWidth * m_clipHeight);
+    float halfW = m_clipWidth / 2.0f, halfH = m_clipHeight / 2.0f;
+
+    for (int y = 0; y < m_clipHeight; y++)
+    {
+        for (int x = 0; x < m_clipWidth; x++)
+        {
+            float coverage = 0.5f - shapeDistance(x + 0.5f - halfW, y + 0.5f - halfH,
+                                                  halfW, halfH, m_radius);
+            coverage = (coverage < 0.0f) ? 0.0f : ((coverage > 1.0f) ? 1.0f : coverage);
+            pixels[y * m_clipWidth + x] = static_cast<unsigned char>(coverage * 255.0f);
+        }
+    }
+
+    glGenTextures(1, &m_maskTexture);
+    glBindTexture(GL_TEXTURE_2D, m_maskTexture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA, m_clipWidth, m_clipHeight, 0,
+                 GL_ALPHA, GL_UNSIGNED_BYTE, &pixels[0]);
+    ASSERT_GL();
+}
+
+void ClipTest::prepare()
+{
+    EGLint width = 0, height = 0;
+    eglQuerySurface(ctx.dpy, ctx.surface, EGL_WIDTH, &width);
+    eglQuerySurface(ctx.dpy, ctx.surface, EGL_HEIGHT, &height);
+    m_width = width;
+    m_height = height;
+
+    // Centered clip rectangle with the same aspect ratio as the surface
+    float scale = sqrtf(m_percent / 100.0f);
+    m_clipWidth = static_cast<int>(m_width * scale);
+    m_clipHeight = static_cast<int>(m_height * scale);
+    ASSERT(m_clipWidth >= 2 * m_radius && m_clipHeight >= 2 * m_radius);
+
+    prepareFramebuffer();
+
+    // teardown() is not called for a test that fails to prepare, so undo the
+    // framebuffer binding and viewport change here
+    try
+    {
+        prepareScene();
+    }
+    catch (...)
+    {
+        releaseResources();
+        throw;
+    }
+}
+
+void ClipTest::prepareScene()
+{
+    std::string fragSource = clipFragHeader;
+    switch (m_method)
+    {
+    case CLIP_NONE:
+    case CLIP_STENCIL:
+        fragSource += clipCopySource;
+        break;
+    case CLIP_DISCARD:
+        fragSource += clipShapeDistanceSource;
+        fragSource += clipDiscardSource;
+        break;
+    case CLIP_ALPHA_MASK:
+        fragSource += clipMaskSource;
+        break;
+    case CLIP_SDF:
+        fragSource += clipShapeDistanceSource;
+        fragSource += clipSDFSource;
+        break;
+    }
+
+    m_program = createProgram(clipVertSource, fragSource);
+    glUseProgram(m_program);
+
+    m_positionAttr = glGetAttribLocation(m_program, "in_position");
+    m_texcoordAttr = glGetAttribLocation(m_program, "in_texcoord");
+    ASSERT(m_positionAttr >= 0);
+    ASSERT(m_texcoordAttr >= 0);
+    glUniform1i(glGetUniformLocation(m_program, "texture"), 0);
+
+    if (m_method == CLIP_DISCARD || m_method == CLIP_SDF)
+    {
+        glUniform2f(glGetUniformLocation(m_program, "center"), m_width / 2, m_height / 2);
+        glUniform2f(glGetUniformLocation(m_program, "halfSize"),
+                    m_clipWidth / 2.0f, m_clipHeight / 2.0f);
+        glUniform1f(glGetUniformLocation(m_program, "radius"), m_radius);
+    }
+
+    if (m_method == CLIP_ALPHA_MASK)
+    {
+        glUniform1i(glGetUniformLocation(m_program, "mask"), 1);
+        glActiveTexture(GL_TEXTURE1);
+        prepareMask();
+        glActiveTexture(GL_TEXTURE0);
+    }
+
+    if (m_method == CLIP_STENCIL)
+    {
+        m_stencilProgram = createProgram(clipStencilVertSource, clipStencilFragSource);
+        m_stencilPositionAttr = glGetAttribLocation(m_stencilProgram, "in_position");
+        ASSERT(m_stencilPositionAttr >= 0);
+        prepareShape();
+
+        glEnable(GL_STENCIL_TEST);
+        glStencilOp(GL_KEEP, GL_KEEP, GL_REPLACE);
+    }
+
+    if (m_method == CLIP_ALPHA_MASK || m_method == CLIP_SDF)
+    {
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    }
+
+    glGenTextures(1, &m_texture);
+    glBindTexture(GL_TEXTURE_2D, m_texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    ASSERT(generateTexture(GL_TEXTURE_2D, 0, GL_RGBA, m_clipWidth, m_clipHeight,
+                           GL_RGBA, GL_UNSIGNED_BYTE));
+
+    glClearColor(0.2f, 0.4f, 0.6f, 1.0f);
+    glClearStencil(0);
+    ASSERT_GL();
+}
+
+void ClipTest::operator()(int frame)
+{
+    float x = static_cast<float>(m_clipWidth) / m_width;
+    float y = static_cast<float>(m_clipHeight) / m_height;
+
+    const GLfloat vertices[] =
+    {
+        -x, -y,
+        -x,  y,
+         x, -y,
+         x,  y
+    };
+
+    const GLfloat texcoords[] =
+    {
+        0, 0,
+        0, 1,
+        1, 0,
+        1, 1
+    };
+
+    glClear(GL_COLOR_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+
+    if (m_method == CLIP_STENCIL)
+    {
+        // Mark the shape in the stencil buffer without touching the colors
+        glUseProgram(m_stencilProgram);
+        glEnableVertexAttribArray(m_stencilPositionAttr);
+        glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+        glStencilFunc(GL_ALWAYS, 1, 0xff);
+        glVertexAttribPointer(m_stencilPositionAttr, 2, GL_FLOAT, GL_FALSE, 0, &m_shape[0]);
+        glDrawArrays(GL_TRIANGLE_FAN, 0, m_shape.size() / 2);
+        glDisableVertexAttribArray(m_stencilPositionAttr);
+
+        glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+        glStencilFunc(GL_EQUAL, 1, 0xff);
+        glUseProgram(m_program);
+    }
+
+    glEnableVertexAttribArray(m_positionAttr);
+    glEnableVertexAttribArray(m_texcoordAttr);
+    glVertexAttribPointer(m_positionAttr, 2, GL_FLOAT, GL_FALSE, 0, vertices);
+    glVertexAttribPointer(m_texcoordAttr, 2, GL_FLOAT, GL_FALSE, 0, texcoords);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    glDisableVertexAttribArray(m_positionAttr);
+    glDisableVertexAttribArray(m_texcoordAttr);
+}
+
+void ClipTest::releaseResources()
+{
+    glActiveTexture(GL_TEXTURE0);
+    glDisable(GL_STENCIL_TEST);
+    glDisable(GL_BLEND);
+    glViewport(m_savedViewport[0], m_savedViewport[1],
+               m_savedViewport[2], m_savedViewport[3]);
+
+    teardownFramebuffer();
+    glDeleteTextures(1, &m_texture);
+    if (m_maskTexture)
+    {
+        glDeleteTextures(1, &m_maskTexture);
+        m_maskTexture = 0;
+    }
+    m_texture = 0;
+
+    glUseProgram(0);
+    glDeleteProgram(m_program);
+    m_program = 0;
+    if (m_stencilProgram)
+    {
+        glDeleteProgram(m_stencilProgram);
+        m_stencilProgram = 0;
+    }
+    m_shape.clear();
+}
+
+void ClipTest::teardown()
+{
+    releaseResources();
+    ASSERT_GL();
+}
+
+std::string ClipTest::nameForMethod(ClipMethod method) const
+{
+    std::stringstream s;
+
+    s << "clip_";
+    switch (method)
+    {
+    case CLIP_NONE:
+        s << "none";
+        break;
+    case CLIP_STENCIL:
+        s << "stencil";
+        break;
+    case CLIP_DISCARD:
+        s << "discard";
+        break;
+    case CLIP_ALPHA_MASK:
+        s << "mask";
+        break;
+    case CLIP_SDF:
+        s << "sdf";
+        break;
+    }
+    s << "_" << m_percent << "pct_r" << m_radius;
+
+    return s.str();
+}
+
+bool ClipTest::capturesWindow() const
+{
+    // Everything is drawn into the offscreen framebuffer
+    return false;
+}
+
+std::string ClipTest::name() const
+{
+    return nameForMethod(m_method);
+}
+
+std::string ClipTest::baselineName() const
+{
+    if (m_method == CLIP_NONE)
+    {
+        return "";
+    }
+    return nameForMethod(CLIP_NONE);
+}
@@ -0,0 +1,85 @@
+/**
+ * OpenGL ES 2.0 memory performance estimator
+ * Copyright (C) 2012 Google
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * \author Sami Kyöstilä <skyostil@google.com>
+ *
+ * Rounded rectangle clipping test
+ */
+#ifndef CLIPTEST_H
+#define CLIPTEST_H
+
+#include "test.h"
+#include <GLES2/gl2.h>
+#include <vector>
+
+enum ClipMethod
+{
+    CLIP_NONE,                  //< Unclipped bounding rectangle
+    CLIP_STENCIL,               //< Shape drawn into the stencil buffer first
+    CLIP_DISCARD,               //< Fragments outside the shape discarded
+    CLIP_ALPHA_MASK,            //< Coverage from a precomputed A8 mask texture
+    CLIP_SDF,                   //< Coverage from an analytic distance function
+};
+
+/**
+ *  Draws a textured rectangle clipped to a rounded rectangle. Rendering
+ *  goes to a framebuffer object with a stencil attachment, since the window
+ *  config is not guaranteed to have one.
+ */
+class ClipTest: public Test
+{
+protected:
+    ClipMethod m_method;
+    int m_percent;
+    int m_radius;
+    int m_width, m_height;
+    int m_clipWidth, m_clipHeight;
+
+    GLint m_program, m_stencilProgram;
+    GLint m_positionAttr, m_texcoordAttr, m_stencilPositionAttr;
+    GLuint m_texture, m_maskTexture;
+    GLuint m_framebuffer, m_colorTexture, m_stencilbuffer;
+    std::vector<GLfloat> m_shape;
+    GLint m_savedViewport[4];
+
+public:
+    /**
+     *  @param method           Clipping method
+     *  @param percent          Clipped area as a percentage of the surface
+     *  @param radius           Corner radius in pixels
+     */
+    ClipTest(ClipMethod method, int percent, int radius = 24);
+
+    void prepare();
+    void operator()(int frame);
+    void teardown();
+    std::string name() const;
+    bool capturesWindow() const;
+    std::string baselineName() const;
+
+protected:
+    std::string nameForMethod(ClipMethod method) const;
+    void prepareFramebuffer();
+    void teardownFramebuffer();
+    void prepareScene();
+    void releaseResources();
+    void prepareShape();
+    void prepareMask();
+};
+
+#endif // CLIPTEST_H
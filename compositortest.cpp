@@ -0,0 +1,676 @@
+/**
+ * OpenGL ES 2.0 memory performance estimator
+ * Copyright (C) 2012 Google
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * \author Sami Kyöstilä <skyostil@google.com>
+ *
+ * Window compositor scenario test
+ */
+#include "compositortest.h"
+#include "native.h"
+#include "util.h"
+
+#include <sstream>
+#include <string.h>
+
+#if defined(SUPPORT_X11)
+#include <X11/Xutil.h>
+#endif
+
+static const char* compositorVertSource =
+    "precision mediump float;\n"
+    "attribute vec2 in_position;\n"
+    "attribute vec2 in_texcoord;\n"
+    "varying vec2 texcoord;\n"
+    "\n"
+    "void main()\n"
+    "{\n"
+    "	gl_Position = vec4(in_position, 0.0, 1.0);\n"
+    "	texcoord = in_texcoord;\n"
+    "}\n";
+
+static const char* compositorFragSource =
+    "precision mediump float;\n"
+    "varying vec2 texcoord;\n"
+    "uniform sampler2D texture;\n"
+    "uniform float opacity;\n"
+    "\n"
+    "void main()\n"
+    "{\n"
+    "	gl_FragColor = texture2D(texture, texcoord) * opacity;\n"
+    "}\n";
+
+/**
+ *  Parse a texture format name as produced by textureFormatName()
+ */
+static bool parseFormat(const std::string& name, GLenum& format, GLenum& type)
+{
+    if (name == "rgba8888")
+    {
+        format = GL_RGBA;
+        type = GL_UNSIGNED_BYTE;
+    }
+    else if (name == "rgb888")
+    {
+        format = GL_RGB;
+        type = GL_UNSIGNED_BYTE;
+    }
+    else if (name == "rgb565")
+    {
+        format = GL_RGB;
+        type = GL_UNSIGNED_SHORT_5_6_5;
+    }
+    else if (name == "rgba4444")
+    {
+        format = GL_RGBA;
+        type = GL_UNSIGNED_SHORT_4_4_4_4;
+    }
+    else if (name == "rgba5551")
+    {
+        format = GL_RGBA;
+        type = GL_UNSIGNED_SHORT_5_5_5_1;
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+static int bytesPerPixel(GLenum type, GLenum format)
+{
+    if (type == GL_UNSIGNED_BYTE)
+    {
+        return (format == GL_RGB) ? 3 : 4;
+    }
+    return 2;
+}
+
+/**
+ *  Triangle wave going from 0 to 1 and back during each period
+ */
+static float triangle(int frame, int period)
+{
+    float t = static_cast<float>(frame % period) / period;
+    return (t < 0.5f) ? 2.0f * t : 2.0f - 2.0f * t;
+}
+
+#if defined(SUPPORT_X11)
+template <typename TYPE>
+static void fillCompositorImage(XImage& img)
+{
+    TYPE* d = reinterpret_cast<TYPE*>(img.data);
+
+    for (int y = 0; y < img.height; y++)
+    {
+        for (int x = 0; x < img.width; x++)
+        {
+            d[x] = x ^ y;
+        }
+        d += img.bytes_per_line / sizeof(TYPE);
+    }
+}
+#endif // SUPPORT_X11
+
+CompositorWindow::CompositorWindow():
+    x(0), y(0), width(0), height(0),
+    format(0), type(0),
+    contentWidth(0), contentHeight(0),
+    pixmapDepth(0),
+    opacity(1.0f),
+    moveX(0.0f), moveY(0.0f),
+    movePeriod(0),
+    fadeFrom(1.0f), fadeTo(1.0f),
+    fadePeriod(0),
+    scaleFrom(1.0f), scaleTo(1.0f),
+    scalePeriod(0),
+    texture(0),
+    pixmap(0)
+#if defined(SUPPORT_X11)
+    , image(0),
+    gc(0)
+#endif
+{
+    damage[0] = damage[1] = damage[2] = damage[3] = 0;
+}
+
+CompositorTest::CompositorTest(const std::string& fileName):
+    m_fileName(fileName),
+    m_sceneWidth(0),
+    m_sceneHeight(0),
+    m_surfaceWidth(0),
+    m_surfaceHeight(0),
+    m_refreshRate(60),
+    m_program(0),
+    m_positionAttr(-1),
+    m_texcoordAttr(-1),
+    m_unpackAlignment(1)
+{
+}
+
+void CompositorTest::loadScene()
+{
+    std::vector<char> data;
+
+    if (!loadFile(m_fileName, data))
+    {
+        fail("Unable to load scene " + m_fileName);
+    }
+
+    std::istringstream scene(std::string(data.begin(), data.end()));
+    std::string line;
+    int lineNumber = 0;
+
+    m_windows.clear();
+    while (std::getline(scene, line))
+    {
+        std::istringstream s(line);
+        std::string directive;
+        std::stringstream error;
+        bool ok = true;
+
+        lineNumber++;
+        error << m_fileName << ":" << lineNumber << ": ";
+
+        if (!(s >> directive) || directive[0] == '#')
+        {
+            continue;
+        }
+
+        if (directive == "window")
+        {
+            CompositorWindow win;
+            ok = !!(s >> win.x >> win.y >> win.width >> win.height);
+            m_windows.push_back(win);
+        }
+        else if (directive == "size")
+        {
+            ok = !!(s >> m_sceneWidth >> m_sceneHeight);
+        }
+        else if (directive == "refresh")
+        {
+            ok = !!(s >> m_refreshRate);
+        }
+        else if (m_windows.empty())
+        {
+            fail(error.str() + "'" + directive + "' outside a window");
+        }
+        else
+        {
+            CompositorWindow& win = m_windows.back();
+
+            if (directive == "texture")
+            {
+                std::string format;
+                ok = !!(s >> format >> win.contentWidth >> win.contentHeight >> win.fileName);
+                if (ok && !parseFormat(format, win.format, win.type))
+                {
+                    fail(error.str() + "unknown texture format " + format);
+                }
+            }
+            else if (directive == "pixmap")
+            {
+                ok = !!(s >> win.pixmapDepth >> win.contentWidth >> win.contentHeight);
+                ok = ok && (win.pixmapDepth == 16 || win.pixmapDepth == 32);
+            }
+            else if (directive == "opacity")
+            {
+                ok = !!(s >> win.opacity);
+            }
+            else if (directive == "damage")
+            {
+                ok = !!(s >> win.damage[0] >> win.damage[1] >> win.damage[2] >> win.damage[3]);
+            }
+            else if (directive == "move")
+            {
+                ok = !!(s >> win.moveX >> win.moveY >> win.movePeriod);
+                ok = ok && win.movePeriod > 0;
+            }
+            else if (directive == "fade")
+            {
+                ok = !!(s >> win.fadeFrom >> win.fadeTo >> win.fadePeriod);
+                ok = ok && win.fadePeriod > 0;
+            }
+            else if (directive == "scale")
+            {
+                ok = !!(s >> win.scaleFrom >> win.scaleTo >> win.scalePeriod);
+                ok = ok && win.scalePeriod > 0;
+            }
+            else
+            {
+                fail(error.str() + "unknown directive '" + directive + "'");
+            }
+        }
+
+        if (!ok)
+        {
+            fail(error.str() + "invalid arguments for '" + directive + "'");
+        }
+    }
+
+    for (size_t i = 0; i < m_windows.size(); i++)
+    {
+        const CompositorWindow& win = m_windows[i];
+
+        if (!win.format && !win.pixmapDepth)
+        {
+            fail(m_fileName + ": window without contents");
+        }
+        if (win.damage[0] < 0 || win.damage[1] < 0 ||
+            win.damage[0] + win.damage[2] > win.contentWidth ||
+            win.damage[1] + win.damage[3] > win.contentHeight)
+        {
+            fail(m_fileName + ": damage outside window contents");
+        }
+    }
+}
+
+void CompositorTest::prepareTexture(CompositorWindow& win)
+{
+    std::vector<char> pixels;
+    int bpp = bytesPerPixel(win.type, win.format);
+
+    if (!loadFile(win.fileName, pixels))
+    {
+        fail("Unable to load " + win.fileName);
+    }
+    if (pixels.size() < static_cast<size_t>(win.contentWidth * win.contentHeight * bpp))
+    {
+        fail(win.fileName + " is too small");
+    }
+
+    glTexImage2D(GL_TEXTURE_2D, 0, win.format, win.contentWidth, win.contentHeight, 0,
+                 win.format, win.type, &pixels[0]);
+    ASSERT_GL();
+
+    // Keep a copy of the damaged area so that it can be uploaded every frame
+    if (win.damage[2] && win.damage[3])
+    {
+        int rowBytes = win.damage[2] * bpp;
+        win.damagePixels.resize(rowBytes * win.damage[3]);
+        for (int y = 0; y < win.damage[3]; y++)
+        {
+            const char* src = &pixels[((win.damage[1] + y) * win.contentWidth + win.damage[0]) * bpp];
+            memcpy(&win.damagePixels[y * rowBytes], src, rowBytes);
+        }
+    }
+}
+
+void CompositorTest::preparePixmap(CompositorWindow& win)
+{
+#if defined(SUPPORT_X11)
+    const EGLint configAttrs[] =
+    {
+        EGL_BUFFER_SIZE, win.pixmapDepth,
+        EGL_SURFACE_TYPE, EGL_PIXMAP_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_ES2_BIT,
+        EGL_NONE
+    };
+    EGLConfig config;
+    EGLint configCount = 0;
+    EGLBoolean success;
+
+    ASSERT(eglCreateImageKHR);
+
+    eglChooseConfig(ctx.dpy, configAttrs, &config, 1, &configCount);
+    if (!configCount)
+    {
+        fail("Config not found");
+    }
+
+    success = nativeCreatePixmap(ctx.nativeDisplay, ctx.dpy, config, win.contentWidth,
+                                 win.contentHeight, &win.pixmap);
+    ASSERT(success);
+
+    win.image = XGetImage(ctx.nativeDisplay, win.pixmap, 0, 0, win.contentWidth,
+                          win.contentHeight, ~0, ZPixmap);
+    ASSERT(win.image && win.image->data);
+
+    switch (win.image->depth)
+    {
+    case 16:
+        fillCompositorImage<uint16_t>(*win.image);
+        break;
+    case 32:
+        fillCompositorImage<uint32_t>(*win.image);
+        break;
+    default:
+        fail("Unknown pixmap depth");
+    }
+
+    XGCValues gcValues;
+    win.gc = XCreateGC(ctx.nativeDisplay, win.pixmap, 0, &gcValues);
+    XPutImage(ctx.nativeDisplay, win.pixmap, win.gc, win.image, 0, 0, 0, 0,
+              win.contentWidth, win.contentHeight);
+
+    const EGLint imageAttributes[] =
+    {
+        EGL_IMAGE_PRESERVED_KHR, EGL_TRUE,
+        EGL_NONE
+    };
+
+    EGLImageKHR image;
+    image = eglCreateImageKHR(ctx.dpy, EGL_NO_CONTEXT, EGL_NATIVE_PIXMAP_KHR,
+                              (EGLClientBuffer)win.pixmap, imageAttributes);
+    ASSERT(image);
+    ASSERT_EGL();
+
+    glEGLImageTargetTexture2DOES(GL_TEXTURE_2D, image);
+    eglDestroyImageKHR(ctx.dpy, image);
+    ASSERT_GL();
+    ASSERT_EGL();
+#else
+    fail("X11 pixmaps not supported");
+#endif // SUPPORT_X11
+}
+
+bool CompositorTest::usesPixmaps() const
+{
+    std::vector<char> data;
+
+    if (!loadFile(m_fileName, data))
+    {
+        return false;
+    }
+
+    std::istringstream scene(std::string(data.begin(), data.end()));
+    std::string line;
+
+    while (std::getline(scene, line))
+    {
+        std::istringstream s(line);
+        std::string directive;
+
+        if ((s >> directive) && directive == "pixmap")
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::string CompositorTest::unsupportedReason() const
+{
+    if (!usesPixmaps())
+    {
+        return "";
+    }
+#if defined(SUPPORT_X11)
+    if (!isEGLExtensionSupported("EGL_KHR_image_pixmap"))
+    {
+        return "EGL_KHR_image_pixmap not supported";
+    }
+    if (!isGLExtensionSupported("GL_OES_EGL_image"))
+    {
+        return "GL_OES_EGL_image not supported";
+    }
+    return "";
+#else
+    return "X11 pixmaps not supported";
+#endif // SUPPORT_X11
+}
+
+void CompositorTest::prepare()
+{
+    eglCreateImageKHR = 0;
+    eglDestroyImageKHR = 0;
+    glEGLImageTargetTexture2DOES = 0;
+
+    if (isEGLExtensionSupported("EGL_KHR_image_pixmap") &&
+        isGLExtensionSupported("GL_OES_EGL_image"))
+    {
+        eglCreateImageKHR =
+            (PFNEGLCREATEIMAGEKHRPROC)eglGetProcAddress("eglCreateImageKHR");
+        eglDestroyImageKHR =
+            (PFNEGLDESTROYIMAGEKHRPROC)eglGetProcAddress("eglDestroyImageKHR");
+        glEGLImageTargetTexture2DOES =
+            (PFNGLEGLIMAGETARGETTEXTURE2DOESPROC)eglGetProcAddress("glEGLImageTargetTexture2DOES");
+    }
+
+    eglQuerySurface(ctx.dpy, ctx.surface, EGL_WIDTH, &m_surfaceWidth);
+    eglQuerySurface(ctx.dpy, ctx.surface, EGL_HEIGHT, &m_surfaceHeight);
+    ASSERT_EGL();
+
+    loadScene();
+    if (!m_sceneWidth || !m_sceneHeight)
+    {
+        m_sceneWidth = m_surfaceWidth;
+        m_sceneHeight = m_surfaceHeight;
+    }
+
+    m_positionAttr = -1;
+    m_texcoordAttr = -1;
+    glGetIntegerv(GL_UNPACK_ALIGNMENT, &m_unpackAlignment);
+
+    // teardown() is not called for a test that fails to prepare
+    try
+    {
+        prepareScene();
+    }
+    catch (...)
+    {
+        teardown();
+        throw;
+    }
+}
+
+void CompositorTest::prepareScene()
+{
+    m_program = createProgram(compositorVertSource, compositorFragSource);
+    glUseProgram(m_program);
+
+    m_positionAttr = glGetAttribLocation(m_program, "in_position");
+    m_texcoordAttr = glGetAttribLocation(m_program, "in_texcoord");
+    m_opacityUnif = glGetUniformLocation(m_program, "opacity");
+    ASSERT(m_positionAttr >= 0);
+    ASSERT(m_texcoordAttr >= 0);
+    ASSERT(m_opacityUnif >= 0);
+
+    glEnableVertexAttribArray(m_positionAttr);
+    glEnableVertexAttribArray(m_texcoordAttr);
+    glUniform1i(glGetUniformLocation(m_program, "texture"), 0);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+
+    for (size_t i = 0; i < m_windows.size(); i++)
+    {
+        CompositorWindow& win = m_windows[i];
+
+        glGenTextures(1, &win.texture);
+        glBindTexture(GL_TEXTURE_2D, win.texture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+        if (win.pixmapDepth)
+        {
+            preparePixmap(win);
+        }
+        else
+        {
+            prepareTexture(win);
+        }
+    }
+    ASSERT_GL();
+}
+
+void CompositorTest::updateWindow(CompositorWindow& win)
+{
+    if (!win.damage[2] || !win.damage[3])
+    {
+        return;
+    }
+
+    if (win.pixmapDepth)
+    {
+#if defined(SUPPORT_X11)
+        XPutImage(ctx.nativeDisplay, win.pixmap, win.gc, win.image,
+                  win.damage[0], win.damage[1], win.damage[0], win.damage[1],
+                  win.damage[2], win.damage[3]);
+#endif
+    }
+    else
+    {
+        glBindTexture(GL_TEXTURE_2D, win.texture);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, win.damage[0], win.damage[1],
+                        win.damage[2], win.damage[3], win.format, win.type,
+                        &win.damagePixels[0]);
+    }
+}
+
+void CompositorTest::drawWindow(const CompositorWindow& win, int frame)
+{
+    float x = win.x, y = win.y;
+    float w = win.width, h = win.height;
+    float opacity = win.opacity;
+
+    if (win.movePeriod)
+    {
+        float t = triangle(frame, win.movePeriod);
+        x += win.moveX * t;
+        y += win.moveY * t;
+    }
+
+    if (win.fadePeriod)
+    {
+        float t = triangle(frame, win.fadePeriod);
+        opacity *= win.fadeFrom + (win.fadeTo - win.fadeFrom) * t;
+    }
+
+    if (win.scalePeriod)
+    {
+        float t = triangle(frame, win.scalePeriod);
+        float s = win.scaleFrom + (win.scaleTo - win.scaleFrom) * t;
+        x += w * (1.0f - s) / 2;
+        y += h * (1.0f - s) / 2;
+        w *= s;
+        h *= s;
+    }
+
+    float x0 = 2.0f * x / m_sceneWidth - 1.0f;
+    float x1 = 2.0f * (x + w) / m_sceneWidth - 1.0f;
+    float y0 = 1.0f - 2.0f * y / m_sceneHeight;
+    float y1 = 1.0f - 2.0f * (y + h) / m_sceneHeight;
+
+    const GLfloat vertices[] =
+    {
+        x0, y1,
+        x0, y0,
+        x1, y1,
+        x1, y0
+    };
+
+    const GLfloat texcoords[] =
+    {
+        0, 1,
+        0, 0,
+        1, 1,
+        1, 0
+    };
+
+    bool translucent = win.pixmapDepth ? (win.pixmapDepth == 32) : (win.format == GL_RGBA);
+    if (translucent || opacity < 1.0f)
+    {
+        glEnable(GL_BLEND);
+    }
+    else
+    {
+        glDisable(GL_BLEND);
+    }
+
+    glBindTexture(GL_TEXTURE_2D, win.texture);
+    glUniform1f(m_opacityUnif, opacity);
+    glVertexAttribPointer(m_positionAttr, 2, GL_FLOAT, GL_FALSE, 0, vertices);
+    glVertexAttribPointer(m_texcoordAttr, 2, GL_FLOAT, GL_FALSE, 0, texcoords);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+}
+
+void CompositorTest::operator()(int frame)
+{
+    // Warmup frames are all numbered zero, so the statistics end up
+    // covering only the measured frames
+    if (frame == 0)
+    {
+        m_stats.reset(m_refreshRate);
+    }
+    m_stats.frame();
+
+    for (size_t i = 0; i < m_windows.size(); i++)
+    {
+        updateWindow(m_windows[i]);
+    }
+
+    glClear(GL_COLOR_BUFFER_BIT);
+    for (size_t i = 0; i < m_windows.size(); i++)
+    {
+        drawWindow(m_windows[i], frame);
+    }
+}
+
+void CompositorTest::teardown()
+{
+    for (size_t i = 0; i < m_windows.size(); i++)
+    {
+        CompositorWindow& win = m_windows[i];
+
+        glDeleteTextures(1, &win.texture);
+#if defined(SUPPORT_X11)
+        if (win.gc)
+        {
+            XFreeGC(ctx.nativeDisplay, win.gc);
+        }
+        if (win.image)
+        {
+            XDestroyImage(win.image);
+        }
+        if (win.pixmap)
+        {
+            nativeDestroyPixmap(ctx.nativeDisplay, win.pixmap);
+        }
+#endif
+    }
+    m_windows.clear();
+
+    glUseProgram(0);
+    if (m_positionAttr >= 0)
+    {
+        glDisableVertexAttribArray(m_positionAttr);
+    }
+    if (m_texcoordAttr >= 0)
+    {
+        glDisableVertexAttribArray(m_texcoordAttr);
+    }
+    glDeleteProgram(m_program);
+    m_program = 0;
+
+    glDisable(GL_BLEND);
+    glBlendFunc(GL_ONE, GL_ZERO);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, m_unpackAlignment);
+}
+
+std::string CompositorTest::name() const
+{
+    std::string base = m_fileName.substr(m_fileName.rfind('/') + 1);
+    return "compositor_" + base.substr(0, base.rfind('.'));
+}
+
+std::string CompositorTest::statistics() const
+{
+    return m_stats.summary();
+}
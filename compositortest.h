@@ -0,0 +1,130 @@
+/**
+ * OpenGL ES 2.0 memory performance estimator
+ * Copyright (C) 2012 Google
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * \author Sami Kyöstilä <skyostil@google.com>
+ *
+ * Window compositor scenario test
+ */
+#ifndef COMPOSITORTEST_H
+#define COMPOSITORTEST_H
+
+#include "test.h"
+#include "framestats.h"
+#include <GLES2/gl2.h>
+#include <EGL/egl.h>
+#include <vector>
+#include "ext.h"
+
+#if defined(SUPPORT_X11)
+#include <X11/Xlib.h>
+#endif
+
+/**
+ *  A single window in a compositor scene. Positions and sizes are in scene
+ *  pixels with the origin at the top left corner; damage rectangles are in
+ *  texels of the window contents.
+ */
+struct CompositorWindow
+{
+    CompositorWindow();
+
+    int x, y, width, height;
+    GLenum format, type;
+    int contentWidth, contentHeight;
+    std::string fileName;
+    int pixmapDepth;                //< Non-zero for X pixmap contents
+    float opacity;
+    int damage[4];
+    float moveX, moveY;
+    int movePeriod;
+    float fadeFrom, fadeTo;
+    int fadePeriod;
+    float scaleFrom, scaleTo;
+    int scalePeriod;
+
+    GLuint texture;
+    std::vector<char> damagePixels;
+    NativePixmapType pixmap;
+#if defined(SUPPORT_X11)
+    XImage* image;
+    GC gc;
+#endif
+};
+
+/**
+ *  Composites a set of windows described by a scene file. The scene is a
+ *  text file with one directive per line; window attributes apply to the
+ *  most recently declared window:
+ *
+ *      size <width> <height>               Scene resolution (default: surface size)
+ *      refresh <hz>                        Display refresh rate (default: 60)
+ *      window <x> <y> <width> <height>     Declare a new window
+ *      texture <format> <width> <height> <file>
+ *                                          Window contents from a raw texture
+ *      pixmap <depth> <width> <height>     Window contents from an X pixmap
+ *      opacity <alpha>                     Constant window opacity
+ *      damage <x> <y> <width> <height>     Contents updated every frame
+ *      move <dx> <dy> <frames>             Slide back and forth
+ *      fade <from> <to> <frames>           Animate opacity
+ *      scale <from> <to> <frames>          Animate size around the center
+ *
+ *  Lines starting with '#' are comments.
+ */
+class CompositorTest: public Test
+{
+protected:
+    std::string m_fileName;
+    std::vector<CompositorWindow> m_windows;
+    int m_sceneWidth, m_sceneHeight;
+    int m_surfaceWidth, m_surfaceHeight;
+    int m_refreshRate;
+    FrameStatistics m_stats;
+
+    GLint m_program;
+    GLint m_positionAttr, m_texcoordAttr;
+    GLint m_opacityUnif;
+    GLint m_unpackAlignment;
+
+    PFNEGLCREATEIMAGEKHRPROC eglCreateImageKHR;
+    PFNEGLDESTROYIMAGEKHRPROC eglDestroyImageKHR;
+    PFNGLEGLIMAGETARGETTEXTURE2DOESPROC glEGLImageTargetTexture2DOES;
+
+public:
+    /**
+     *  @param fileName         Scene description file
+     */
+    CompositorTest(const std::string& fileName);
+
+    std::string unsupportedReason() const;
+    void prepare();
+    void operator()(int frame);
+    void teardown();
+    std::string name() const;
+    std::string statistics() const;
+
+protected:
+    bool usesPixmaps() const;
+    void loadScene();
+    void prepareScene();
+    void prepareTexture(CompositorWindow& win);
+    void preparePixmap(CompositorWindow& win);
+    void updateWindow(CompositorWindow& win);
+    void drawWindow(const CompositorWindow& win, int frame);
+};
+
+#endif // COMPOSITORTEST_H
@@ -0,0 +1,345 @@
+/**
+ * OpenGL ES 2.0 memory performance estimator
+ * Copyright (C) 2012 Google
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * \author Sami Kyöstilä <skyostil@google.com>
+ *
+ * EGL context and surface switching test
+ */
+#include "contextswitchtest.h"
+#include "native.h"
+#include "util.h"
+
+#include <algorithm>
+#include <sstream>
+#include <stdio.h>
+
+/** Size of each additional surface in pixels */
+static const int switchSurfaceSize = 64;
+
+ContextSwitchTest::ContextSwitchTest(ContextSwitchMode mode, SwitchSurfaceType surfaceType,
+                                     int count):
+    m_mode(mode),
+    m_surfaceType(surfaceType),
+    m_count(count),
+    m_config(0),
+    m_switchTime(0),
+    m_switches(0)
+{
+    ASSERT(m_count >= 1);
+}
+
+std::string ContextSwitchTest::unsupportedReason() const
+{
+#if defined(SUPPORT_ANDROID)
+    if (m_surfaceType == SWITCH_WINDOW)
+    {
+        return "Additional windows not supported";
+    }
+#endif
+#if !defined(SUPPORT_X11)
+    if (m_surfaceType == SWITCH_PIXMAP)
+    {
+        return "Pixmap surfaces not supported";
+    }
+#endif
+    return "";
+}
+
+EGLSurface ContextSwitchTest::createSurface()
+{
+    EGLSurface surface = EGL_NO_SURFACE;
+
+    switch (m_surfaceType)
+    {
+    case SWITCH_WINDOW:
+        {
+#if !defined(SUPPORT_ANDROID)
+            EGLNativeWindowType win;
+            if (!nativeCreateWindow(ctx.nativeDisplay, ctx.dpy, m_config, __FILE__,
+                                    switchSurfaceSize, switchSurfaceSize, &win))
+            {
+                fail("Unable to create a window");
+            }
+            m_windows.push_back(win);
+            surface = eglCreateWindowSurface(ctx.dpy, m_config, win, NULL);
+#endif
+        }
+        break;
+    case SWITCH_PBUFFER:
+        {
+            const EGLint surfaceAttrs[] =
+            {
+                EGL_WIDTH, switchSurfaceSize,
+                EGL_HEIGHT, switchSurfaceSize,
+                EGL_NONE
+            };
+            surface = eglCreatePbufferSurface(ctx.dpy, m_config, surfaceAttrs);
+        }
+        break;
+    case SWITCH_PIXMAP:
+        {
+#if defined(SUPPORT_X11)
+            EGLNativePixmapType pixmap;
+            if (!nativeCreatePixmap(ctx.nativeDisplay, ctx.dpy, m_config,
+                                    switchSurfaceSize, switchSurfaceSize, &pixmap))
+            {
+                fail("Unable to create a pixmap");
+            }
+            m_pixmaps.push_back(pixmap);
+            surface = eglCreatePixmapSurface(ctx.dpy, m_config, pixmap, NULL);
+#endif
+        }
+        break;
+    }
+
+    ASSERT_EGL();
+    ASSERT(surface != EGL_NO_SURFACE);
+    return surface;
+}
+
+void ContextSwitchTest::prepare()
+{
+    m_switchTime = 0;
+    m_switches = 0;
+
+    if (m_mode == SWITCH_NONE)
+    {
+        return;
+    }
+
+    const EGLint surfaceBits[] = {EGL_WINDOW_BIT, EGL_PBUFFER_BIT, EGL_PIXMAP_BIT};
+    EGLint bufferSize = 0;
+    eglGetConfigAttrib(ctx.dpy, ctx.config, EGL_BUFFER_SIZE, &bufferSize);
+
+    const EGLint configAttrs[] =
+    {
+        EGL_BUFFER_SIZE, bufferSize,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_ES2_BIT,
+        EGL_SURFACE_TYPE, surfaceBits[m_surfaceType],
+        EGL_NONE
+    };
+
+    const EGLint contextAttrs[] =
+    {
+        EGL_CONTEXT_CLIENT_VERSION, 2,
+        EGL_NONE
+    };
+
+    EGLint configCount = 0;
+    eglChooseConfig(ctx.dpy, configAttrs, &m_config, 1, &configCount);
+    if (!configCount)
+    {
+        fail("Config not found");
+    }
+
+    int contexts = (m_mode == SWITCH_SURFACES) ? 1 : m_count;
+    int surfaces = (m_mode == SWITCH_CONTEXTS) ? 1 : m_count;
+
+    try
+    {
+        for (int i = 0; i < contexts; i++)
+        {
+            EGLContext context = eglCreateContext(ctx.dpy, m_config, EGL_NO_CONTEXT, contextAttrs);
+            ASSERT_EGL();
+            ASSERT(context != EGL_NO_CONTEXT);
+            m_contexts.push_back(context);
+        }
+
+        for (int i = 0; i < surfaces; i++)
+        {
+            m_surfaces.push_back(createSurface());
+        }
+
+        // The swap interval belongs to the surface and the clear color to the
+        // context, so every surface and every context is made current once
+        for (int i = 0; i < std::max(contexts, surfaces); i++)
+        {
+            eglMakeCurrent(ctx.dpy, m_surfaces[i % surfaces], m_surfaces[i % surfaces],
+                           m_contexts[i % contexts]);
+            ASSERT_EGL();
+            eglSwapInterval(ctx.dpy, 0);
+            glClearColor((i % contexts) / static_cast<float>(contexts), 0.5f, 0.0f, 1.0f);
+            ASSERT_GL();
+        }
+
+        eglMakeCurrent(ctx.dpy, ctx.surface, ctx.surface, ctx.context);
+        ASSERT_EGL();
+    }
+    catch (...)
+    {
+        // teardown() is not called for a test that fails to prepare
+        destroySurfaces();
+        throw;
+    }
+}
+
+void ContextSwitchTest::makeCurrent(EGLSurface surface, EGLContext context)
+{
+    struct timespec start, end;
+
+    clock_gettime(CLOCK_REALTIME, &start);
+    eglMakeCurrent(ctx.dpy, surface, surface, context);
+    clock_gettime(CLOCK_REALTIME, &end);
+
+    m_switchTime += timeDiff(start, end);
+    m_switches++;
+}
+
+void ContextSwitchTest::operator()(int frame)
+{
+    // Warmup frames are all numbered zero
+    if (frame == 0)
+    {
+        m_switchTime = 0;
+        m_switches = 0;
+    }
+
+    if (m_mode == SWITCH_NONE)
+    {
+        // Do the same amount of drawing without leaving the main surface
+        glEnable(GL_SCISSOR_TEST);
+        glScissor(0, 0, switchSurfaceSize, switchSurfaceSize);
+        for (int i = 0; i < m_count; i++)
+        {
+            glClear(GL_COLOR_BUFFER_BIT);
+            glFlush();
+        }
+        glDisable(GL_SCISSOR_TEST);
+    }
+    else
+    {
+        for (int i = 0; i < m_count; i++)
+        {
+            EGLSurface surface = m_surfaces[(m_mode == SWITCH_CONTEXTS) ? 0 : i];
+            EGLContext context = m_contexts[(m_mode == SWITCH_SURFACES) ? 0 : i];
+
+            makeCurrent(surface, context);
+            glClear(GL_COLOR_BUFFER_BIT);
+            if (m_surfaceType == SWITCH_WINDOW)
+            {
+                eglSwapBuffers(ctx.dpy, surface);
+            }
+            else
+            {
+                glFlush();
+            }
+        }
+        makeCurrent(ctx.surface, ctx.context);
+    }
+
+    glClear(GL_COLOR_BUFFER_BIT);
+}
+
+void ContextSwitchTest::destroySurfaces()
+{
+    eglMakeCurrent(ctx.dpy, ctx.surface, ctx.surface, ctx.context);
+
+    for (size_t i = 0; i < m_surfaces.size(); i++)
+    {
+        eglDestroySurface(ctx.dpy, m_surfaces[i]);
+    }
+    for (size_t i = 0; i < m_contexts.size(); i++)
+    {
+        eglDestroyContext(ctx.dpy, m_contexts[i]);
+    }
+#if !defined(SUPPORT_ANDROID)
+    for (size_t i = 0; i < m_windows.size(); i++)
+    {
+        nativeDestroyWindow(ctx.nativeDisplay, m_windows[i]);
+    }
+#endif
+#if defined(SUPPORT_X11)
+    for (size_t i = 0; i < m_pixmaps.size(); i++)
+    {
+        nativeDestroyPixmap(ctx.nativeDisplay, m_pixmaps[i]);
+    }
+#endif
+    m_surfaces.clear();
+    m_contexts.clear();
+    m_windows.clear();
+    m_pixmaps.clear();
+}
+
+void ContextSwitchTest::teardown()
+{
+    destroySurfaces();
+    ASSERT_EGL();
+}
+
+std::string ContextSwitchTest::name() const
+{
+    std::stringstream s;
+
+    s << "ctxswitch_";
+    switch (m_mode)
+    {
+    case SWITCH_NONE:
+        s << "none_" << m_count;
+        return s.str();
+    case SWITCH_SURFACES:
+        s << "surfaces";
+        break;
+    case SWITCH_CONTEXTS:
+        s << "contexts";
+        break;
+    case SWITCH_BOTH:
+        s << "both";
+        break;
+    }
+
+    switch (m_surfaceType)
+    {
+    case SWITCH_WINDOW:
+        s << "_window";
+        break;
+    case SWITCH_PBUFFER:
+        s << "_pbuffer";
+        break;
+    case SWITCH_PIXMAP:
+        s << "_pixmap";
+        break;
+    }
+    s << "_" << m_count;
+
+    return s.str();
+}
+
+std::string ContextSwitchTest::baselineName() const
+{
+    if (m_mode == SWITCH_NONE)
+    {
+        return "";
+    }
+
+    std::stringstream s;
+    s << "ctxswitch_none_" << m_count;
+    return s.str();
+}
+
+std::string ContextSwitchTest::statistics() const
+{
+    char buf[64];
+
+    if (!m_switches)
+    {
+        return "";
+    }
+    snprintf(buf, sizeof(buf), "%7.1f us/switch",
+             m_switchTime / (1000.0f * m_switches));
+    return buf;
+}
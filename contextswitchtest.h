@@ -0,0 +1,81 @@
+/**
+ * OpenGL ES 2.0 memory performance estimator
+ * Copyright (C) 2012 Google
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * \author Sami Kyöstilä <skyostil@google.com>
+ *
+ * EGL context and surface switching test
+ */
+#ifndef CONTEXTSWITCHTEST_H
+#define CONTEXTSWITCHTEST_H
+
+#include "test.h"
+#include <EGL/egl.h>
+#include <vector>
+
+enum ContextSwitchMode
+{
+    SWITCH_NONE,                //< Draw everything on the main surface
+    SWITCH_SURFACES,            //< One context, several surfaces
+    SWITCH_CONTEXTS,            //< Several contexts, one surface
+    SWITCH_BOTH,                //< One context per surface
+};
+
+enum SwitchSurfaceType
+{
+    SWITCH_WINDOW,
+    SWITCH_PBUFFER,
+    SWITCH_PIXMAP,
+};
+
+class ContextSwitchTest: public Test
+{
+protected:
+    ContextSwitchMode m_mode;
+    SwitchSurfaceType m_surfaceType;
+    int m_count;
+    EGLConfig m_config;
+    std::vector<EGLContext> m_contexts;
+    std::vector<EGLSurface> m_surfaces;
+    std::vector<EGLNativeWindowType> m_windows;
+    std::vector<EGLNativePixmapType> m_pixmaps;
+    int64_t m_switchTime;
+    int m_switches;
+
+public:
+    /**
+     *  @param mode             What is switched between
+     *  @param surfaceType      Type of the additional surfaces
+     *  @param count            Number of additional surfaces drawn per frame
+     */
+    ContextSwitchTest(ContextSwitchMode mode, SwitchSurfaceType surfaceType, int count);
+
+    std::string unsupportedReason() const;
+    void prepare();
+    void operator()(int frame);
+    void teardown();
+    std::string name() const;
+    std::string baselineName() const;
+    std::string statistics() const;
+
+protected:
+    EGLSurface createSurface();
+    void destroySurfaces();
+    void makeCurrent(EGLSurface surface, EGLContext context);
+};
+
+#endif // CONTEXTSWITCHTEST_H
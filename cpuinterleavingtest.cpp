@@ -70,18 +70,44 @@ CPUInterleavingTest::CPUInterleavingTest(CPUInterleavingMethod method,
 }
 
 
-void CPUInterleavingTest::prepareEGLImageExtension()
+std::string CPUInterleavingTest::unsupportedReason() const
 {
+    switch (m_method)
+    {
+    case CPUI_TEXTURE_UPLOAD:
+        return BlitTest::unsupportedReason();
+    case CPUI_XSHM_IMAGE:
+#if !defined(SUPPORT_X11)
+        return "X11 shared memory not supported";
+#endif
+        break;
+    case CPUI_EGL_LOCK_SURFACE:
+#if defined(SUPPORT_ANDROID)
+        return "Native pixmaps not supported";
+#endif
+        if (!isEGLExtensionSupported("EGL_KHR_lock_surface2"))
+        {
+            return "EGL_KHR_lock_surface2 not supported";
+        }
+        break;
+    default:
+        return "Method not implemented";
+    }
+
     if (!isEGLExtensionSupported("EGL_KHR_image_base"))
     {
-        fail("EGL_KHR_image_base not supported");
+        return "EGL_KHR_image_base not supported";
     }
 
     if (!isEGLExtensionSupported("EGL_KHR_image_pixmap"))
     {
-        fail("EGL_KHR_image_pixmap not supported");
+        return "EGL_KHR_image_pixmap not supported";
     }
+    return BlitTest::unsupportedReason();
+}
 
+void CPUInterleavingTest::prepareEGLImageExtension()
+{
     m_eglCreateImageKHR =
         (PFNEGLCREATEIMAGEKHRPROC)eglGetProcAddress("eglCreateImageKHR");
     m_eglDestroyImageKHR =
@@ -205,11 +231,6 @@ void CPUInterleavingTest::prepare()
         {
             prepareEGLImageExtension();
 
-            if (!isEGLExtensionSupported("EGL_KHR_lock_surface2"))
-            {
-                fail("EGL_KHR_lock_surface2 not supported");
-            }
-
             // Get function pointers
             m_eglLockSurfaceKHR =
                 (PFNEGLLOCKSURFACEKHRPROC)eglGetProcAddress("eglLockSurfaceKHR");
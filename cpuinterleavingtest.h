@@ -87,6 +87,7 @@ public:
                         int width, int height,
                         float texW = 1.0f, float texH = 1.0f);
 
+    std::string unsupportedReason() const;
     void prepare();
     void operator()(int frame);
     void teardown();
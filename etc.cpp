@@ -0,0 +1,502 @@
+/**
+ * OpenGL ES 2.0 memory performance estimator
+ * Copyright (C) 2012 Google
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * \author Sami Kyöstilä <skyostil@google.com>
+ *
+ * ETC1, ETC2 and EAC texture compression
+ */
+#include "etc.h"
+
+#include <algorithm>
+#include <pthread.h>
+#include <stdint.h>
+#include <unistd.h>
+
+static const int modifierTables[8][4] =
+{
+    {  2,   8,   -2,   -8},
+    {  5,  17,   -5,  -17},
+    {  9,  29,   -9,  -29},
+    { 13,  42,  -13,  -42},
+    { 18,  60,  -18,  -60},
+    { 24,  80,  -24,  -80},
+    { 33, 106,  -33, -106},
+    { 47, 183,  -47, -183},
+};
+
+static const int eacModifierTables[16][8] =
+{
+    {-3, -6,  -9, -15, 2, 5, 8, 14},
+    {-3, -7, -10, -13, 2, 6, 9, 12},
+    {-2, -5,  -8, -13, 1, 4, 7, 12},
+    {-2, -4,  -6, -13, 1, 3, 5, 12},
+    {-3, -6,  -8, -12, 2, 5, 7, 11},
+    {-3, -7,  -9, -11, 2, 6, 8, 10},
+    {-4, -7,  -8, -11, 3, 6, 7, 10},
+    {-3, -5,  -8, -11, 2, 4, 7, 10},
+    {-2, -6,  -8, -10, 1, 5, 7,  9},
+    {-2, -5,  -8, -10, 1, 4, 7,  9},
+    {-2, -4,  -8, -10, 1, 3, 7,  9},
+    {-2, -5,  -7, -10, 1, 4, 6,  9},
+    {-3, -4,  -7, -10, 2, 3, 6,  9},
+    {-1, -2,  -3, -10, 0, 1, 2,  9},
+    {-4, -6,  -8,  -9, 3, 5, 7,  8},
+    {-3, -5,  -7,  -9, 2, 4, 6,  8},
+};
+
+/**
+ *  Best encoding found for one half of a block
+ */
+struct SubBlock
+{
+    int table;
+    int indices[8];
+    int error;
+};
+
+/**
+ *  Best encoding found for a whole block
+ */
+struct Block
+{
+    bool diff;
+    bool flip;
+    int base[2][3];             //< Quantized base colors
+    SubBlock sub[2];
+    int error;
+};
+
+static inline int clampByte(int v)
+{
+    return v < 0 ? 0 : (v > 255 ? 255 : v);
+}
+
+static inline int expand4(int c)
+{
+    return (c << 4) | c;
+}
+
+static inline int expand5(int c)
+{
+    return (c << 3) | (c >> 2);
+}
+
+/**
+ *  Choose the modifier table and per pixel modifiers for eight pixels
+ *
+ *  @param pixels               Eight RGB888 pixels, three bytes each
+ *  @param color                Expanded base color
+ *  @param maxError             Give up once the error exceeds this
+ */
+static SubBlock encodeSubBlock(const int* pixels, const int* color, int maxError)
+{
+    SubBlock best;
+    best.error = maxError;
+    best.table = 0;
+    std::fill(best.indices, best.indices + 8, 0);
+
+    for (int t = 0; t < 8; t++)
+    {
+        SubBlock candidate;
+        candidate.table = t;
+        candidate.error = 0;
+
+        for (int i = 0; i < 8 && candidate.error < best.error; i++)
+        {
+            const int* p = &pixels[i * 3];
+            int bestPixelError = 0x7fffffff;
+
+            for (int m = 0; m < 4; m++)
+            {
+                int mod = modifierTables[t][m];
+                int dr = clampByte(color[0] + mod) - p[0];
+                int dg = clampByte(color[1] + mod) - p[1];
+                int db = clampByte(color[2] + mod) - p[2];
+                int e = dr * dr + dg * dg + db * db;
+                if (e < bestPixelError)
+                {
+                    bestPixelError = e;
+                    candidate.indices[i] = m;
+                }
+            }
+            candidate.error += bestPixelError;
+        }
+
+        if (candidate.error < best.error)
+        {
+            best = candidate;
+        }
+    }
+    return best;
+}
+
+static inline int quantize(int value, int levels)
+{
+    return (value * levels + 127) / 255;
+}
+
+/**
+ *  Encode both halves of a block with the given base colors, keeping the
+ *  result if it beats the current best
+ */
+static void tryBaseColors(const int halves[2][24], bool diff, bool flip,
+                          const int base[2][3], Block& best)
+{
+    int colors[2][3];
+
+    for (int c = 0; c < 3; c++)
+    {
+        colors[0][c] = diff ? expand5(base[0][c]) : expand4(base[0][c]);
+        colors[1][c] = diff ? expand5(base[1][c]) : expand4(base[1][c]);
+    }
+
+    SubBlock first = encodeSubBlock(halves[0], colors[0], best.error);
+    if (first.error >= best.error)
+    {
+        return;
+    }
+    SubBlock second = encodeSubBlock(halves[1], colors[1], best.error - first.error);
+    if (first.error + second.error >= best.error)
+    {
+        return;
+    }
+
+    best.diff = diff;
+    best.flip = flip;
+    std::copy(&base[0][0], &base[0][0] + 6, &best.base[0][0]);
+    best.sub[0] = first;
+    best.sub[1] = second;
+    best.error = first.error + second.error;
+}
+
+static void encodeColorBlock(const int pixels[16][4], ETC1Quality quality, unsigned char* out)
+{
+    Block best;
+    best.error = 0x7fffffff;
+
+    for (int flip = 0; flip < 2; flip++)
+    {
+        // Sub-blocks are 2x4 side by side, or 4x2 on top of each other when
+        // flipped. Pixels are numbered in column-major order.
+        int halves[2][24];
+        int sums[2][3] = {{0, 0, 0}, {0, 0, 0}};
+        int counts[2] = {0, 0};
+
+        for (int x = 0; x < 4; x++)
+        {
+            for (int y = 0; y < 4; y++)
+            {
+                int h = flip ? (y >= 2) : (x >= 2);
+                for (int c = 0; c < 3; c++)
+                {
+                    halves[h][counts[h] * 3 + c] = pixels[x * 4 + y][c];
+                    sums[h][c] += pixels[x * 4 + y][c];
+                }
+                counts[h]++;
+            }
+        }
+
+        int base[2][3];
+        const int range = (quality == ETC1_NORMAL) ? 1 : 0;
+
+        // Individual mode: two independent 4-bit colors
+        for (int d = -range; d <= range; d++)
+        {
+            for (int h = 0; h < 2; h++)
+            {
+                for (int c = 0; c < 3; c++)
+                {
+                    base[h][c] = std::max(0, std::min(15, quantize(sums[h][c] / 8, 15) + d));
+                }
+            }
+            tryBaseColors(halves, false, flip, base, best);
+        }
+
+        // Differential mode: 5-bit color and a 3-bit signed offset
+        for (int d = -range; d <= range; d++)
+        {
+            bool valid = true;
+            for (int c = 0; c < 3; c++)
+            {
+                base[0][c] = std::max(0, std::min(31, quantize(sums[0][c] / 8, 31) + d));
+                base[1][c] = std::max(0, std::min(31, quantize(sums[1][c] / 8, 31) + d));
+                int delta = base[1][c] - base[0][c];
+                valid = valid && delta >= -4 && delta <= 3;
+            }
+            if (valid)
+            {
+                tryBaseColors(halves, true, flip, base, best);
+            }
+        }
+    }
+
+    uint32_t high = 0, low = 0;
+
+    if (best.diff)
+    {
+        for (int c = 0; c < 3; c++)
+        {
+            int delta = (best.base[1][c] - best.base[0][c]) & 7;
+            high |= ((best.base[0][c] << 3) | delta) << (24 - c * 8);
+        }
+    }
+    else
+    {
+        for (int c = 0; c < 3; c++)
+        {
+            high |= ((best.base[0][c] << 4) | best.base[1][c]) << (24 - c * 8);
+        }
+    }
+    high |= best.sub[0].table << 5;
+    high |= best.sub[1].table << 2;
+    high |= (best.diff ? 1 : 0) << 1;
+    high |= best.flip ? 1 : 0;
+
+    // Modifier index to the two-bit pixel index: +a, +b, -a, -b
+    int next[2] = {0, 0};
+    for (int x = 0; x < 4; x++)
+    {
+        for (int y = 0; y < 4; y++)
+        {
+            int h = best.flip ? (y >= 2) : (x >= 2);
+            int index = best.sub[h].indices[next[h]++];
+            int bit = x * 4 + y;
+            low |= ((index >> 1) & 1) << (bit + 16);
+            low |= (index & 1) << bit;
+        }
+    }
+
+    out[0] = high >> 24;
+    out[1] = high >> 16;
+    out[2] = high >> 8;
+    out[3] = high;
+    out[4] = low >> 24;
+    out[5] = low >> 16;
+    out[6] = low >> 8;
+    out[7] = low;
+}
+
+/**
+ *  Encode one channel of a block with EAC. The same block layout serves
+ *  both the alpha half of ETC2 RGBA8 and R11; the 11-bit format simply
+ *  decodes it at a higher precision.
+ *
+ *  @param pixels               Source pixels in column-major order
+ *  @param channel              Channel to encode
+ */
+static void encodeEACBlock(const int pixels[16][4], int channel, ETC1Quality quality, unsigned char* out)
+{
+    int low = 255, high = 0;
+
+    for (int i = 0; i < 16; i++)
+    {
+        low = std::min(low, pixels[i][channel]);
+        high = std::max(high, pixels[i][channel]);
+    }
+
+    int base = (low + high + 1) / 2;
+    int bestError = 0x7fffffff;
+    int bestTable = 0, bestMultiplier = 1;
+    int bestIndices[16] = {0};
+    const int range = (quality == ETC1_NORMAL) ? 1 : 0;
+
+    for (int t = 0; t < 16 && bestError; t++)
+    {
+        // Pick the multiplier that makes the table span the value range
+        int span = eacModifierTables[t][7] - eacModifierTables[t][3];
+        int estimate = (high - low + span / 2) / span;
+
+        for (int m = estimate - range; m <= estimate + range; m++)
+        {
+            int multiplier = std::max(1, std::min(15, m));
+            int error = 0;
+            int indices[16];
+
+            for (int i = 0; i < 16 && error < bestError; i++)
+            {
+                int bestPixelError = 0x7fffffff;
+                for (int j = 0; j < 8; j++)
+                {
+                    int d = clampByte(base + eacModifierTables[t][j] * multiplier) - pixels[i][channel];
+                    if (d * d < bestPixelError)
+                    {
+                        bestPixelError = d * d;
+                        indices[i] = j;
+                    }
+                }
+                error += bestPixelError;
+            }
+
+            if (error < bestError)
+            {
+                bestError = error;
+                bestTable = t;
+                bestMultiplier = multiplier;
+                std::copy(indices, indices + 16, bestIndices);
+            }
+        }
+    }
+
+    uint64_t bits = (static_cast<uint64_t>(base) << 56) |
+                    (static_cast<uint64_t>(bestMultiplier) << 52) |
+                    (static_cast<uint64_t>(bestTable) << 48);
+    for (int i = 0; i < 16; i++)
+    {
+        bits |= static_cast<uint64_t>(bestIndices[i]) << (45 - i * 3);
+    }
+    for (int i = 0; i < 8; i++)
+    {
+        out[i] = static_cast<unsigned char>(bits >> (56 - i * 8));
+    }
+}
+
+enum EncodeFormat
+{
+    ENCODE_ETC1,
+    ENCODE_ETC2_RGBA8_EAC,
+    ENCODE_EAC_R11,
+};
+
+/**
+ *  A band of block rows encoded by one thread
+ */
+struct EncodeJob
+{
+    const unsigned char* rgba;
+    int width, height;
+    int firstRow, lastRow;
+    EncodeFormat format;
+    ETC1Quality quality;
+    unsigned char* out;
+};
+
+static int blockSize(EncodeFormat format)
+{
+    return (format == ENCODE_ETC2_RGBA8_EAC) ? 16 : 8;
+}
+
+static void* encodeRows(void* arg)
+{
+    const EncodeJob* job = static_cast<const EncodeJob*>(arg);
+    int blocksX = (job->width + 3) / 4;
+    int size = blockSize(job->format);
+
+    for (int by = job->firstRow; by < job->lastRow; by++)
+    {
+        for (int bx = 0; bx < blocksX; bx++)
+        {
+            int pixels[16][4];
+
+            for (int x = 0; x < 4; x++)
+            {
+                for (int y = 0; y < 4; y++)
+                {
+                    int sx = std::min(bx * 4 + x, job->width - 1);
+                    int sy = std::min(by * 4 + y, job->height - 1);
+                    const unsigned char* p = job->rgba + (sy * job->width + sx) * 4;
+                    pixels[x * 4 + y][0] = p[0];
+                    pixels[x * 4 + y][1] = p[1];
+                    pixels[x * 4 + y][2] = p[2];
+                    pixels[x * 4 + y][3] = p[3];
+                }
+            }
+
+            unsigned char* out = job->out + (by * blocksX + bx) * size;
+            switch (job->format)
+            {
+            case ENCODE_ETC1:
+                encodeColorBlock(pixels, job->quality, out);
+                break;
+            case ENCODE_ETC2_RGBA8_EAC:
+                encodeEACBlock(pixels, 3, job->quality, out);
+                encodeColorBlock(pixels, job->quality, out + 8);
+                break;
+            case ENCODE_EAC_R11:
+                encodeEACBlock(pixels, 0, job->quality, out);
+                break;
+            }
+        }
+    }
+    return 0;
+}
+
+int etc1DataSize(int width, int height)
+{
+    return ((width + 3) / 4) * ((height + 3) / 4) * 8;
+}
+
+static void encode(const unsigned char* rgba, int width, int height,
+                   std::vector<unsigned char>& out, EncodeFormat format, ETC1Quality quality)
+{
+    int blocksY = (height + 3) / 4;
+    int threadCount = std::max(1, std::min(static_cast<int>(sysconf(_SC_NPROCESSORS_ONLN)), blocksY));
+    std::vector<EncodeJob> jobs(threadCount);
+    std::vector<pthread_t> threads(threadCount);
+
+    out.resize(etc1DataSize(width, height) * blockSize(format) / 8);
+
+    for (int i = 0; i < threadCount; i++)
+    {
+        jobs[i].rgba = rgba;
+        jobs[i].width = width;
+        jobs[i].height = height;
+        jobs[i].firstRow = blocksY * i / threadCount;
+        jobs[i].lastRow = blocksY * (i + 1) / threadCount;
+        jobs[i].format = format;
+        jobs[i].quality = quality;
+        jobs[i].out = &out[0];
+    }
+
+    // The calling thread takes the first band; bands that could not get a
+    // thread of their own are encoded here as well
+    std::vector<bool> started(threadCount, false);
+    for (int i = 1; i < threadCount; i++)
+    {
+        started[i] = !pthread_create(&threads[i], NULL, encodeRows, &jobs[i]);
+    }
+    encodeRows(&jobs[0]);
+    for (int i = 1; i < threadCount; i++)
+    {
+        if (started[i])
+        {
+            pthread_join(threads[i], NULL);
+        }
+        else
+        {
+            encodeRows(&jobs[i]);
+        }
+    }
+}
+
+void encodeETC1(const unsigned char* rgba, int width, int height,
+                std::vector<unsigned char>& out, ETC1Quality quality)
+{
+    encode(rgba, width, height, out, ENCODE_ETC1, quality);
+}
+
+void encodeETC2RGBA8(const unsigned char* rgba, int width, int height,
+                     std::vector<unsigned char>& out, ETC1Quality quality)
+{
+    encode(rgba, width, height, out, ENCODE_ETC2_RGBA8_EAC, quality);
+}
+
+void encodeEACR11(const unsigned char* rgba, int width, int height,
+                  std::vector<unsigned char>& out, ETC1Quality quality)
+{
+    encode(rgba, width, height, out, ENCODE_EAC_R11, quality);
+}
@@ -0,0 +1,68 @@
+/**
+ * OpenGL ES 2.0 memory performance estimator
+ * Copyright (C) 2012 Google
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * \author Sami Kyöstilä <skyostil@google.com>
+ *
+ * ETC1, ETC2 and EAC texture compression
+ */
+#ifndef ETC_H
+#define ETC_H
+
+#include <vector>
+
+enum ETC1Quality
+{
+    ETC1_FAST,                  //< Base colors from sub-block averages only
+    ETC1_NORMAL,                //< Also search around the averages
+};
+
+/**
+ *  @returns the size in bytes of an ETC1 image
+ */
+int etc1DataSize(int width, int height);
+
+/**
+ *  Compress an image to ETC1. The image is split into horizontal bands of
+ *  blocks that are encoded in parallel on all available processors. Edge
+ *  blocks of images whose size is not a multiple of four are padded by
+ *  repeating the last row and column.
+ *
+ *  @param rgba                 Source pixels in RGBA8888; alpha is ignored
+ *  @param width                Image width in pixels
+ *  @param height               Image height in pixels
+ *  @param out                  Output: etc1DataSize() bytes of ETC1 blocks
+ *  @param quality              Speed versus quality trade-off
+ */
+void encodeETC1(const unsigned char* rgba, int width, int height,
+                std::vector<unsigned char>& out, ETC1Quality quality = ETC1_FAST);
+
+/**
+ *  Compress an image to ETC2 RGBA8 with EAC alpha. Works like encodeETC1(),
+ *  but produces 16-byte blocks. ETC1 data is also valid ETC2 RGB8 data, so
+ *  encodeETC1() covers that format.
+ */
+void encodeETC2RGBA8(const unsigned char* rgba, int width, int height,
+                     std::vector<unsigned char>& out, ETC1Quality quality = ETC1_FAST);
+
+/**
+ *  Compress the red channel of an image to EAC R11. Works like encodeETC1().
+ */
+void encodeEACR11(const unsigned char* rgba, int width, int height,
+                  std::vector<unsigned char>& out, ETC1Quality quality = ETC1_FAST);
+
+#endif // ETC_H
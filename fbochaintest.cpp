@@ -0,0 +1,171 @@
+/**
+ * OpenGL ES 2.0 memory performance estimator
+ * Copyright (C) 2012 Google
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * \author Sami Kyöstilä <skyostil@google.com>
+ *
+ * Multi-stage render-to-texture chain test
+ */
+#include "fbochaintest.h"
+#include "util.h"
+
+#include <sstream>
+#include <stdio.h>
+
+FBOChainTest::FBOChainTest(int stages, bool discard, bool clear, int width, int height):
+    BlitTest(GL_RGBA, GL_UNSIGNED_BYTE, 800, 480, "data/water2_800x480_rgba8888.raw"),
+    m_stages(stages),
+    m_discard(discard),
+    m_clear(clear),
+    m_fboWidth(width),
+    m_fboHeight(height),
+    m_glDiscardFramebuffer(0)
+{
+    ASSERT(m_stages >= 1 && m_stages <= FBO_CHAIN_MAX_STAGES);
+}
+
+std::string FBOChainTest::unsupportedReason() const
+{
+    if (m_discard && !isGLExtensionSupported("GL_EXT_discard_framebuffer") &&
+        glesVersion() < 3)
+    {
+        return "GL_EXT_discard_framebuffer not supported";
+    }
+    return BlitTest::unsupportedReason();
+}
+
+void FBOChainTest::prepare()
+{
+    if (m_discard)
+    {
+        if (isGLExtensionSupported("GL_EXT_discard_framebuffer"))
+        {
+            m_glDiscardFramebuffer = (PFNGLDISCARDFRAMEBUFFEREXTPROC)
+                eglGetProcAddress("glDiscardFramebufferEXT");
+        }
+        else
+        {
+            // glInvalidateFramebuffer is a drop-in replacement
+            m_glDiscardFramebuffer = (PFNGLINVALIDATEFRAMEBUFFERPROC)
+                eglGetProcAddress("glInvalidateFramebuffer");
+        }
+        ASSERT(m_glDiscardFramebuffer);
+    }
+
+    BlitTest::prepare();
+
+    glGenTextures(m_stages, m_fboTextures);
+    glGenRenderbuffers(m_stages, m_depthbuffers);
+    glGenFramebuffers(m_stages, m_framebuffers);
+
+    for (int i = 0; i < m_stages; i++)
+    {
+        glBindTexture(GL_TEXTURE_2D, m_fboTextures[i]);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, m_fboWidth, m_fboHeight, 0,
+                     GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+        ASSERT_GL();
+
+        glBindRenderbuffer(GL_RENDERBUFFER, m_depthbuffers[i]);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT16, m_fboWidth, m_fboHeight);
+        ASSERT_GL();
+
+        glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffers[i]);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                               GL_TEXTURE_2D, m_fboTextures[i], 0);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,
+                                  GL_RENDERBUFFER, m_depthbuffers[i]);
+        ASSERT_GL();
+
+        GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+        ASSERT(status == GL_FRAMEBUFFER_COMPLETE);
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+    glBindTexture(GL_TEXTURE_2D, m_texture);
+    ASSERT_GL();
+}
+
+void FBOChainTest::beginStage(bool defaultFramebuffer)
+{
+    if (m_discard)
+    {
+        // Every pixel is about to be overwritten, so there is no need to
+        // load the previous contents
+        const GLenum fboAttachments[] = {GL_COLOR_ATTACHMENT0, GL_DEPTH_ATTACHMENT};
+        const GLenum windowAttachments[] = {GL_COLOR_EXT, GL_DEPTH_EXT};
+        m_glDiscardFramebuffer(GL_FRAMEBUFFER, 2,
+                               defaultFramebuffer ? windowAttachments : fboAttachments);
+    }
+
+    if (m_clear)
+    {
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    }
+}
+
+void FBOChainTest::endStage()
+{
+    if (m_discard)
+    {
+        // The depth buffer is never sampled, so it need not be stored
+        const GLenum attachments[] = {GL_DEPTH_ATTACHMENT};
+        m_glDiscardFramebuffer(GL_FRAMEBUFFER, 1, attachments);
+    }
+}
+
+void FBOChainTest::operator()(int frame)
+{
+    for (int i = 0; i < m_stages; i++)
+    {
+        glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffers[i]);
+        beginStage(false);
+        glBindTexture(GL_TEXTURE_2D, i ? m_fboTextures[i - 1] : m_texture);
+        render(frame);
+        endStage();
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    beginStage(true);
+    glBindTexture(GL_TEXTURE_2D, m_fboTextures[m_stages - 1]);
+    render(frame);
+}
+
+void FBOChainTest::teardown()
+{
+    glBindTexture(GL_TEXTURE_2D, m_texture);
+    glDeleteFramebuffers(m_stages, m_framebuffers);
+    glDeleteRenderbuffers(m_stages, m_depthbuffers);
+    glDeleteTextures(m_stages, m_fboTextures);
+    BlitTest::teardown();
+}
+
+std::string FBOChainTest::name() const
+{
+    std::stringstream s;
+
+    s << "fbo_chain_" << m_stages << "stage";
+    s << (m_discard ? "_discard" : "_nodiscard");
+    s << (m_clear ? "_clear" : "_noclear");
+    s << "_" << m_fboWidth << "x" << m_fboHeight;
+
+    return s.str();
+}
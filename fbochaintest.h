@@ -0,0 +1,67 @@
+/**
+ * OpenGL ES 2.0 memory performance estimator
+ * Copyright (C) 2012 Google
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * \author Sami Kyöstilä <skyostil@google.com>
+ *
+ * Multi-stage render-to-texture chain test
+ */
+#ifndef FBOCHAINTEST_H
+#define FBOCHAINTEST_H
+
+#include "blittest.h"
+#include "ext.h"
+#include <GLES2/gl2.h>
+
+const int FBO_CHAIN_MAX_STAGES = 8;
+
+class FBOChainTest: public BlitTest
+{
+protected:
+    int m_stages;
+    bool m_discard;
+    bool m_clear;
+    int m_fboWidth, m_fboHeight;
+    GLuint m_framebuffers[FBO_CHAIN_MAX_STAGES];
+    GLuint m_fboTextures[FBO_CHAIN_MAX_STAGES];
+    GLuint m_depthbuffers[FBO_CHAIN_MAX_STAGES];
+
+    PFNGLDISCARDFRAMEBUFFEREXTPROC m_glDiscardFramebuffer;
+
+public:
+    /**
+     *  @param stages           Number of off-screen passes (1-8)
+     *  @param discard          Discard framebuffer contents which are not
+     *                          needed before and after each pass
+     *  @param clear            Clear each framebuffer at the start of a pass
+     *  @param width            Framebuffer width in pixels
+     *  @param height           Framebuffer height in pixels
+     */
+    FBOChainTest(int stages, bool discard, bool clear, int width, int height);
+
+    std::string unsupportedReason() const;
+    void prepare();
+    void operator()(int frame);
+    void teardown();
+    std::string name() const;
+
+protected:
+    void beginStage(bool defaultFramebuffer);
+    void endStage();
+};
+
+#endif // FBOCHAINTEST_H
@@ -0,0 +1,146 @@
+/**
+ * OpenGL ES 2.0 memory performance estimator
+ * Copyright (C) 2012 Google
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * \author Sami Kyöstilä <skyostil@google.com>
+ *
+ * Per-frame timing statistics
+ */
+#include "framestats.h"
+#include "util.h"
+
+#include <algorithm>
+#include <math.h>
+#include <stdio.h>
+
+FrameStatistics::FrameStatistics():
+    m_refreshRate(0),
+    m_started(false)
+{
+}
+
+void FrameStatistics::reset(int refreshRate)
+{
+    m_refreshRate = refreshRate;
+    m_started = false;
+    m_intervals.clear();
+}
+
+void FrameStatistics::frame()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+
+    if (m_started)
+    {
+        m_intervals.push_back(timeDiff(m_last, now));
+    }
+    m_last = now;
+    m_started = true;
+}
+
+int FrameStatistics::frames() const
+{
+    return m_intervals.size();
+}
+
+int64_t FrameStatistics::worst() const
+{
+    if (m_intervals.empty())
+    {
+        return 0;
+    }
+    return *std::max_element(m_intervals.begin(), m_intervals.end());
+}
+
+int64_t FrameStatistics::jitter() const
+{
+    if (m_intervals.empty())
+    {
+        return 0;
+    }
+
+    double mean = 0, variance = 0;
+    for (size_t i = 0; i < m_intervals.size(); i++)
+    {
+        mean += m_intervals[i];
+    }
+    mean /= m_intervals.size();
+
+    for (size_t i = 0; i < m_intervals.size(); i++)
+    {
+        variance += (m_intervals[i] - mean) * (m_intervals[i] - mean);
+    }
+    variance /= m_intervals.size();
+
+    return static_cast<int64_t>(sqrt(variance));
+}
+
+int64_t FrameStatistics::percentile(int p) const
+{
+    if (m_intervals.empty())
+    {
+        return 0;
+    }
+
+    std::vector<int64_t> sorted(m_intervals);
+    std::sort(sorted.begin(), sorted.end());
+    size_t i = (sorted.size() - 1) * p / 100;
+    return sorted[i];
+}
+
+int FrameStatistics::missedDeadlines() const
+{
+    if (!m_refreshRate)
+    {
+        return 0;
+    }
+
+    // A frame that takes n refresh periods misses n - 1 of them. Timer
+    // jitter is allowed to stretch an interval by a tenth of a period before
+    // it counts as a miss.
+    const int64_t period = 1000 * 1000 * 1000LL / m_refreshRate;
+    const int64_t slack = period / 10;
+    int missed = 0;
+
+    for (size_t i = 0; i < m_intervals.size(); i++)
+    {
+        if (m_intervals[i] > period + slack)
+        {
+            missed += static_cast<int>((m_intervals[i] - slack - 1) / period);
+        }
+    }
+    return missed;
+}
+
+std::string FrameStatistics::summary() const
+{
+    char buf[128];
+
+    snprintf(buf, sizeof(buf), "p95 %6.2f ms max %6.2f ms jitter %5.2f ms",
+             percentile(95) / (1000.0f * 1000.0f), worst() / (1000.0f * 1000.0f),
+             jitter() / (1000.0f * 1000.0f));
+
+    std::string s(buf);
+    if (m_refreshRate)
+    {
+        snprintf(buf, sizeof(buf), " %d/%d missed @ %d Hz",
+                 missedDeadlines(), frames(), m_refreshRate);
+        s += buf;
+    }
+    return s;
+}
@@ -0,0 +1,88 @@
+/**
+ * OpenGL ES 2.0 memory performance estimator
+ * Copyright (C) 2012 Google
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * \author Sami Kyöstilä <skyostil@google.com>
+ *
+ * Per-frame timing statistics
+ */
+#ifndef FRAMESTATS_H
+#define FRAMESTATS_H
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include <time.h>
+
+class FrameStatistics
+{
+public:
+    FrameStatistics();
+
+    /**
+     *  Discard all collected samples
+     *
+     *  @param refreshRate      Display refresh rate in Hz used for counting
+     *                          missed deadlines, or zero for none
+     */
+    void reset(int refreshRate);
+
+    /**
+     *  Mark the start of a new frame
+     */
+    void frame();
+
+    /**
+     *  @returns the number of measured frame intervals
+     */
+    int frames() const;
+
+    /**
+     *  @returns the longest frame interval in nanoseconds
+     */
+    int64_t worst() const;
+
+    /**
+     *  @returns the standard deviation of the frame intervals in nanoseconds
+     */
+    int64_t jitter() const;
+
+    /**
+     *  @returns the given percentile (0-100) of the frame intervals in
+     *  nanoseconds
+     */
+    int64_t percentile(int p) const;
+
+    /**
+     *  @returns the number of display refreshes that passed without a new
+     *  frame
+     */
+    int missedDeadlines() const;
+
+    /**
+     *  @returns a one-line description of the collected statistics
+     */
+    std::string summary() const;
+
+protected:
+    int m_refreshRate;
+    bool m_started;
+    struct timespec m_last;
+    std::vector<int64_t> m_intervals;
+};
+
+#endif // FRAMESTATS_H
@@ -1,12 +1,13 @@
 #!/bin/sh
 # Script for generating GLMemPerf reference frames
+#
+# Usage: glmemperf-create-ref.sh [DIR] [GLMEMPERF OPTIONS]
+#
+# The frames are read back by glmemperf itself and stored in DIR (default:
+# current directory) along with an index of their checksums. Check a later
+# run against them with "glmemperf -r DIR".
 
-TESTS=`glmemperf -l|tail -n +4|grep -v ^Warning:`
+DIR=${1:-.}
+[ $# -gt 0 ] && shift
 
-for TEST in $TESTS; do
-    echo "Generating reference frame $TEST.raw"
-    glmemperf -t 4 -i $TEST &
-    sleep 2
-    cp /dev/fb0 $TEST.raw
-    wait
-done
+exec glmemperf -c "$DIR" "$@"
@@ -1,22 +1,56 @@
 LOCAL_PATH := $(call my-dir)
 
+# The CPU bandwidth kernels are built separately so that they get NEON
+include $(CLEAR_VARS)
+LOCAL_MODULE    := glmemperf_bandwidth
+LOCAL_CXXFLAGS := -DSUPPORT_ANDROID -O3
+ifeq ($(TARGET_ARCH_ABI),armeabi-v7a)
+LOCAL_ARM_NEON := true
+endif
+
+LOCAL_CPP_FEATURES += exceptions
+
+LOCAL_SRC_FILES := ../bandwidth.cpp
+
+include $(BUILD_STATIC_LIBRARY)
+
 include $(CLEAR_VARS)
 LOCAL_MODULE    := glmemperf
 LOCAL_CXXFLAGS := -DSUPPORT_ANDROID -DPACKAGE_VERSION="\"1.0\"" -DPREFIX="\".\""
 LOCAL_LDLIBS := -landroid -llog -lGLESv2 -lEGL
-LOCAL_STATIC_LIBRARIES := android_native_app_glue
+LOCAL_STATIC_LIBRARIES := glmemperf_bandwidth android_native_app_glue
 
 LOCAL_CPP_FEATURES += exceptions
 
 LOCAL_SRC_FILES := \
+        ../astc.cpp \
+        ../blendtest.cpp \
         ../blittest.cpp \
+        ../blurtest.cpp \
         ../cleartest.cpp \
+        ../cliptest.cpp \
+        ../compositortest.cpp \
+        ../contextswitchtest.cpp \
         ../cpuinterleavingtest.cpp \
+        ../etc.cpp \
         ../fboblittest.cpp \
+        ../fbochaintest.cpp \
+        ../framestats.cpp \
+        ../memory.cpp \
+        ../multisampletest.cpp \
+        ../pacingtest.cpp \
+        ../partialupdatetest.cpp \
+        ../readbacktest.cpp \
         ../runner_android.cpp \
         ../shaderblittest.cpp \
         ../test.cpp \
-        ../util.cpp
+        ../texgen.cpp \
+        ../texttest.cpp \
+        ../texturechurntest.cpp \
+        ../texturethrashtest.cpp \
+        ../tracetest.cpp \
+        ../util.cpp \
+        ../videotest.cpp
 
 include $(BUILD_SHARED_LIBRARY)
 
@@ -0,0 +1,176 @@
+/**
+ * OpenGL ES 2.0 memory performance estimator
+ * Copyright (C) 2012 Google
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * \author Sami Kyöstilä <skyostil@google.com>
+ *
+ * GPU completion latency measurement using EGL fences
+ */
+#include "latencytracker.h"
+#include "util.h"
+
+#include <algorithm>
+#include <stdio.h>
+
+LatencyTracker::LatencyTracker():
+    m_running(false),
+    m_stopping(false),
+    m_totalDepth(0),
+    m_maxDepth(0),
+    m_frames(0),
+    m_eglCreateSyncKHR(0),
+    m_eglDestroySyncKHR(0),
+    m_eglClientWaitSyncKHR(0)
+{
+    pthread_mutex_init(&m_mutex, NULL);
+    pthread_cond_init(&m_cond, NULL);
+}
+
+LatencyTracker::~LatencyTracker()
+{
+    stop();
+    pthread_cond_destroy(&m_cond);
+    pthread_mutex_destroy(&m_mutex);
+}
+
+bool LatencyTracker::start()
+{
+    ASSERT(!m_running);
+
+    if (!isEGLExtensionSupported("EGL_KHR_fence_sync"))
+    {
+        return false;
+    }
+
+    m_eglCreateSyncKHR = (PFNEGLCREATESYNCKHRPROC)eglGetProcAddress("eglCreateSyncKHR");
+    m_eglDestroySyncKHR = (PFNEGLDESTROYSYNCKHRPROC)eglGetProcAddress("eglDestroySyncKHR");
+    m_eglClientWaitSyncKHR = (PFNEGLCLIENTWAITSYNCKHRPROC)eglGetProcAddress("eglClientWaitSyncKHR");
+    ASSERT(m_eglCreateSyncKHR && m_eglDestroySyncKHR && m_eglClientWaitSyncKHR);
+
+    m_latencies.clear();
+    m_totalDepth = 0;
+    m_maxDepth = 0;
+    m_frames = 0;
+    m_stopping = false;
+
+    if (pthread_create(&m_thread, NULL, threadMain, this))
+    {
+        return false;
+    }
+    m_running = true;
+    return true;
+}
+
+void LatencyTracker::frame()
+{
+    PendingFrame frame;
+
+    clock_gettime(CLOCK_REALTIME, &frame.submitted);
+    frame.sync = m_eglCreateSyncKHR(ctx.dpy, EGL_SYNC_FENCE_KHR, NULL);
+    ASSERT(frame.sync != EGL_NO_SYNC_KHR);
+
+    // The worker thread has no current context, so make sure the fence
+    // actually reaches the GPU
+    glFlush();
+
+    pthread_mutex_lock(&m_mutex);
+    int depth = m_pending.size();
+    m_totalDepth += depth;
+    m_maxDepth = std::max(m_maxDepth, depth);
+    m_frames++;
+    m_pending.push_back(frame);
+    pthread_cond_signal(&m_cond);
+    pthread_mutex_unlock(&m_mutex);
+}
+
+void LatencyTracker::stop()
+{
+    if (!m_running)
+    {
+        return;
+    }
+
+    pthread_mutex_lock(&m_mutex);
+    m_stopping = true;
+    pthread_cond_signal(&m_cond);
+    pthread_mutex_unlock(&m_mutex);
+
+    pthread_join(m_thread, NULL);
+    m_running = false;
+}
+
+void* LatencyTracker::threadMain(void* arg)
+{
+    static_cast<LatencyTracker*>(arg)->run();
+    return NULL;
+}
+
+void LatencyTracker::run()
+{
+    pthread_mutex_lock(&m_mutex);
+    while (true)
+    {
+        while (m_pending.empty() && !m_stopping)
+        {
+            pthread_cond_wait(&m_cond, &m_mutex);
+        }
+        if (m_pending.empty())
+        {
+            break;
+        }
+
+        // Keep the frame queued while waiting so that it counts towards
+        // the queue depth
+        PendingFrame frame = m_pending.front();
+        pthread_mutex_unlock(&m_mutex);
+
+        struct timespec completed;
+        m_eglClientWaitSyncKHR(ctx.dpy, frame.sync, 0, EGL_FOREVER_KHR);
+        clock_gettime(CLOCK_REALTIME, &completed);
+        m_eglDestroySyncKHR(ctx.dpy, frame.sync);
+
+        pthread_mutex_lock(&m_mutex);
+        m_pending.pop_front();
+        m_latencies.push_back(timeDiff(frame.submitted, completed));
+    }
+    pthread_mutex_unlock(&m_mutex);
+}
+
+std::string LatencyTracker::summary() const
+{
+    char buf[128];
+
+    if (m_latencies.empty())
+    {
+        return "";
+    }
+
+    std::vector<int64_t> sorted(m_latencies);
+    std::sort(sorted.begin(), sorted.end());
+
+    int64_t total = 0;
+    for (size_t i = 0; i < sorted.size(); i++)
+    {
+        total += sorted[i];
+    }
+
+    snprintf(buf, sizeof(buf), "latency %6.2f ms p95 %6.2f ms depth %4.2f max %d",
+             total / (1000.0f * 1000.0f * sorted.size()),
+             sorted[(sorted.size() - 1) * 95 / 100] / (1000.0f * 1000.0f),
+             static_cast<float>(m_totalDepth) / m_frames, m_maxDepth);
+    return buf;
+}
@@ -0,0 +1,95 @@
+/**
+ * OpenGL ES 2.0 memory performance estimator
+ * Copyright (C) 2012 Google
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * \author Sami Kyöstilä <skyostil@google.com>
+ *
+ * GPU completion latency measurement using EGL fences
+ */
+#ifndef LATENCYTRACKER_H
+#define LATENCYTRACKER_H
+
+#include "ext.h"
+#include <deque>
+#include <string>
+#include <vector>
+#include <pthread.h>
+#include <stdint.h>
+#include <time.h>
+
+/**
+ *  Inserts a fence after every frame and records when the GPU finishes it.
+ *  A worker thread waits for the fences in submission order, so the main
+ *  thread is never blocked by the measurement.
+ */
+class LatencyTracker
+{
+public:
+    LatencyTracker();
+    ~LatencyTracker();
+
+    /**
+     *  Start tracking frames
+     *
+     *  @returns true on success, false if EGL_KHR_fence_sync is not supported
+     */
+    bool start();
+
+    /**
+     *  Mark the end of a frame. Must be called with the rendering context
+     *  current.
+     */
+    void frame();
+
+    /**
+     *  Wait for all outstanding frames to complete and stop tracking
+     */
+    void stop();
+
+    /**
+     *  @returns a one-line description of the submission to completion
+     *  latency and the number of frames in flight
+     */
+    std::string summary() const;
+
+protected:
+    struct PendingFrame
+    {
+        EGLSyncKHR sync;
+        struct timespec submitted;
+    };
+
+    static void* threadMain(void* arg);
+    void run();
+
+    pthread_t m_thread;
+    pthread_mutex_t m_mutex;
+    pthread_cond_t m_cond;
+    bool m_running;
+    bool m_stopping;
+    std::deque<PendingFrame> m_pending;
+    std::vector<int64_t> m_latencies;
+    int64_t m_totalDepth;
+    int m_maxDepth;
+    int m_frames;
+
+    PFNEGLCREATESYNCKHRPROC m_eglCreateSyncKHR;
+    PFNEGLDESTROYSYNCKHRPROC m_eglDestroySyncKHR;
+    PFNEGLCLIENTWAITSYNCKHRPROC m_eglClientWaitSyncKHR;
+};
+
+#endif // LATENCYTRACKER_H
@@ -0,0 +1,297 @@
+/**
+ * OpenGL ES 2.0 memory performance estimator
+ * Copyright (C) 2012 Google
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * \author Sami Kyöstilä <skyostil@google.com>
+ *
+ * Process memory usage queries
+ */
+#include "memory.h"
+#include "ext.h"
+#include "util.h"
+
+#include <algorithm>
+#include <dirent.h>
+#include <set>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ *  Read a "Name:   1234 kB" style field from a /proc status file
+ */
+static int64_t readStatusField(const char* fileName, const char* field)
+{
+    FILE* f = fopen(fileName, "r");
+    char line[256];
+    int64_t result = -1;
+    size_t len = strlen(field);
+
+    if (!f)
+    {
+        return -1;
+    }
+
+    while (fgets(line, sizeof(line), f))
+    {
+        long long kb;
+        if (!strncmp(line, field, len) && line[len] == ':' &&
+            sscanf(line + len + 1, "%lld", &kb) == 1)
+        {
+            result = kb * 1024;
+            break;
+        }
+    }
+    fclose(f);
+    return result;
+}
+
+/**
+ *  Sum a "Name:   1234 kB" style field over all mappings in /proc/self/smaps.
+ *  Only used on kernels without smaps_rollup.
+ */
+static int64_t sumSmapsField(const char* field)
+{
+    FILE* f = fopen("/proc/self/smaps", "r");
+    char line[256];
+    int64_t result = -1;
+    size_t len = strlen(field);
+
+    if (!f)
+    {
+        return -1;
+    }
+
+    while (fgets(line, sizeof(line), f))
+    {
+        long long kb;
+        if (!strncmp(line, field, len) && line[len] == ':' &&
+            sscanf(line + len + 1, "%lld", &kb) == 1)
+        {
+            result = (result < 0 ? 0 : result) + kb * 1024;
+        }
+    }
+    fclose(f);
+    return result;
+}
+
+/**
+ *  Parse a DRM fdinfo memory value such as "1234 KiB"
+ */
+static int64_t parseDrmSize(const char* value)
+{
+    long long size;
+    char unit[8] = "";
+
+    if (sscanf(value, "%lld %7s", &size, unit) < 1)
+    {
+        return 0;
+    }
+    if (!strcmp(unit, "KiB"))
+    {
+        return size * 1024;
+    }
+    if (!strcmp(unit, "MiB"))
+    {
+        return size * 1024 * 1024;
+    }
+    return size;
+}
+
+/**
+ *  Sum the memory of all DRM clients opened by this process, as reported by
+ *  the drm-resident-*, drm-total-* or legacy drm-memory-* fdinfo keys. A
+ *  client shared by several file descriptors is only counted once.
+ */
+static int64_t drmMemory()
+{
+    DIR* dir = opendir("/proc/self/fdinfo");
+    struct dirent* entry;
+    std::set<std::string> clients;
+    int64_t result = -1;
+
+    if (!dir)
+    {
+        return -1;
+    }
+
+    while ((entry = readdir(dir)))
+    {
+        std::string fileName = std::string("/proc/self/fdinfo/") + entry->d_name;
+        FILE* f;
+        char line[256];
+        std::string client;
+        int64_t resident = -1, total = -1, memory = -1;
+        int64_t* field;
+
+        if (entry->d_name[0] == '.' || !(f = fopen(fileName.c_str(), "r")))
+        {
+            continue;
+        }
+
+        while (fgets(line, sizeof(line), f))
+        {
+            char* value = strchr(line, ':');
+            if (!value)
+            {
+                continue;
+            }
+            *value++ = 0;
+
+            if (!strcmp(line, "drm-client-id"))
+            {
+                client = value;
+                continue;
+            }
+            else if (!strncmp(line, "drm-resident-", 13))
+            {
+                field = &resident;
+            }
+            else if (!strncmp(line, "drm-total-", 10))
+            {
+                field = &total;
+            }
+            else if (!strncmp(line, "drm-memory-", 11))
+            {
+                field = &memory;
+            }
+            else
+            {
+                continue;
+            }
+            *field = (*field < 0 ? 0 : *field) + parseDrmSize(value);
+        }
+        fclose(f);
+
+        if (client.empty() || !clients.insert(client).second)
+        {
+            continue;
+        }
+
+        int64_t usage = (resident >= 0) ? resident : (total >= 0) ? total : memory;
+        if (usage >= 0)
+        {
+            result = (result < 0 ? 0 : result) + usage;
+        }
+    }
+    closedir(dir);
+    return result;
+}
+
+/**
+ *  Estimate graphics memory usage from the free video memory reported by
+ *  GL_NVX_gpu_memory_info. This covers all processes, not just ours.
+ */
+static int64_t nvxMemory()
+{
+    GLint total = 0, available = 0;
+
+    if (!isGLExtensionSupported("GL_NVX_gpu_memory_info"))
+    {
+        return -1;
+    }
+    glGetIntegerv(GL_GPU_MEMORY_INFO_TOTAL_AVAILABLE_MEMORY_NVX, &total);
+    glGetIntegerv(GL_GPU_MEMORY_INFO_CURRENT_AVAILABLE_VIDMEM_NVX, &available);
+    return (total - available) * 1024LL;
+}
+
+int64_t residentMemory()
+{
+    return readStatusField("/proc/self/status", "VmRSS");
+}
+
+int64_t systemMemory()
+{
+    return readStatusField("/proc/meminfo", "MemTotal");
+}
+
+MemoryUsage sampleMemory()
+{
+    MemoryUsage usage;
+
+    usage.resident = readStatusField("/proc/self/status", "VmRSS");
+    usage.peakResident = readStatusField("/proc/self/status", "VmHWM");
+    usage.privateDirty = readStatusField("/proc/self/smaps_rollup", "Private_Dirty");
+    if (usage.privateDirty < 0)
+    {
+        usage.privateDirty = sumSmapsField("Private_Dirty");
+    }
+    usage.gpu = drmMemory();
+    if (usage.gpu < 0)
+    {
+        usage.gpu = nvxMemory();
+    }
+    return usage;
+}
+
+void resetPeakMemory()
+{
+    FILE* f = fopen("/proc/self/clear_refs", "w");
+
+    if (f)
+    {
+        fputs("5", f);
+        fclose(f);
+    }
+}
+
+static long long kilobytes(int64_t from, int64_t to)
+{
+    return static_cast<long long>((to - from) / 1024);
+}
+
+std::string memorySummary(const MemoryUsage& start, const MemoryUsage& prepared,
+                          const MemoryUsage& finished, const MemoryUsage& end)
+{
+    std::string result;
+    char buf[64];
+
+    if (start.resident >= 0 && end.resident >= 0)
+    {
+        int64_t peak = std::max(prepared.resident, finished.resident);
+
+        // The peak counter is only meaningful if it was reset at the start
+        if (start.peakResident == start.resident)
+        {
+            peak = std::max(peak, end.peakResident);
+        }
+        snprintf(buf, sizeof(buf), "rss %+lld/%+lld/%+lld kB",
+                 kilobytes(start.resident, prepared.resident),
+                 kilobytes(start.resident, peak),
+                 kilobytes(start.resident, end.resident));
+        result += buf;
+    }
+
+    if (start.privateDirty >= 0 && end.privateDirty >= 0)
+    {
+        snprintf(buf, sizeof(buf), " dirty %+lld kB",
+                 kilobytes(start.privateDirty, end.privateDirty));
+        result += buf;
+    }
+
+    if (start.gpu >= 0 && end.gpu >= 0)
+    {
+        int64_t peak = std::max(prepared.gpu, finished.gpu);
+        snprintf(buf, sizeof(buf), " gpu %+lld/%+lld/%+lld kB",
+                 kilobytes(start.gpu, prepared.gpu),
+                 kilobytes(start.gpu, peak),
+                 kilobytes(start.gpu, end.gpu));
+        result += buf;
+    }
+
+    return result;
+}
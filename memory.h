@@ -0,0 +1,81 @@
+/**
+ * OpenGL ES 2.0 memory performance estimator
+ * Copyright (C) 2012 Google
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * \author Sami Kyöstilä <skyostil@google.com>
+ *
+ * Process memory usage queries
+ */
+#ifndef MEMORY_H
+#define MEMORY_H
+
+#include <stdint.h>
+#include <string>
+
+/**
+ *  Memory usage of the process at a point in time. Fields which cannot be
+ *  determined on the current system are set to -1.
+ */
+struct MemoryUsage
+{
+    int64_t resident;           //< Resident set size (VmRSS)
+    int64_t peakResident;       //< Peak resident set size (VmHWM)
+    int64_t privateDirty;       //< Private dirty pages from smaps
+    int64_t gpu;                //< Graphics memory from DRM fdinfo or
+                                //< GL_NVX_gpu_memory_info
+};
+
+/**
+ *  @returns the resident set size of the process in bytes, or -1 if it
+ *  cannot be determined
+ */
+int64_t residentMemory();
+
+/**
+ *  @returns the total amount of system memory in bytes, or -1 if it cannot
+ *  be determined
+ */
+int64_t systemMemory();
+
+/**
+ *  Sample the memory usage of the process. The graphics memory query may use
+ *  GL, so the rendering context should be current.
+ */
+MemoryUsage sampleMemory();
+
+/**
+ *  Reset the peak resident set size reported by sampleMemory() to the
+ *  current resident set size. Requires Linux 4.0 or later; has no effect
+ *  otherwise.
+ */
+void resetPeakMemory();
+
+/**
+ *  Describe how memory usage changed over the course of a test
+ *
+ *  @param start                Usage before the test was prepared
+ *  @param prepared             Usage after the test was prepared
+ *  @param finished             Usage after the last frame was rendered
+ *  @param end                  Usage after the test was torn down
+ *
+ *  @returns a one-line summary of the prepared, peak and residual usage
+ *  relative to the start
+ */
+std::string memorySummary(const MemoryUsage& start, const MemoryUsage& prepared,
+                          const MemoryUsage& finished, const MemoryUsage& end);
+
+#endif // MEMORY_H
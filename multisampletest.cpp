@@ -0,0 +1,417 @@
+/**
+ * OpenGL ES 2.0 memory performance estimator
+ * Copyright (C) 2012 Google
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * \author Sami Kyöstilä <skyostil@google.com>
+ *
+ * Multisampled render target tests
+ */
+#include "multisampletest.h"
+#include "native.h"
+
+#include <sstream>
+#include <stdio.h>
+
+template <>
+MultisampleTest<BlitTest>::MultisampleTest(MultisampleTarget target, int samples,
+                                           GLenum format, GLenum type, int width, int height,
+                                           const std::string& fileName):
+    BlitTest(format, type, width, height, fileName),
+    m_target(target),
+    m_samples(samples),
+    m_framebuffer(0),
+    m_colorbuffer(0),
+    m_colorTexture(0)
+{
+}
+
+template <>
+MultisampleTest<ShaderBlitTest>::MultisampleTest(MultisampleTarget target, int samples,
+                                                 const std::string& effect, int width, int height):
+    ShaderBlitTest(effect, width, height),
+    m_target(target),
+    m_samples(samples),
+    m_framebuffer(0),
+    m_colorbuffer(0),
+    m_colorTexture(0)
+{
+}
+
+template <class PARENT>
+void MultisampleTest<PARENT>::prepareWindow()
+{
+#if !defined(SUPPORT_ANDROID)
+    EGLint bufferSize = 0;
+    eglGetConfigAttrib(ctx.dpy, ctx.config, EGL_BUFFER_SIZE, &bufferSize);
+
+    const EGLint configAttrs[] =
+    {
+        EGL_BUFFER_SIZE, bufferSize,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_ES2_BIT,
+        EGL_SURFACE_TYPE, EGL_WINDOW_BIT,
+        EGL_SAMPLE_BUFFERS, (m_samples > 1) ? 1 : 0,
+        EGL_SAMPLES, (m_samples > 1) ? m_samples : 0,
+        EGL_NONE
+    };
+
+    const EGLint contextAttrs[] =
+    {
+        EGL_CONTEXT_CLIENT_VERSION, 2,
+        EGL_NONE
+    };
+
+    EGLConfig config = 0;
+    EGLint configCount = 0;
+    EGLint samples = 0;
+
+    eglChooseConfig(ctx.dpy, configAttrs, &config, 1, &configCount);
+    if (configCount)
+    {
+        eglGetConfigAttrib(ctx.dpy, config, EGL_SAMPLES, &samples);
+    }
+    if (!configCount || (m_samples > 1 && samples != m_samples))
+    {
+        std::stringstream s;
+        s << "Config with " << m_samples << " sample(s) per pixel not found";
+        this->fail(s.str());
+    }
+
+    // Switch all rendering to the new window until teardown()
+    m_savedCtx = ctx;
+    ctx.win = 0;
+    ctx.context = EGL_NO_CONTEXT;
+    ctx.surface = EGL_NO_SURFACE;
+
+    try
+    {
+        bool success = nativeCreateWindow(ctx.nativeDisplay, ctx.dpy, config, __FILE__,
+                                          m_targetWidth, m_targetHeight, &ctx.win);
+        ASSERT(success);
+
+        ctx.config = config;
+        ctx.context = eglCreateContext(ctx.dpy, ctx.config, EGL_NO_CONTEXT, contextAttrs);
+        ASSERT_EGL();
+        ASSERT(ctx.context);
+
+        ctx.surface = eglCreateWindowSurface(ctx.dpy, ctx.config, ctx.win, NULL);
+        ASSERT_EGL();
+        ASSERT(ctx.surface);
+
+        eglMakeCurrent(ctx.dpy, ctx.surface, ctx.surface, ctx.context);
+        ASSERT_EGL();
+        eglSwapInterval(ctx.dpy, 0);
+
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        ASSERT_GL();
+    }
+    catch (...)
+    {
+        destroyWindow();
+        throw;
+    }
+#endif
+}
+
+template <class PARENT>
+void MultisampleTest<PARENT>::destroyWindow()
+{
+#if !defined(SUPPORT_ANDROID)
+    eglMakeCurrent(ctx.dpy, m_savedCtx.surface, m_savedCtx.surface, m_savedCtx.context);
+    if (ctx.surface != EGL_NO_SURFACE)
+    {
+        eglDestroySurface(ctx.dpy, ctx.surface);
+    }
+    if (ctx.context != EGL_NO_CONTEXT)
+    {
+        eglDestroyContext(ctx.dpy, ctx.context);
+    }
+    if (ctx.win)
+    {
+        nativeDestroyWindow(ctx.nativeDisplay, ctx.win);
+    }
+    ctx = m_savedCtx;
+#endif
+}
+
+template <class PARENT>
+void MultisampleTest<PARENT>::teardownWindow()
+{
+    destroyWindow();
+    ASSERT_EGL();
+}
+
+template <class PARENT>
+void MultisampleTest<PARENT>::prepareFramebuffer()
+{
+    glGenFramebuffers(1, &m_framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+
+    if (m_target == MSAA_FBO_TEXTURE)
+    {
+        glGenTextures(1, &m_colorTexture);
+        glBindTexture(GL_TEXTURE_2D, m_colorTexture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, m_targetWidth, m_targetHeight, 0,
+                     GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+        ASSERT_GL();
+
+        if (m_samples > 1)
+        {
+            m_glFramebufferTexture2DMultisample = (PFNGLFRAMEBUFFERTEXTURE2DMULTISAMPLEEXTPROC)
+                eglGetProcAddress("glFramebufferTexture2DMultisampleEXT");
+            ASSERT(m_glFramebufferTexture2DMultisample);
+
+            // The samples are resolved into the texture implicitly when the
+            // framebuffer is flushed
+            m_glFramebufferTexture2DMultisample(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                                                GL_TEXTURE_2D, m_colorTexture, 0, m_samples);
+        }
+        else
+        {
+            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                                   GL_TEXTURE_2D, m_colorTexture, 0);
+        }
+    }
+    else
+    {
+        m_glRenderbufferStorageMultisample = (PFNGLRENDERBUFFERSTORAGEMULTISAMPLEPROC)
+            eglGetProcAddress("glRenderbufferStorageMultisample");
+        m_glBlitFramebuffer = (PFNGLBLITFRAMEBUFFERPROC)
+            eglGetProcAddress("glBlitFramebuffer");
+        ASSERT(m_glRenderbufferStorageMultisample);
+        ASSERT(m_glBlitFramebuffer);
+
+        // Resolving requires the formats of the renderbuffer and the window
+        // to match
+        EGLint redSize = 0, alphaSize = 0;
+        GLenum format;
+        eglGetConfigAttrib(ctx.dpy, ctx.config, EGL_RED_SIZE, &redSize);
+        eglGetConfigAttrib(ctx.dpy, ctx.config, EGL_ALPHA_SIZE, &alphaSize);
+        if (redSize == 5)
+        {
+            format = GL_RGB565;
+        }
+        else if (alphaSize)
+        {
+            format = GL_RGBA8;
+        }
+        else
+        {
+            format = GL_RGB8;
+        }
+
+        glGenRenderbuffers(1, &m_colorbuffer);
+        glBindRenderbuffer(GL_RENDERBUFFER, m_colorbuffer);
+        m_glRenderbufferStorageMultisample(GL_RENDERBUFFER, (m_samples > 1) ? m_samples : 0,
+                                           format, m_targetWidth, m_targetHeight);
+        ASSERT_GL();
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                                  GL_RENDERBUFFER, m_colorbuffer);
+        glBindRenderbuffer(GL_RENDERBUFFER, 0);
+    }
+    ASSERT_GL();
+
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    if (status != GL_FRAMEBUFFER_COMPLETE)
+    {
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        teardownFramebuffer();
+        this->fail("Multisampled framebuffer not complete");
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    ASSERT_GL();
+}
+
+template <class PARENT>
+void MultisampleTest<PARENT>::teardownFramebuffer()
+{
+    glDeleteFramebuffers(1, &m_framebuffer);
+    m_framebuffer = 0;
+    if (m_colorbuffer)
+    {
+        glDeleteRenderbuffers(1, &m_colorbuffer);
+        m_colorbuffer = 0;
+    }
+    if (m_colorTexture)
+    {
+        glDeleteTextures(1, &m_colorTexture);
+        m_colorTexture = 0;
+    }
+}
+
+template <class PARENT>
+std::string MultisampleTest<PARENT>::unsupportedReason() const
+{
+    GLint maxSamples = 1;
+
+    switch (m_target)
+    {
+    case MSAA_WINDOW:
+#if defined(SUPPORT_ANDROID)
+        return "Multisampled windows not supported";
+#endif
+        break;
+    case MSAA_FBO_TEXTURE:
+        if (m_samples > 1)
+        {
+            if (!isGLExtensionSupported("GL_EXT_multisampled_render_to_texture"))
+            {
+                return "GL_EXT_multisampled_render_to_texture not supported";
+            }
+            glGetIntegerv(GL_MAX_SAMPLES_EXT, &maxSamples);
+        }
+        break;
+    case MSAA_FBO_BLIT:
+        if (glesVersion() < 3)
+        {
+            return "OpenGL ES 3.0 not supported";
+        }
+        glGetIntegerv(GL_MAX_SAMPLES, &maxSamples);
+        break;
+    }
+
+    if (m_target != MSAA_WINDOW && m_samples > maxSamples)
+    {
+        return "Sample count not supported";
+    }
+    return PARENT::unsupportedReason();
+}
+
+template <class PARENT>
+void MultisampleTest<PARENT>::prepare()
+{
+    eglQuerySurface(ctx.dpy, ctx.surface, EGL_WIDTH, &m_targetWidth);
+    eglQuerySurface(ctx.dpy, ctx.surface, EGL_HEIGHT, &m_targetHeight);
+
+    // The render target is set up first so that the parent test is free to
+    // leave its own textures bound
+    if (m_target == MSAA_WINDOW)
+    {
+        prepareWindow();
+    }
+    else
+    {
+        prepareFramebuffer();
+    }
+
+    // Never leave the runner rendering into a half prepared target
+    try
+    {
+        PARENT::prepare();
+    }
+    catch (...)
+    {
+        if (m_target == MSAA_WINDOW)
+        {
+            destroyWindow();
+        }
+        else
+        {
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            teardownFramebuffer();
+        }
+        throw;
+    }
+}
+
+template <class PARENT>
+void MultisampleTest<PARENT>::operator()(int frame)
+{
+    if (m_target != MSAA_WINDOW)
+    {
+        glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    }
+
+    PARENT::operator()(frame);
+
+    if (m_target == MSAA_FBO_BLIT)
+    {
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, m_framebuffer);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+        m_glBlitFramebuffer(0, 0, m_targetWidth, m_targetHeight,
+                            0, 0, m_targetWidth, m_targetHeight,
+                            GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    }
+
+    if (m_target != MSAA_WINDOW)
+    {
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    }
+}
+
+template <class PARENT>
+void MultisampleTest<PARENT>::teardown()
+{
+    PARENT::teardown();
+
+    if (m_target == MSAA_WINDOW)
+    {
+        teardownWindow();
+    }
+    else
+    {
+        teardownFramebuffer();
+    }
+}
+
+template <class PARENT>
+bool MultisampleTest<PARENT>::capturesWindow() const
+{
+    // Samples resolved into a texture never reach the window
+    return m_target != MSAA_FBO_TEXTURE && PARENT::capturesWindow();
+}
+
+template <class PARENT>
+std::string MultisampleTest<PARENT>::name() const
+{
+    std::stringstream s;
+
+    s << PARENT::name() << "_msaa" << m_samples << "x_";
+
+    switch (m_target)
+    {
+    case MSAA_WINDOW:
+        s << "window";
+        break;
+    case MSAA_FBO_TEXTURE:
+        s << "texture";
+        break;
+    case MSAA_FBO_BLIT:
+        s << "blit";
+        break;
+    }
+
+    return s.str();
+}
+
+template <class PARENT>
+std::string MultisampleTest<PARENT>::baselineName() const
+{
+    if (m_samples <= 1)
+    {
+        return "";
+    }
+
+    // Compare against the single-sampled version of the same target
+    std::string s = name();
+    std::stringstream samples;
+    samples << "_msaa" << m_samples << "x_";
+    s.replace(s.rfind(samples.str()), samples.str().size(), "_msaa1x_");
+    return s;
+}
@@ -0,0 +1,86 @@
+/**
+ * OpenGL ES 2.0 memory performance estimator
+ * Copyright (C) 2012 Google
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * \author Sami Kyöstilä <skyostil@google.com>
+ *
+ * Multisampled render target tests
+ */
+#ifndef MULTISAMPLETEST_H
+#define MULTISAMPLETEST_H
+
+#include "blittest.h"
+#include "shaderblittest.h"
+#include "util.h"
+#include "ext.h"
+#include <EGL/egl.h>
+
+enum MultisampleTarget
+{
+    MSAA_WINDOW,                //< Multisampled EGL window surface
+    MSAA_FBO_TEXTURE,           //< Texture with GL_EXT_multisampled_render_to_texture
+    MSAA_FBO_BLIT,              //< Renderbuffer resolved with glBlitFramebuffer
+};
+
+template <class PARENT>
+class MultisampleTest: public PARENT
+{
+protected:
+    MultisampleTarget m_target;
+    int m_samples;
+    int m_targetWidth, m_targetHeight;
+
+    struct Context m_savedCtx;
+
+    GLuint m_framebuffer;
+    GLuint m_colorbuffer;
+    GLuint m_colorTexture;
+
+    PFNGLRENDERBUFFERSTORAGEMULTISAMPLEPROC m_glRenderbufferStorageMultisample;
+    PFNGLFRAMEBUFFERTEXTURE2DMULTISAMPLEEXTPROC m_glFramebufferTexture2DMultisample;
+    PFNGLBLITFRAMEBUFFERPROC m_glBlitFramebuffer;
+
+private:
+    void prepareWindow();
+    void destroyWindow();
+    void teardownWindow();
+    void prepareFramebuffer();
+    void teardownFramebuffer();
+
+public:
+    /**
+     *  @param target           Multisampled render target type
+     *  @param samples          Number of samples per pixel, 1 for a
+     *                          single-sampled reference
+     */
+    MultisampleTest(MultisampleTarget target, int samples,
+                    GLenum format, GLenum type, int width, int height,
+                    const std::string& fileName);
+
+    MultisampleTest(MultisampleTarget target, int samples,
+                    const std::string& effect, int width, int height);
+
+    std::string unsupportedReason() const;
+    void prepare();
+    void operator()(int frame);
+    void teardown();
+    std::string name() const;
+    bool capturesWindow() const;
+    std::string baselineName() const;
+};
+
+#endif // MULTISAMPLETEST_H
@@ -0,0 +1,129 @@
+/**
+ * OpenGL ES 2.0 memory performance estimator
+ * Copyright (C) 2012 Google
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * \author Sami Kyöstilä <skyostil@google.com>
+ *
+ * Swap interval pacing test
+ */
+#include "pacingtest.h"
+#include "util.h"
+
+#include <algorithm>
+#include <sstream>
+#include <stdio.h>
+
+PacingTest::PacingTest(int swapInterval, int cpuWork, int gpuLayers, int refreshRate):
+    BlitTest(GL_RGBA, GL_UNSIGNED_BYTE, 800, 480, "data/water2_800x480_rgba8888.raw"),
+    m_swapInterval(swapInterval),
+    m_cpuWork(cpuWork),
+    m_gpuLayers(gpuLayers),
+    m_refreshRate(refreshRate),
+    m_minHeadroom(0),
+    m_totalHeadroom(0),
+    m_headroomSamples(0)
+{
+    ASSERT(m_gpuLayers >= 1);
+    ASSERT(m_refreshRate >= 1);
+}
+
+void PacingTest::prepare()
+{
+    BlitTest::prepare();
+    eglSwapInterval(ctx.dpy, m_swapInterval);
+    ASSERT_EGL();
+}
+
+void PacingTest::operator()(int frame)
+{
+    // Warmup frames are all numbered zero, so the statistics end up
+    // covering only the measured frames
+    if (frame == 0)
+    {
+        m_stats.reset(m_swapInterval ? m_refreshRate / m_swapInterval : 0);
+        m_minHeadroom = 0;
+        m_totalHeadroom = 0;
+        m_headroomSamples = 0;
+    }
+
+    // This call follows the return from the previous swap, which with vsync
+    // enabled is released by a display refresh. The frame must be done
+    // within its swap interval from there to make the next refresh it is
+    // due for; without vsync a single refresh period is used.
+    struct timespec start, workEnd;
+    const int64_t deadline = 1000 * 1000 * 1000LL * std::max(m_swapInterval, 1) / m_refreshRate;
+
+    m_stats.frame();
+    clock_gettime(CLOCK_REALTIME, &start);
+
+    if (m_cpuWork)
+    {
+        struct timespec now;
+        do
+        {
+            clock_gettime(CLOCK_REALTIME, &now);
+        } while (timeDiff(start, now) < m_cpuWork * 1000LL);
+    }
+
+    glClear(GL_COLOR_BUFFER_BIT);
+    for (int i = 0; i < m_gpuLayers; i++)
+    {
+        render(frame);
+    }
+
+    clock_gettime(CLOCK_REALTIME, &workEnd);
+
+    int64_t headroom = deadline - timeDiff(start, workEnd);
+    if (!m_headroomSamples || headroom < m_minHeadroom)
+    {
+        m_minHeadroom = headroom;
+    }
+    m_totalHeadroom += headroom;
+    m_headroomSamples++;
+}
+
+void PacingTest::teardown()
+{
+    eglSwapInterval(ctx.dpy, 0);
+    BlitTest::teardown();
+}
+
+std::string PacingTest::name() const
+{
+    std::stringstream s;
+
+    s << "pacing_interval" << m_swapInterval;
+    s << "_cpu" << m_cpuWork << "us";
+    s << "_gpu" << m_gpuLayers << "x";
+
+    return s.str();
+}
+
+std::string PacingTest::statistics() const
+{
+    char buf[80];
+    std::string s = m_stats.summary();
+
+    if (m_headroomSamples)
+    {
+        snprintf(buf, sizeof(buf), " headroom min %5.2f ms avg %5.2f ms",
+                 m_minHeadroom / (1000.0f * 1000.0f),
+                 m_totalHeadroom / (1000.0f * 1000.0f * m_headroomSamples));
+        s += buf;
+    }
+    return s;
+}
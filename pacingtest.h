@@ -0,0 +1,67 @@
+/**
+ * OpenGL ES 2.0 memory performance estimator
+ * Copyright (C) 2012 Google
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * \author Sami Kyöstilä <skyostil@google.com>
+ *
+ * Swap interval pacing test
+ */
+#ifndef PACINGTEST_H
+#define PACINGTEST_H
+
+#include "blittest.h"
+#include "framestats.h"
+
+/** Display refresh rate in Hz assumed when none is given */
+#define PACING_DEFAULT_REFRESH_RATE 60
+
+/**
+ *  Measures frame pacing for a given mix of CPU and GPU work per frame. The
+ *  headroom is the time left between the end of a frame's work and the
+ *  vsync deadline of its swap interval; a negative value means the deadline
+ *  was missed.
+ */
+class PacingTest: public BlitTest
+{
+protected:
+    int m_swapInterval;
+    int m_cpuWork;
+    int m_gpuLayers;
+    int m_refreshRate;
+    FrameStatistics m_stats;
+    int64_t m_minHeadroom;
+    int64_t m_totalHeadroom;
+    int m_headroomSamples;
+
+public:
+    /**
+     *  @param swapInterval     EGL swap interval, zero for no vsync
+     *  @param cpuWork          Busy loop duration per frame in microseconds
+     *  @param gpuLayers        Number of full-screen blits per frame
+     *  @param refreshRate      Display refresh rate in Hz
+     */
+    PacingTest(int swapInterval, int cpuWork, int gpuLayers,
+               int refreshRate = PACING_DEFAULT_REFRESH_RATE);
+
+    void prepare();
+    void operator()(int frame);
+    void teardown();
+    std::string name() const;
+    std::string statistics() const;
+};
+
+#endif // PACINGTEST_H
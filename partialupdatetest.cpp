@@ -0,0 +1,274 @@
+/**
+ * OpenGL ES 2.0 memory performance estimator
+ * Copyright (C) 2012 Google
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * \author Sami Kyöstilä <skyostil@google.com>
+ *
+ * Partial screen update test
+ */
+#include "partialupdatetest.h"
+#include "util.h"
+
+#include <algorithm>
+#include <math.h>
+#include <sstream>
+#include <stdio.h>
+#include <string.h>
+
+PartialUpdateTest::PartialUpdateTest(PartialUpdateMethod method, float damage):
+    BlitTest(GL_RGB, GL_UNSIGNED_SHORT_5_6_5, 800, 480, "data/water2_800x480_rgb565.raw"),
+    m_method(method),
+    m_damage(damage),
+    m_historySize(0),
+    m_repaintedPixels(0),
+    m_frames(0),
+    m_savedSwapBehavior(EGL_BUFFER_DESTROYED),
+    m_eglSetDamageRegion(0)
+{
+    ASSERT(m_damage > 0.0f && m_damage <= 1.0f);
+}
+
+std::string PartialUpdateTest::unsupportedReason() const
+{
+    bool bufferAge = isEGLExtensionSupported("EGL_EXT_buffer_age") ||
+                     isEGLExtensionSupported("EGL_KHR_partial_update");
+
+    switch (m_method)
+    {
+    case PARTIAL_FULL:
+        break;
+    case PARTIAL_BUFFER_AGE:
+        if (!bufferAge)
+        {
+            return "EGL_EXT_buffer_age not supported";
+        }
+        break;
+    case PARTIAL_SWAP_DAMAGE:
+        if (!bufferAge)
+        {
+            return "EGL_EXT_buffer_age not supported";
+        }
+        if (!isEGLExtensionSupported("EGL_KHR_swap_buffers_with_damage") &&
+            !isEGLExtensionSupported("EGL_EXT_swap_buffers_with_damage"))
+        {
+            return "EGL_KHR_swap_buffers_with_damage not supported";
+        }
+        break;
+    case PARTIAL_UPDATE:
+        if (!isEGLExtensionSupported("EGL_KHR_partial_update"))
+        {
+            return "EGL_KHR_partial_update not supported";
+        }
+        break;
+    case PARTIAL_PRESERVED:
+        {
+            EGLint surfaceType = 0;
+            eglGetConfigAttrib(ctx.dpy, ctx.config, EGL_SURFACE_TYPE, &surfaceType);
+            if (!(surfaceType & EGL_SWAP_BEHAVIOR_PRESERVED_BIT))
+            {
+                return "EGL_BUFFER_PRESERVED not supported";
+            }
+        }
+        break;
+    }
+    return BlitTest::unsupportedReason();
+}
+
+void PartialUpdateTest::prepare()
+{
+    switch (m_method)
+    {
+    case PARTIAL_UPDATE:
+        m_eglSetDamageRegion = (PFNEGLSETDAMAGEREGIONKHRPROC)
+            eglGetProcAddress("eglSetDamageRegionKHR");
+        ASSERT(m_eglSetDamageRegion);
+        break;
+    case PARTIAL_PRESERVED:
+        eglQuerySurface(ctx.dpy, ctx.surface, EGL_SWAP_BEHAVIOR, &m_savedSwapBehavior);
+        eglSurfaceAttrib(ctx.dpy, ctx.surface, EGL_SWAP_BEHAVIOR, EGL_BUFFER_PRESERVED);
+        ASSERT_EGL();
+        break;
+    default:
+        break;
+    }
+
+    BlitTest::prepare();
+
+    eglQuerySurface(ctx.dpy, ctx.surface, EGL_WIDTH, &m_surfaceWidth);
+    eglQuerySurface(ctx.dpy, ctx.surface, EGL_HEIGHT, &m_surfaceHeight);
+    ASSERT_EGL();
+
+    float scale = sqrtf(m_damage);
+    m_damageWidth = std::max(1, static_cast<int>(m_surfaceWidth * scale));
+    m_damageHeight = std::max(1, static_cast<int>(m_surfaceHeight * scale));
+    m_historySize = 0;
+}
+
+void PartialUpdateTest::damageRect(int frame, EGLint* rect) const
+{
+    // Move the damaged area diagonally so that consecutive frames damage
+    // different parts of the screen
+    int rangeX = m_surfaceWidth - m_damageWidth + 1;
+    int rangeY = m_surfaceHeight - m_damageHeight + 1;
+
+    rect[0] = (frame * 16) % rangeX;
+    rect[1] = (frame * 8) % rangeY;
+    rect[2] = m_damageWidth;
+    rect[3] = m_damageHeight;
+}
+
+void PartialUpdateTest::repaintRect(int age, EGLint* rect) const
+{
+    // A buffer of age N is missing the damage of the last N frames. Unknown
+    // contents or a buffer older than our history must be fully repainted.
+    if (age <= 0 || age > m_historySize)
+    {
+        rect[0] = 0;
+        rect[1] = 0;
+        rect[2] = m_surfaceWidth;
+        rect[3] = m_surfaceHeight;
+        return;
+    }
+
+    int x0 = m_history[0][0], y0 = m_history[0][1];
+    int x1 = x0 + m_history[0][2], y1 = y0 + m_history[0][3];
+
+    for (int i = 1; i < age; i++)
+    {
+        x0 = std::min<int>(x0, m_history[i][0]);
+        y0 = std::min<int>(y0, m_history[i][1]);
+        x1 = std::max<int>(x1, m_history[i][0] + m_history[i][2]);
+        y1 = std::max<int>(y1, m_history[i][1] + m_history[i][3]);
+    }
+
+    rect[0] = x0;
+    rect[1] = y0;
+    rect[2] = x1 - x0;
+    rect[3] = y1 - y0;
+}
+
+void PartialUpdateTest::operator()(int frame)
+{
+    // Warmup frames are all numbered zero
+    if (frame == 0)
+    {
+        m_repaintedPixels = 0;
+        m_frames = 0;
+    }
+
+    memmove(m_history[1], m_history[0], sizeof(m_history[0]) * (PARTIAL_UPDATE_HISTORY - 1));
+    damageRect(frame, m_history[0]);
+    m_historySize = std::min(m_historySize + 1, PARTIAL_UPDATE_HISTORY);
+    m_frames++;
+
+    if (m_method == PARTIAL_FULL)
+    {
+        BlitTest::operator()(frame);
+        m_repaintedPixels += m_surfaceWidth * m_surfaceHeight;
+        return;
+    }
+
+    EGLint age = 0;
+    if (m_method == PARTIAL_PRESERVED)
+    {
+        // The back buffer always holds the previous frame, except right
+        // after the swap behavior was changed
+        age = (m_historySize > 1) ? 1 : 0;
+    }
+    else
+    {
+        eglQuerySurface(ctx.dpy, ctx.surface, EGL_BUFFER_AGE_EXT, &age);
+    }
+
+    EGLint repaint[4];
+    repaintRect(age, repaint);
+
+    if (m_method == PARTIAL_UPDATE)
+    {
+        m_eglSetDamageRegion(ctx.dpy, ctx.surface, repaint, 1);
+    }
+
+    glEnable(GL_SCISSOR_TEST);
+    glScissor(repaint[0], repaint[1], repaint[2], repaint[3]);
+    render(frame);
+
+    if (m_method == PARTIAL_SWAP_DAMAGE || m_method == PARTIAL_UPDATE)
+    {
+        setSwapDamage(m_history[0], 1);
+    }
+    m_repaintedPixels += repaint[2] * repaint[3];
+}
+
+void PartialUpdateTest::teardown()
+{
+    glDisable(GL_SCISSOR_TEST);
+    if (m_method == PARTIAL_PRESERVED)
+    {
+        eglSurfaceAttrib(ctx.dpy, ctx.surface, EGL_SWAP_BEHAVIOR, m_savedSwapBehavior);
+    }
+    BlitTest::teardown();
+}
+
+std::string PartialUpdateTest::name() const
+{
+    std::stringstream s;
+
+    s << "partial_";
+    switch (m_method)
+    {
+    case PARTIAL_FULL:
+        s << "full";
+        return s.str();
+    case PARTIAL_BUFFER_AGE:
+        s << "age";
+        break;
+    case PARTIAL_SWAP_DAMAGE:
+        s << "swapdamage";
+        break;
+    case PARTIAL_UPDATE:
+        s << "update";
+        break;
+    case PARTIAL_PRESERVED:
+        s << "preserved";
+        break;
+    }
+    s << "_" << static_cast<int>(m_damage * 100.0f + 0.5f) << "pct";
+
+    return s.str();
+}
+
+std::string PartialUpdateTest::baselineName() const
+{
+    if (m_method == PARTIAL_FULL)
+    {
+        return "";
+    }
+    return "partial_full";
+}
+
+std::string PartialUpdateTest::statistics() const
+{
+    char buf[32];
+
+    if (!m_frames)
+    {
+        return "";
+    }
+    snprintf(buf, sizeof(buf), "repainted %5.1f%%",
+             100.0f * m_repaintedPixels / (m_frames * m_surfaceWidth * m_surfaceHeight));
+    return buf;
+}
@@ -0,0 +1,76 @@
+/**
+ * OpenGL ES 2.0 memory performance estimator
+ * Copyright (C) 2012 Google
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * \author Sami Kyöstilä <skyostil@google.com>
+ *
+ * Partial screen update test
+ */
+#ifndef PARTIALUPDATETEST_H
+#define PARTIALUPDATETEST_H
+
+#include "blittest.h"
+#include "ext.h"
+
+enum PartialUpdateMethod
+{
+    PARTIAL_FULL,               //< Redraw and swap the whole screen
+    PARTIAL_BUFFER_AGE,         //< Redraw regions invalidated since the buffer was last used
+    PARTIAL_SWAP_DAMAGE,        //< Buffer age with eglSwapBuffersWithDamage
+    PARTIAL_UPDATE,             //< Buffer age with eglSetDamageRegionKHR and swap with damage
+    PARTIAL_PRESERVED,          //< Redraw only the damage over a preserved back buffer
+};
+
+/** Number of past frames whose damage is remembered */
+#define PARTIAL_UPDATE_HISTORY 8
+
+class PartialUpdateTest: public BlitTest
+{
+protected:
+    PartialUpdateMethod m_method;
+    float m_damage;
+    int m_surfaceWidth, m_surfaceHeight;
+    int m_damageWidth, m_damageHeight;
+    EGLint m_history[PARTIAL_UPDATE_HISTORY][4];
+    int m_historySize;
+    int64_t m_repaintedPixels;
+    int64_t m_frames;
+    EGLint m_savedSwapBehavior;
+
+    PFNEGLSETDAMAGEREGIONKHRPROC m_eglSetDamageRegion;
+
+public:
+    /**
+     *  @param method           Update method
+     *  @param damage           Fraction of the screen area changed every frame
+     */
+    PartialUpdateTest(PartialUpdateMethod method, float damage);
+
+    std::string unsupportedReason() const;
+    void prepare();
+    void operator()(int frame);
+    void teardown();
+    std::string name() const;
+    std::string baselineName() const;
+    std::string statistics() const;
+
+protected:
+    void damageRect(int frame, EGLint* rect) const;
+    void repaintRect(int age, EGLint* rect) const;
+};
+
+#endif // PARTIALUPDATETEST_H
@@ -55,23 +55,27 @@ PixmapBlitTest::PixmapBlitTest(int width, int height, EGLConfig config,
     eglGetConfigAttrib(ctx.dpy, m_config, EGL_BUFFER_SIZE, &m_depth);
 }
 
-void PixmapBlitTest::prepare()
+std::string PixmapBlitTest::unsupportedReason() const
 {
     if (!isEGLExtensionSupported("EGL_KHR_image_pixmap"))
     {
-        fail("EGL_KHR_image_pixmap not supported");
+        return "EGL_KHR_image_pixmap not supported";
     }
 
     if (!isGLExtensionSupported("GL_OES_EGL_image"))
     {
-        fail("GL_OES_EGL_image not supported");
+        return "GL_OES_EGL_image not supported";
     }
 
     if (!m_config)
     {
-        fail("Config not found");
+        return "Config not found";
     }
+    return "";
+}
 
+void PixmapBlitTest::prepare()
+{
     eglCreateImageKHR =
         (PFNEGLCREATEIMAGEKHRPROC)eglGetProcAddress("eglCreateImageKHR");
     eglDestroyImageKHR =
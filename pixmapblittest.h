@@ -44,6 +44,7 @@ public:
     PixmapBlitTest(int width, int height, EGLConfig config,
                    bool rotate = false, float texW = 1.0f, float texH = 1.0f);
 
+    std::string unsupportedReason() const;
     void prepare();
     std::string name() const;
     void teardown();
@@ -0,0 +1,372 @@
+/**
+ * OpenGL ES 2.0 memory performance estimator
+ * Copyright (C) 2012 Google
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * \author Sami Kyöstilä <skyostil@google.com>
+ *
+ * Pixel readback test
+ */
+#include "readbacktest.h"
+#include "util.h"
+
+#include <algorithm>
+#include <sstream>
+#include <string.h>
+
+static const GLuint64 fenceTimeout = 1000 * 1000 * 1000ULL;
+
+ReadbackTest::ReadbackTest(ReadbackSource source, ReadbackMode mode, GLenum format,
+                           GLenum type, int width, int height):
+    m_source(source),
+    m_mode(mode),
+    m_format(format),
+    m_type(type),
+    m_width(width),
+    m_height(height),
+    m_readWidth(0),
+    m_readHeight(0),
+    m_bytes(0),
+    m_framebuffer(0),
+    m_texture(0),
+    m_frames(0),
+    m_completed(0),
+    m_timeouts(0),
+    m_issueTime(0),
+    m_stallTime(0),
+    m_mapTime(0),
+    m_glMapBufferRange(0),
+    m_glUnmapBuffer(0),
+    m_glFenceSync(0),
+    m_glClientWaitSync(0),
+    m_glDeleteSync(0)
+{
+    for (int i = 0; i < READBACK_PBO_COUNT; i++)
+    {
+        m_buffers[i] = 0;
+        m_fences[i] = 0;
+    }
+}
+
+std::string ReadbackTest::unsupportedReason() const
+{
+    if (m_format == GL_BGRA_EXT && !isGLExtensionSupported("GL_EXT_read_format_bgra"))
+    {
+        return "GL_EXT_read_format_bgra not supported";
+    }
+    if (m_mode == READBACK_PBO && glesVersion() < 3)
+    {
+        return "OpenGL ES 3.0 not supported";
+    }
+    if (!isReadFormatSupported())
+    {
+        return "Read format not supported by the framebuffer";
+    }
+    return Test::unsupportedReason();
+}
+
+bool ReadbackTest::isReadFormatSupported() const
+{
+    GLint readFormat = 0, readType = 0;
+    GLuint framebuffer = 0, texture = 0;
+
+    // RGBA8888 can always be read
+    if ((m_format == GL_RGBA || m_format == GL_BGRA_EXT) && m_type == GL_UNSIGNED_BYTE)
+    {
+        return true;
+    }
+
+    // Anything else has to match the format the implementation prefers for
+    // the framebuffer, so query it from a small framebuffer of the same kind
+    if (m_source == READBACK_FBO)
+    {
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexImage2D(GL_TEXTURE_2D, 0, m_format, 16, 16, 0, m_format, m_type, 0);
+        glGenFramebuffers(1, &framebuffer);
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, 0);
+    }
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE)
+    {
+        glGetIntegerv(GL_IMPLEMENTATION_COLOR_READ_FORMAT, &readFormat);
+        glGetIntegerv(GL_IMPLEMENTATION_COLOR_READ_TYPE, &readType);
+    }
+    if (m_source == READBACK_FBO)
+    {
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glDeleteFramebuffers(1, &framebuffer);
+        glDeleteTextures(1, &texture);
+    }
+    glGetError();
+
+    return m_format == (GLenum)readFormat && m_type == (GLenum)readType;
+}
+
+void ReadbackTest::prepareFramebuffer(int width, int height)
+{
+    // BGRA is a conversion done during the read, so it is read from RGBA
+    GLenum format = (m_format == GL_BGRA_EXT) ? GL_RGBA : m_format;
+
+    glGenTextures(1, &m_texture);
+    glBindTexture(GL_TEXTURE_2D, m_texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, m_type, 0);
+    ASSERT_GL();
+
+    glGenFramebuffers(1, &m_framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_texture, 0);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    {
+        // teardown() is not called for a test that fails to prepare
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glDeleteFramebuffers(1, &m_framebuffer);
+        glDeleteTextures(1, &m_texture);
+        m_framebuffer = 0;
+        m_texture = 0;
+        fail("Framebuffer format not supported");
+    }
+    ASSERT_GL();
+}
+
+void ReadbackTest::preparePixelBuffers()
+{
+    m_glMapBufferRange = (PFNGLMAPBUFFERRANGEPROC)eglGetProcAddress("glMapBufferRange");
+    m_glUnmapBuffer = (PFNGLUNMAPBUFFERPROC)eglGetProcAddress("glUnmapBuffer");
+    m_glFenceSync = (PFNGLFENCESYNCPROC)eglGetProcAddress("glFenceSync");
+    m_glClientWaitSync = (PFNGLCLIENTWAITSYNCPROC)eglGetProcAddress("glClientWaitSync");
+    m_glDeleteSync = (PFNGLDELETESYNCPROC)eglGetProcAddress("glDeleteSync");
+    ASSERT(m_glMapBufferRange && m_glUnmapBuffer);
+    ASSERT(m_glFenceSync && m_glClientWaitSync && m_glDeleteSync);
+
+    glGenBuffers(READBACK_PBO_COUNT, m_buffers);
+    for (int i = 0; i < READBACK_PBO_COUNT; i++)
+    {
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, m_buffers[i]);
+        glBufferData(GL_PIXEL_PACK_BUFFER, m_bytes, 0, GL_STREAM_READ);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    ASSERT_GL();
+}
+
+void ReadbackTest::prepare()
+{
+    GLint surfaceWidth, surfaceHeight;
+
+    eglQuerySurface(ctx.dpy, ctx.surface, EGL_WIDTH, &surfaceWidth);
+    eglQuerySurface(ctx.dpy, ctx.surface, EGL_HEIGHT, &surfaceHeight);
+    ASSERT_EGL();
+
+    // The requested size is kept for name()
+    m_readWidth = std::min(m_width, surfaceWidth);
+    m_readHeight = std::min(m_height, surfaceHeight);
+
+    if (m_source == READBACK_FBO)
+    {
+        prepareFramebuffer(surfaceWidth, surfaceHeight);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    }
+
+    m_bytes = m_readWidth * m_readHeight * ((m_type == GL_UNSIGNED_BYTE) ? 4 : 2);
+    m_pixels.resize(m_bytes);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+
+    if (m_mode == READBACK_PBO)
+    {
+        preparePixelBuffers();
+    }
+    ASSERT_GL();
+}
+
+void ReadbackTest::readSync()
+{
+    struct timespec start, end;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    glReadPixels(0, 0, m_readWidth, m_readHeight, m_format, m_type, &m_pixels[0]);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    // A synchronous read waits for rendering and copies in the same call
+    m_stallTime += timeDiff(start, end);
+    m_completed++;
+}
+
+void ReadbackTest::readAsync(int slot)
+{
+    struct timespec start, end;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, m_buffers[slot]);
+    glReadPixels(0, 0, m_readWidth, m_readHeight, m_format, m_type, 0);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    m_fences[slot] = m_glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    m_issueTime += timeDiff(start, end);
+}
+
+void ReadbackTest::finishRead(int slot)
+{
+    struct timespec start, wait, end;
+
+    if (!m_fences[slot])
+    {
+        return;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    GLenum result = m_glClientWaitSync(m_fences[slot], GL_SYNC_FLUSH_COMMANDS_BIT, fenceTimeout);
+    m_glDeleteSync(m_fences[slot]);
+    m_fences[slot] = 0;
+    clock_gettime(CLOCK_MONOTONIC, &wait);
+    m_stallTime += timeDiff(start, wait);
+
+    // Throwing here would abort the whole run, so a read that doesn't
+    // finish in time is only counted and left out of the throughput
+    if (result == GL_TIMEOUT_EXPIRED || result == GL_WAIT_FAILED)
+    {
+        m_timeouts++;
+        return;
+    }
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, m_buffers[slot]);
+    const void* data = m_glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, m_bytes, GL_MAP_READ_BIT);
+    ASSERT(data);
+    memcpy(&m_pixels[0], data, m_bytes);
+    m_glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    m_mapTime += timeDiff(wait, end);
+    m_completed++;
+}
+
+void ReadbackTest::operator()(int frame)
+{
+    if (frame == 0)
+    {
+        m_frames = 0;
+        m_completed = 0;
+        m_timeouts = 0;
+        m_issueTime = 0;
+        m_stallTime = 0;
+        m_mapTime = 0;
+    }
+
+    if (m_framebuffer)
+    {
+        glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    }
+    glClearColor((frame & 1) * 1.0f, (frame & 2) * 0.5f, (frame & 4) * 0.25f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    if (m_mode == READBACK_SYNC)
+    {
+        readSync();
+    }
+    else
+    {
+        // The oldest read in the ring is consumed before its buffer is reused
+        // for the new one
+        int slot = m_frames % READBACK_PBO_COUNT;
+        finishRead(slot);
+        readAsync(slot);
+    }
+    m_frames++;
+
+    if (m_framebuffer)
+    {
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    }
+}
+
+void ReadbackTest::teardown()
+{
+    if (m_mode == READBACK_PBO)
+    {
+        for (int i = 0; i < READBACK_PBO_COUNT; i++)
+        {
+            if (m_fences[i])
+            {
+                m_glDeleteSync(m_fences[i]);
+                m_fences[i] = 0;
+            }
+        }
+        glDeleteBuffers(READBACK_PBO_COUNT, m_buffers);
+    }
+    if (m_framebuffer)
+    {
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glDeleteFramebuffers(1, &m_framebuffer);
+        glDeleteTextures(1, &m_texture);
+        m_framebuffer = 0;
+        m_texture = 0;
+    }
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    m_pixels.clear();
+    ASSERT_GL();
+}
+
+std::string ReadbackTest::name() const
+{
+    std::stringstream s;
+
+    s << "readback_" << ((m_mode == READBACK_SYNC) ? "sync" : "pbo");
+    s << "_" << ((m_source == READBACK_WINDOW) ? "window" : "fbo");
+    s << "_" << textureFormatName(m_format, m_type);
+    s << "_" << m_width << "x" << m_height;
+    return s.str();
+}
+
+bool ReadbackTest::capturesWindow() const
+{
+    return m_source == READBACK_WINDOW;
+}
+
+std::string ReadbackTest::statistics() const
+{
+    char buf[160];
+    int64_t total = m_issueTime + m_stallTime + m_mapTime;
+    int n = 0;
+
+    buf[0] = 0;
+    if (m_timeouts)
+    {
+        n = snprintf(buf, sizeof(buf), "%d read%s timed out ", m_timeouts,
+                     (m_timeouts > 1) ? "s" : "");
+    }
+    if (!m_frames || !m_completed || total <= 0)
+    {
+        return buf;
+    }
+
+    float ms = 1000.0f * 1000.0f * m_frames;
+    float mbs = (1000.0 * 1000.0 * 1000.0 * m_bytes * m_completed) / (total * 1024.0 * 1024.0);
+    if (m_mode == READBACK_SYNC)
+    {
+        snprintf(buf + n, sizeof(buf) - n, "readback %8.1f MB/s stall %5.2f ms ",
+                 mbs, m_stallTime / ms);
+    }
+    else
+    {
+        snprintf(buf + n, sizeof(buf) - n,
+                 "readback %8.1f MB/s issue %5.2f ms stall %5.2f ms map %5.2f ms ",
+                 mbs, m_issueTime / ms, m_stallTime / ms, m_mapTime / ms);
+    }
+    return buf;
+}
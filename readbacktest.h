@@ -0,0 +1,109 @@
+/**
+ * OpenGL ES 2.0 memory performance estimator
+ * Copyright (C) 2012 Google
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * \author Sami Kyöstilä <skyostil@google.com>
+ *
+ * Pixel readback test
+ */
+#ifndef READBACKTEST_H
+#define READBACKTEST_H
+
+#include "test.h"
+#include "ext.h"
+#include <GLES2/gl2.h>
+#include <vector>
+
+enum ReadbackSource
+{
+    READBACK_WINDOW,            //< Window surface
+    READBACK_FBO,               //< Texture backed framebuffer object
+};
+
+enum ReadbackMode
+{
+    READBACK_SYNC,              //< glReadPixels into client memory
+    READBACK_PBO,               //< glReadPixels into a pixel pack buffer, mapped frames later
+};
+
+const int READBACK_PBO_COUNT = 3;
+
+/**
+ *  Renders a frame and reads a region of it back to client memory. The
+ *  asynchronous mode cycles through a ring of pixel pack buffers, waiting on
+ *  a fence and mapping each buffer READBACK_PBO_COUNT frames after the read
+ *  was issued. Only the time spent in the readback path is used for the
+ *  reported throughput.
+ */
+class ReadbackTest: public Test
+{
+protected:
+    ReadbackSource m_source;
+    ReadbackMode m_mode;
+    GLenum m_format, m_type;
+    int m_width, m_height;
+    int m_readWidth, m_readHeight;  //< Read region clamped to the surface
+    int m_bytes;
+
+    GLuint m_framebuffer, m_texture;
+    GLuint m_buffers[READBACK_PBO_COUNT];
+    GLsync m_fences[READBACK_PBO_COUNT];
+    std::vector<char> m_pixels;
+
+    int m_frames;
+    int m_completed;
+    int m_timeouts;
+    int64_t m_issueTime;
+    int64_t m_stallTime;
+    int64_t m_mapTime;
+
+    PFNGLMAPBUFFERRANGEPROC m_glMapBufferRange;
+    PFNGLUNMAPBUFFERPROC m_glUnmapBuffer;
+    PFNGLFENCESYNCPROC m_glFenceSync;
+    PFNGLCLIENTWAITSYNCPROC m_glClientWaitSync;
+    PFNGLDELETESYNCPROC m_glDeleteSync;
+
+public:
+    /**
+     *  @param source           Surface to read from
+     *  @param mode             Synchronous or asynchronous readback
+     *  @param format           Pixel format
+     *  @param type             Pixel type
+     *  @param width            Width of the read region, clamped to the surface
+     *  @param height           Height of the read region, clamped to the surface
+     */
+    ReadbackTest(ReadbackSource source, ReadbackMode mode, GLenum format, GLenum type,
+                 int width, int height);
+
+    std::string unsupportedReason() const;
+    void prepare();
+    void operator()(int frame);
+    void teardown();
+    std::string name() const;
+    std::string statistics() const;
+    bool capturesWindow() const;
+
+protected:
+    bool isReadFormatSupported() const;
+    void prepareFramebuffer(int width, int height);
+    void preparePixelBuffers();
+    void readSync();
+    void readAsync(int slot);
+    void finishRead(int slot);
+};
+
+#endif // READBACKTEST_H
@@ -0,0 +1,206 @@
+/**
+ * OpenGL ES 2.0 memory performance estimator
+ * Copyright (C) 2012 Google
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * \author Sami Kyöstilä <skyostil@google.com>
+ *
+ * Reference frame capture and validation
+ */
+#include "reference.h"
+#include "util.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+static const char* indexName = "reference.txt";
+
+uint32_t crc32(const void* data, size_t size, uint32_t crc)
+{
+    static uint32_t table[256];
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+
+    if (!table[1])
+    {
+        for (uint32_t i = 0; i < 256; i++)
+        {
+            uint32_t c = i;
+            for (int j = 0; j < 8; j++)
+            {
+                c = (c & 1) ? (0xedb88320 ^ (c >> 1)) : (c >> 1);
+            }
+            table[i] = c;
+        }
+    }
+
+    crc = ~crc;
+    while (size--)
+    {
+        crc = table[(crc ^ *p++) & 0xff] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+ReferenceFrames::ReferenceFrames():
+    m_width(0),
+    m_height(0),
+    m_crc(0)
+{
+}
+
+std::string ReferenceFrames::indexFileName() const
+{
+    return m_dir + "/" + indexName;
+}
+
+std::string ReferenceFrames::imageFileName(const std::string& testName) const
+{
+    return m_dir + "/" + testName + ".raw";
+}
+
+bool ReferenceFrames::open(const std::string& dir, bool create)
+{
+    char name[256];
+    Entry entry;
+
+    m_dir = dir;
+    m_entries.clear();
+
+    if (create && mkdir(dir.c_str(), 0755) == -1 && errno != EEXIST)
+    {
+        perror("mkdir");
+        return false;
+    }
+
+    FILE* f = fopen(indexFileName().c_str(), "r");
+    if (!f)
+    {
+        return create;
+    }
+    while (fscanf(f, "%255s %d %d %x", name, &entry.width, &entry.height, &entry.crc) == 4)
+    {
+        m_entries[name] = entry;
+    }
+    fclose(f);
+    return true;
+}
+
+bool ReferenceFrames::saveIndex() const
+{
+    std::map<std::string, Entry>::const_iterator i;
+    FILE* f = fopen(indexFileName().c_str(), "w");
+
+    if (!f)
+    {
+        perror("fopen");
+        return false;
+    }
+    for (i = m_entries.begin(); i != m_entries.end(); ++i)
+    {
+        fprintf(f, "%s %d %d %08x\n", i->first.c_str(), i->second.width, i->second.height,
+                i->second.crc);
+    }
+    fclose(f);
+    return true;
+}
+
+void ReferenceFrames::capture()
+{
+    GLint framebuffer = 0;
+
+    eglQuerySurface(ctx.dpy, ctx.surface, EGL_WIDTH, &m_width);
+    eglQuerySurface(ctx.dpy, ctx.surface, EGL_HEIGHT, &m_height);
+    m_pixels.resize(m_width * m_height * 4);
+
+    // Tests may keep their own framebuffer bound between frames
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glReadPixels(0, 0, m_width, m_height, GL_RGBA, GL_UNSIGNED_BYTE, &m_pixels[0]);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    ASSERT_GL();
+
+    m_crc = crc32(&m_pixels[0], m_pixels.size());
+}
+
+bool ReferenceFrames::store(const std::string& testName)
+{
+    FILE* f = fopen(imageFileName(testName).c_str(), "wb");
+
+    if (!f)
+    {
+        perror("fopen");
+        return false;
+    }
+    if (fwrite(&m_pixels[0], m_pixels.size(), 1, f) != 1)
+    {
+        perror("fwrite");
+        fclose(f);
+        return false;
+    }
+    fclose(f);
+
+    Entry& entry = m_entries[testName];
+    entry.width = m_width;
+    entry.height = m_height;
+    entry.crc = m_crc;
+    return saveIndex();
+}
+
+ReferenceResult ReferenceFrames::check(const std::string& testName, int tolerance,
+                                       int& badPixels)
+{
+    std::map<std::string, Entry>::const_iterator i = m_entries.find(testName);
+
+    badPixels = -1;
+    if (i == m_entries.end())
+    {
+        return REFERENCE_MISSING;
+    }
+    if (i->second.width != m_width || i->second.height != m_height)
+    {
+        return REFERENCE_MISMATCH;
+    }
+    if (i->second.crc == m_crc)
+    {
+        badPixels = 0;
+        return REFERENCE_MATCH;
+    }
+
+    // Count the differing pixels if the image itself is available
+    struct stat st;
+    if (stat(imageFileName(testName).c_str(), &st) == -1 ||
+        !loadFile(imageFileName(testName), m_reference) || m_reference.size() != m_pixels.size())
+    {
+        return REFERENCE_MISMATCH;
+    }
+
+    const unsigned char* ref = reinterpret_cast<const unsigned char*>(&m_reference[0]);
+    badPixels = 0;
+    for (size_t p = 0; p < m_pixels.size(); p += 4)
+    {
+        for (int c = 0; c < 4; c++)
+        {
+            if (abs(m_pixels[p + c] - ref[p + c]) > tolerance)
+            {
+                badPixels++;
+                break;
+            }
+        }
+    }
+    return badPixels ? REFERENCE_MISMATCH : REFERENCE_WITHIN_TOLERANCE;
+}
@@ -0,0 +1,118 @@
+/**
+ * OpenGL ES 2.0 memory performance estimator
+ * Copyright (C) 2012 Google
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * \author Sami Kyöstilä <skyostil@google.com>
+ *
+ * Reference frame capture and validation
+ */
+#ifndef REFERENCE_H
+#define REFERENCE_H
+
+#include <map>
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ *  Outcome of comparing a frame with its reference
+ */
+enum ReferenceResult
+{
+    REFERENCE_MISSING,          //< No reference stored for the test
+    REFERENCE_MATCH,            //< Identical checksum
+    REFERENCE_WITHIN_TOLERANCE, //< Differences within the allowed tolerance
+    REFERENCE_MISMATCH,         //< Different size or pixels over the tolerance
+};
+
+/**
+ *  Compute a CRC-32 checksum
+ *
+ *  @param data                 Data to checksum
+ *  @param size                 Size of the data in bytes
+ *  @param crc                  Checksum of the preceding data, if any
+ */
+uint32_t crc32(const void* data, size_t size, uint32_t crc = 0);
+
+/**
+ *  A directory of reference frames. Each frame is stored as a raw RGBA8888
+ *  image named after its test, with the bottom row first. The checksums and
+ *  sizes of all frames are listed in an index file in the same directory,
+ *  one "<test> <width> <height> <crc>" line per frame.
+ */
+class ReferenceFrames
+{
+public:
+    ReferenceFrames();
+
+    /**
+     *  Select the directory holding the reference frames and load its index
+     *
+     *  @param dir              Reference directory
+     *  @param create           Create the directory if it does not exist
+     *
+     *  @returns true on success, false if no index could be loaded when
+     *  not creating
+     */
+    bool open(const std::string& dir, bool create);
+
+    /**
+     *  Read back the contents of the current window surface. The pixels are
+     *  kept in a buffer that is reused for every frame.
+     */
+    void capture();
+
+    /**
+     *  Store the most recently captured frame as the reference of a test
+     *
+     *  @param testName         Test name
+     *
+     *  @returns true on success, false on failure
+     */
+    bool store(const std::string& testName);
+
+    /**
+     *  Compare the most recently captured frame with the reference of a test
+     *
+     *  @param testName         Test name
+     *  @param tolerance        Largest allowed difference of a color channel
+     *  @param badPixels        Output: number of pixels over the tolerance,
+     *                          or -1 if the reference image is unavailable
+     */
+    ReferenceResult check(const std::string& testName, int tolerance, int& badPixels);
+
+protected:
+    struct Entry
+    {
+        int width, height;
+        uint32_t crc;
+    };
+
+    std::string m_dir;
+    std::map<std::string, Entry> m_entries;
+    std::vector<unsigned char> m_pixels;
+    std::vector<char> m_reference;
+    int m_width, m_height;
+    uint32_t m_crc;
+
+    std::string indexFileName() const;
+    std::string imageFileName(const std::string& testName) const;
+    bool saveIndex() const;
+};
+
+#endif // REFERENCE_H
@@ -29,15 +29,34 @@
 #include <unistd.h>
 #include <time.h>
 #include <list>
+#include <map>
+#include <algorithm>
 
 #include "native.h"
 #include "util.h"
+#include "bandwidth.h"
+#include "memory.h"
 #include "test.h"
 #include "blittest.h"
+#include "blendtest.h"
 #include "cleartest.h"
+#include "cliptest.h"
+#include "compositortest.h"
+#include "contextswitchtest.h"
 #include "fboblittest.h"
+#include "fbochaintest.h"
 #include "shaderblittest.h"
+#include "texturechurntest.h"
+#include "texturethrashtest.h"
+#include "texttest.h"
+#include "tracetest.h"
+#include "blurtest.h"
+#include "multisampletest.h"
+#include "partialupdatetest.h"
+#include "pacingtest.h"
+#include "readbacktest.h"
 #include "cpuinterleavingtest.h"
+#include "videotest.h"
 #include "ext.h"
 
 #include <android_native_app_glue.h>
@@ -49,7 +68,8 @@ class AppContext
 public:
     AppContext(android_app* app):
         app(app),
-        frameCount(0)
+        frameCount(0),
+        cpuBandwidth(0)
     {
     }
 
@@ -58,6 +78,9 @@ public:
     TestList::iterator currentTest;
     int frameCount;
     struct timespec startTime;
+    MemoryUsage memStart, memPrepared;
+    std::map<std::string, int64_t> frameTimes;
+    double cpuBandwidth;
 };
 
 /** Shared EGL objects */
@@ -76,6 +99,16 @@ static bool render(AppContext* appContext)
 
     if (appContext->frameCount == 0)
     {
+        std::string reason = test->unsupportedReason();
+        if (!reason.empty())
+        {
+            LOGI("%-40s skipped: %s", (test->name() + ":").c_str(), reason.c_str());
+            appContext->currentTest++;
+            return false;
+        }
+
+        resetPeakMemory();
+        appContext->memStart = sampleMemory();
         try
         {
             test->prepare();
@@ -91,6 +124,7 @@ static bool render(AppContext* appContext)
             appContext->currentTest++;
             return false;
         }
+        appContext->memPrepared = sampleMemory();
     }
 
     const int warmUp = 20;
@@ -115,9 +149,47 @@ static bool render(AppContext* appContext)
     if (elapsed > minTime)
     {
         int fps = static_cast<int>((1000 * 1000 * 1000LL * actualFrameCount) / elapsed);
-        LOGI("%-40s %3d fps", (test->name() + ":").c_str(), fps);
+        int64_t frameTime = elapsed / actualFrameCount;
+        std::map<std::string, int64_t>::const_iterator baseline =
+            appContext->frameTimes.find(test->baselineName());
+        int64_t bytes = test->bytesPerFrame();
+        char bandwidth[48] = "", ratio[16] = "";
+
+        if (bytes)
+        {
+            double bytesPerSecond = (1000 * 1000 * 1000.0 * bytes) / frameTime;
+            int n = snprintf(bandwidth, sizeof(bandwidth), " %8.1f MB/s",
+                             bytesPerSecond / (1024.0 * 1024.0));
+            if (appContext->cpuBandwidth > 0)
+            {
+                snprintf(bandwidth + n, sizeof(bandwidth) - n, " %5.1f%%",
+                         100.0 * bytesPerSecond / appContext->cpuBandwidth);
+            }
+        }
+        if (baseline != appContext->frameTimes.end())
+        {
+            snprintf(ratio, sizeof(ratio), " %5.2fx", (float)frameTime / baseline->second);
+        }
+        std::string stats = test->statistics();
+        if (stats.size())
+        {
+            stats = " " + stats;
+        }
 
+        MemoryUsage memFinished = sampleMemory();
         test->teardown();
+        std::string memory = memorySummary(appContext->memStart, appContext->memPrepared,
+                                           memFinished, sampleMemory());
+        if (memory.size())
+        {
+            memory = " " + memory;
+        }
+
+        LOGI("%-40s %3d fps %7.2f ms%s%s%s%s", (test->name() + ":").c_str(), fps,
+             frameTime / (1000.0f * 1000.0f), bandwidth, ratio, stats.c_str(),
+             memory.c_str());
+        appContext->frameTimes[test->name()] = frameTime;
+
         appContext->frameCount = 0;
         appContext->currentTest++;
     }
@@ -139,6 +211,22 @@ static void initializeTests(AppContext* appContext)
     eglQuerySurface(ctx.dpy, ctx.surface, EGL_WIDTH, &winWidth);
     eglQuerySurface(ctx.dpy, ctx.surface, EGL_HEIGHT, &winHeight);
 
+    // CPU memory bandwidth as a reference point for the tests
+    const size_t bandwidthArraySize = 32 * 1024 * 1024;
+    BandwidthResult bandwidth = measureBandwidth(bandwidthArraySize, 1);
+    appContext->cpuBandwidth = peakBandwidth(bandwidth);
+    LOGI("CPU memory bandwidth %s", bandwidthSummary(bandwidth).c_str());
+    if (cpuCount() > 1)
+    {
+        bandwidth = measureBandwidth(bandwidthArraySize, cpuCount());
+        appContext->cpuBandwidth = std::max(appContext->cpuBandwidth, peakBandwidth(bandwidth));
+        LOGI("CPU memory bandwidth %s", bandwidthSummary(bandwidth).c_str());
+    }
+
+    std::vector<int> thrashPercents;
+    parseThrashPercents(TEXTURE_THRASH_DEFAULT_PERCENTS, thrashPercents);
+    const int displayRefreshRate = PACING_DEFAULT_REFRESH_RATE;
+
     LOGI("Initializing tests");
 
 #define ADD_TEST(TEST) appContext->tests.push_back(new TEST);
@@ -158,13 +246,7 @@ static bool initializeEgl(AppContext* appContext)
         EGL_NONE
     };
 
-    const EGLint contextAttrs[] =
-    {
-        EGL_CONTEXT_CLIENT_VERSION, 2,
-        EGL_NONE
-    };
-
-    EGLint configCount = 0;
+    int clientVersion;
 
     LOGI("Initializing EGL");
     ctx.assetManager = appContext->app->activity->assetManager;
@@ -172,10 +254,10 @@ static bool initializeEgl(AppContext* appContext)
     ASSERT_EGL();
 
     eglInitialize(ctx.dpy, NULL, NULL);
-    eglChooseConfig(ctx.dpy, configAttrs, &ctx.config, 1, &configCount);
+    clientVersion = chooseConfig(ctx.dpy, configAttrs, &ctx.config);
     ASSERT_EGL();
 
-    if (!configCount)
+    if (!clientVersion)
     {
         LOGW("Config not found");
         goto out_error;
@@ -190,7 +272,7 @@ static bool initializeEgl(AppContext* appContext)
 
     ANativeWindow_setBuffersGeometry(appContext->app->window, 0, 0, format);
 
-    ctx.context = eglCreateContext(ctx.dpy, ctx.config, EGL_NO_CONTEXT, contextAttrs);
+    ctx.context = createContext(ctx.dpy, ctx.config, clientVersion);
     ASSERT_EGL();
     if (!ctx.context)
     {
@@ -211,6 +293,7 @@ static bool initializeEgl(AppContext* appContext)
 
     eglSwapInterval(ctx.dpy, 0);
     ASSERT_EGL();
+    LOGI("Synchronization: %s", syncModeName(syncMode()).c_str());
     initializeTests(appContext);
 
     return true;
@@ -225,6 +308,7 @@ out_error:
 
 void terminateEgl(AppContext*)
 {
+    setSyncMode(SYNC_SWAP);
     eglMakeCurrent(ctx.dpy, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
     eglDestroySurface(ctx.dpy, ctx.surface);
     eglDestroyContext(ctx.dpy, ctx.context);
@@ -29,17 +29,37 @@
 #include <time.h>
 #include <memory>
 #include <list>
+#include <map>
 #include <iostream>
 #include <algorithm>
 
 #include "native.h"
 #include "util.h"
+#include "bandwidth.h"
+#include "latencytracker.h"
+#include "memory.h"
+#include "reference.h"
 #include "test.h"
 #include "blittest.h"
+#include "blendtest.h"
 #include "cleartest.h"
+#include "cliptest.h"
+#include "compositortest.h"
+#include "contextswitchtest.h"
 #include "fboblittest.h"
+#include "fbochaintest.h"
 #include "shaderblittest.h"
+#include "texturechurntest.h"
+#include "texturethrashtest.h"
+#include "texttest.h"
+#include "tracetest.h"
+#include "blurtest.h"
+#include "multisampletest.h"
+#include "partialupdatetest.h"
+#include "pacingtest.h"
+#include "readbacktest.h"
 #include "cpuinterleavingtest.h"
+#include "videotest.h"
 #include "ext.h"
 
 #if defined(SUPPORT_X11)
@@ -65,20 +85,44 @@ static struct
     bool                   verbose;
     int                    minTime;
     bool                   listTests;
+    SyncMode               syncMode;
+    bool                   trackLatency;
+    bool                   trackMemory;
     std::list<std::string> includedTests;
     std::list<std::string> excludedTests;
+    std::string            referenceDir;
+    bool                   createReference;
+    int                    tolerance;
+    int                    bandwidthArraySize;
+    std::vector<int>       thrashPercents;
+    int                    refreshRate;
 } options;
 
 /** Shared EGL objects */
 struct Context ctx;
 
+/** Average frame time of each completed test in nanoseconds */
+static std::map<std::string, int64_t> frameTimes;
+
+/** Number of tests run and skipped due to missing capabilities */
+static int testsRun, testsSkipped;
+
+/** Best CPU memory bandwidth in bytes per second, or zero if not measured */
+static double cpuBandwidth;
+
+/** Reference frames used with -r and -c */
+static ReferenceFrames references;
+
+/** Number of tests whose output did not match or had no reference */
+static int testsMismatched, testsUnreferenced;
+
 #if defined(HAVE_LIBOSSO)
 osso_context_t* ossoContext;
 #endif
 
-bool initializeEgl(int width, int height, const EGLint* configAttrs, const EGLint* contextAttrs)
+bool initializeEgl(int width, int height, const EGLint* configAttrs)
 {
-    EGLint configCount = 0;
+    int clientVersion;
 
 #if defined(HAVE_LIBOSSO)
     ossoContext = osso_initialize("com.nokia.memperf", "1.0", FALSE, NULL);
@@ -92,10 +136,10 @@ bool initializeEgl(int width, int height, const EGLint* configAttrs, const EGLin
     ASSERT_EGL();
 
     eglInitialize(ctx.dpy, NULL, NULL);
-    eglChooseConfig(ctx.dpy, configAttrs, &ctx.config, 1, &configCount);
+    clientVersion = chooseConfig(ctx.dpy, configAttrs, &ctx.config);
     ASSERT_EGL();
 
-    if (!configCount)
+    if (!clientVersion)
     {
         printf("Config not found\n");
         goto out_error;
@@ -114,7 +158,7 @@ bool initializeEgl(int width, int height, const EGLint* configAttrs, const EGLin
         goto out_error;
     }
 
-    ctx.context = eglCreateContext(ctx.dpy, ctx.config, EGL_NO_CONTEXT, contextAttrs);
+    ctx.context = createContext(ctx.dpy, ctx.config, clientVersion);
     ASSERT_EGL();
     if (!ctx.context)
     {
@@ -148,6 +192,7 @@ out_error:
 
 void terminateEgl()
 {
+    setSyncMode(SYNC_SWAP);
     eglMakeCurrent(ctx.dpy, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
     eglDestroySurface(ctx.dpy, ctx.surface);
     eglDestroyContext(ctx.dpy, ctx.context);
@@ -194,6 +239,42 @@ bool shouldRunTest(const std::string& testName)
     return result;
 }
 
+void printReferenceResult(const std::string& testName)
+{
+    int badPixels;
+
+    if (options.createReference)
+    {
+        printf("ref %s ", references.store(testName) ? "stored" : "not stored");
+        return;
+    }
+
+    switch (references.check(testName, options.tolerance, badPixels))
+    {
+    case REFERENCE_MISSING:
+        printf("ref missing ");
+        testsUnreferenced++;
+        break;
+    case REFERENCE_MATCH:
+        printf("ref ok ");
+        break;
+    case REFERENCE_WITHIN_TOLERANCE:
+        printf("ref ok (tolerance) ");
+        break;
+    case REFERENCE_MISMATCH:
+        if (badPixels >= 0)
+        {
+            printf("ref MISMATCH (%d pixels) ", badPixels);
+        }
+        else
+        {
+            printf("ref MISMATCH ");
+        }
+        testsMismatched++;
+        break;
+    }
+}
+
 void runTest(Test& test)
 {
     int frames = 0;
@@ -201,15 +282,22 @@ void runTest(Test& test)
     int warmup = 20;
     int64_t minTime = options.minTime * 1000 * 1000 * 1000LL;
     struct timespec res, start, end;
+    LatencyTracker latency;
+    MemoryUsage memStart, memPrepared, memFinished, memEnd;
 
-    if (options.listTests)
+    if (!shouldRunTest(test.name()))
     {
-        printf("%s\n", test.name().c_str());
         return;
     }
 
-    if (!shouldRunTest(test.name()))
+    std::string reason = test.unsupportedReason();
+
+    if (options.listTests)
     {
+        if (reason.empty())
+        {
+            printf("%s\n", test.name().c_str());
+        }
         return;
     }
 
@@ -218,6 +306,20 @@ void runTest(Test& test)
     printf("%-40s", (test.name() + ":").c_str());
     fflush(stdout);
 
+    if (!reason.empty())
+    {
+        printf("skipped: %s\n", reason.c_str());
+        testsSkipped++;
+        return;
+    }
+    testsRun++;
+
+    if (options.trackMemory)
+    {
+        resetPeakMemory();
+        memStart = sampleMemory();
+    }
+
     try
     {
         test.prepare();
@@ -229,11 +331,23 @@ void runTest(Test& test)
         return;
     }
 
+    if (options.trackMemory)
+    {
+        memPrepared = sampleMemory();
+    }
+
     nativeVerifyWindow(ctx.nativeDisplay, ctx.win);
 
     while (warmup--)
     {
         test(0);
+
+        // The last warmup frame is read back so that validation stays out of
+        // the timed loop; its frame number is the same on every run
+        if (!warmup && !options.referenceDir.empty() && test.capturesWindow())
+        {
+            references.capture();
+        }
         swapBuffers();
     }
 
@@ -247,11 +361,20 @@ void runTest(Test& test)
     }
 #endif
 
+    if (options.trackLatency)
+    {
+        latency.start();
+    }
+
     clock_gettime(CLOCK_REALTIME, &start);
     while (frames < frameLimit)
     {
         test(frames);
         swapBuffers();
+        if (options.trackLatency)
+        {
+            latency.frame();
+        }
         clock_gettime(CLOCK_REALTIME, &end);
         frames++;
         if (frames >= frameLimit && timeDiff(start, end) < minTime)
@@ -260,17 +383,79 @@ void runTest(Test& test)
         }
     }
 
+    latency.stop();
     ASSERT_GL();
     ASSERT_EGL();
 
+    if (options.trackMemory)
+    {
+        memFinished = sampleMemory();
+    }
+
     test.teardown();
     ASSERT_GL();
     ASSERT_EGL();
 
+    if (options.trackMemory)
+    {
+        memEnd = sampleMemory();
+    }
+
     int64_t diff = timeDiff(start, end);
     int fps = static_cast<int>((1000 * 1000 * 1000LL * frames) / diff);
     //printf("%d frames in %6.2f ms (%3d fps) ", frames, diff / (1000.0f * 1000.0f), fps);
-    printf("%3d fps ", fps);
+    printf("%3d fps %7.2f ms ", fps, diff / (1000.0f * 1000.0f * frames));
+
+    int64_t bytes = test.bytesPerFrame();
+    if (bytes)
+    {
+        double bandwidth = (1000 * 1000 * 1000.0 * bytes * frames) / diff;
+        printf("%8.1f MB/s ", bandwidth / (1024.0 * 1024.0));
+        if (cpuBandwidth > 0)
+        {
+            printf("%5.1f%% ", 100.0 * bandwidth / cpuBandwidth);
+        }
+    }
+
+    frameTimes[test.name()] = diff / frames;
+    std::map<std::string, int64_t>::const_iterator baseline = frameTimes.find(test.baselineName());
+    if (baseline != frameTimes.end())
+    {
+        printf("%5.2fx ", (float)(diff / frames) / baseline->second);
+    }
+
+    std::string stats = test.statistics();
+    if (stats.size())
+    {
+        printf("%s ", stats.c_str());
+    }
+
+    stats = latency.summary();
+    if (stats.size())
+    {
+        printf("%s ", stats.c_str());
+    }
+
+    if (options.trackMemory)
+    {
+        stats = memorySummary(memStart, memPrepared, memFinished, memEnd);
+        if (stats.size())
+        {
+            printf("%s ", stats.c_str());
+        }
+    }
+
+    if (!options.referenceDir.empty())
+    {
+        if (test.capturesWindow())
+        {
+            printReferenceResult(test.name());
+        }
+        else
+        {
+            printf("ref offscreen ");
+        }
+    }
 
     while (fps > 0)
     {
@@ -298,11 +483,29 @@ void showUsage()
         "Options:\n"
         "       -h             This text\n"
         "       -v             Verbose mode\n"
-        "       -l             List all tests without running them\n"
+        "       -l             List supported tests without running them\n"
         "       -i TEST        Include a specific test (full name or substring)\n"
         "       -e TEST        Exclude a specific test (full name or substring)\n"
         "       -t SECS        Minimum time to run each test\n"
-        "       -b BPP         Bits per pixel\n";
+        "       -b BPP         Bits per pixel\n"
+        "       -s MODE        Frame synchronization: swap, finish, fence, readpixels\n"
+        "                      or offscreen\n"
+        "       -f             Measure GPU completion latency with fences\n"
+        "       -m             Track process and graphics memory usage; reported\n"
+        "                      as prepared/peak/residual growth per test\n"
+        "       -c DIR         Store the output of each test as a reference frame\n"
+        "                      in DIR\n"
+        "       -r DIR         Check the output of each test against the reference\n"
+        "                      frames in DIR\n"
+        "       -d DIFF        Largest color channel difference accepted by -r\n"
+        "                      (default: 0)\n"
+        "       -M MB          Size of each array used for measuring the CPU memory\n"
+        "                      bandwidth; 0 skips the measurement (default: 32)\n"
+        "       -p LIST        Comma separated texture set sizes of the texture\n"
+        "                      thrashing tests as percentages of system memory\n"
+        "                      (default: " TEXTURE_THRASH_DEFAULT_PERCENTS ")\n"
+        "       -R HZ          Display refresh rate used for the frame pacing\n"
+        "                      deadlines (default: " << PACING_DEFAULT_REFRESH_RATE << ")\n";
 }
 
 void parseArguments(const std::list<std::string>& args)
@@ -314,6 +517,14 @@ void parseArguments(const std::list<std::string>& args)
     options.minTime = 1;
     options.bitsPerPixel = 16;
     options.listTests = false;
+    options.syncMode = SYNC_SWAP;
+    options.trackLatency = false;
+    options.trackMemory = false;
+    options.createReference = false;
+    options.tolerance = 0;
+    options.bandwidthArraySize = 32;
+    parseThrashPercents(TEXTURE_THRASH_DEFAULT_PERCENTS, options.thrashPercents);
+    options.refreshRate = PACING_DEFAULT_REFRESH_RATE;
 
     for (i = args.begin(), i++; i != args.end(); ++i)
     {
@@ -338,6 +549,66 @@ void parseArguments(const std::list<std::string>& args)
         {
             options.bitsPerPixel = atoi((*i).c_str());
         }
+        else if (*i == "-s" && ++i != args.end())
+        {
+            if (!parseSyncMode(*i, options.syncMode))
+            {
+                std::cerr << "Invalid synchronization mode: " << *i << std::endl;
+                showUsage();
+                exit(1);
+            }
+        }
+        else if (*i == "-f")
+        {
+            options.trackLatency = true;
+        }
+        else if (*i == "-m")
+        {
+            options.trackMemory = true;
+        }
+        else if (*i == "-c" && ++i != args.end())
+        {
+            options.referenceDir = *i;
+            options.createReference = true;
+        }
+        else if (*i == "-r" && ++i != args.end())
+        {
+            options.referenceDir = *i;
+            options.createReference = false;
+        }
+        else if (*i == "-d" && ++i != args.end())
+        {
+            options.tolerance = atoi((*i).c_str());
+        }
+        else if (*i == "-M" && ++i != args.end())
+        {
+            options.bandwidthArraySize = atoi((*i).c_str());
+            if (options.bandwidthArraySize < 0)
+            {
+                std::cerr << "Invalid array size: " << *i << std::endl;
+                showUsage();
+                exit(1);
+            }
+        }
+        else if (*i == "-p" && ++i != args.end())
+        {
+            if (!parseThrashPercents(*i, options.thrashPercents))
+            {
+                std::cerr << "Invalid texture set sizes: " << *i << std::endl;
+                showUsage();
+                exit(1);
+            }
+        }
+        else if (*i == "-R" && ++i != args.end())
+        {
+            options.refreshRate = atoi((*i).c_str());
+            if (options.refreshRate <= 0)
+            {
+                std::cerr << "Invalid refresh rate: " << *i << std::endl;
+                showUsage();
+                exit(1);
+            }
+        }
         else if (*i == "-v")
         {
             options.verbose = true;
@@ -355,6 +626,51 @@ void parseArguments(const std::list<std::string>& args)
     }
 }
 
+/**
+ *  Open the reference frame directory given on the command line. Relative
+ *  paths are resolved before findDataDirectory() changes the working
+ *  directory.
+ */
+void openReferences()
+{
+    std::string dir = options.referenceDir;
+    char cwd[1024];
+
+    if (dir[0] != '/' && getcwd(cwd, sizeof(cwd)))
+    {
+        dir = std::string(cwd) + "/" + dir;
+    }
+
+    if (!references.open(dir, options.createReference))
+    {
+        std::cerr << "Unable to load reference frames from " << dir << std::endl;
+        exit(1);
+    }
+}
+
+/**
+ *  Measure the CPU memory bandwidth as a reference point for the bandwidth
+ *  reported by the tests
+ */
+void measureCpuBandwidth()
+{
+    size_t size = static_cast<size_t>(options.bandwidthArraySize) << 20;
+    BandwidthResult result;
+
+    printf("CPU memory bandwidth (3 x %d MB arrays):\n", options.bandwidthArraySize);
+    result = measureBandwidth(size, 1);
+    cpuBandwidth = peakBandwidth(result);
+    printf("    %s\n", bandwidthSummary(result).c_str());
+
+    if (cpuCount() > 1)
+    {
+        result = measureBandwidth(size, cpuCount());
+        cpuBandwidth = std::max(cpuBandwidth, peakBandwidth(result));
+        printf("    %s\n", bandwidthSummary(result).c_str());
+    }
+    printf("\n");
+}
+
 void findDataDirectory()
 {
     struct stat st;
@@ -372,12 +688,18 @@ int main(int argc, char** argv)
 
     showIntro();
     parseArguments(args);
+    if (!options.referenceDir.empty() && !options.listTests)
+    {
+        openReferences();
+    }
     findDataDirectory();
 
     const EGLint configAttrs[] =
     {
         EGL_BUFFER_SIZE, options.bitsPerPixel,
         EGL_RENDERABLE_TYPE, EGL_OPENGL_ES2_BIT,
+        EGL_SURFACE_TYPE, EGL_WINDOW_BIT |
+            (options.syncMode == SYNC_OFFSCREEN ? EGL_PBUFFER_BIT : 0),
         EGL_NONE
     };
 
@@ -387,11 +709,6 @@ int main(int argc, char** argv)
         EGL_NONE
     };
 
-    const EGLint contextAttrs[] =
-    {
-        EGL_CONTEXT_CLIENT_VERSION, 2,
-        EGL_NONE
-    };
     int winWidth = 800;
     int winHeight = 480;
     const float w = winWidth, h = winHeight;
@@ -402,9 +719,28 @@ int main(int argc, char** argv)
     ASSERT(result);
 
     nativeGetScreenSize(ctx.nativeDisplay, &winWidth, &winHeight);
-    result = initializeEgl(winWidth, winHeight, configAttrs, contextAttrs);
+    result = initializeEgl(winWidth, winHeight, configAttrs);
     ASSERT(result);
 
+    if (!setSyncMode(options.syncMode))
+    {
+        printf("Synchronization mode %s not supported\n", syncModeName(options.syncMode).c_str());
+        terminateEgl();
+        return 1;
+    }
+    printf("Synchronization: %s\n\n", syncModeName(syncMode()).c_str());
+
+    if (options.bandwidthArraySize > 0 && !options.listTests)
+    {
+        measureCpuBandwidth();
+    }
+
+    if (options.trackLatency && !isEGLExtensionSupported("EGL_KHR_fence_sync"))
+    {
+        printf("EGL_KHR_fence_sync not supported, not measuring latency\n\n");
+        options.trackLatency = false;
+    }
+
     eglChooseConfig(ctx.dpy, configAttrs32, &config32, 1, &configCount);
 
     if (!configCount)
@@ -415,9 +751,23 @@ int main(int argc, char** argv)
     glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
     ASSERT_GL();
 
+    const std::vector<int>& thrashPercents = options.thrashPercents;
+    const int displayRefreshRate = options.refreshRate;
+
 #define ADD_TEST(TEST) runTest(*std::auto_ptr<Test>(new TEST));
 #include "tests.inl"
 #undef ADD_TEST
 
+    if (!options.listTests)
+    {
+        printf("\n%d tests run, %d skipped\n", testsRun, testsSkipped);
+        if (!options.referenceDir.empty() && !options.createReference)
+        {
+            printf("%d reference mismatches, %d without reference\n",
+                   testsMismatched, testsUnreferenced);
+        }
+    }
+
     terminateEgl();
+    return testsMismatched ? 1 : 0;
 }
@@ -32,6 +32,7 @@ ShaderBlitTest::ShaderBlitTest(const std::string& effect, int width, int height,
                                float texW, float texH,
                                float quadW, float quadH):
     m_secondaryProgram(0),
+    m_paletteTexture(0),
     m_width(width),
     m_height(height),
     m_texW(texW),
@@ -51,8 +52,14 @@ void ShaderBlitTest::teardown()
     if (m_secondaryProgram)
     {
         glDeleteProgram(m_secondaryProgram);
+        glDeleteFramebuffers(2, m_framebuffers);
+        glDeleteTextures(2, m_fboTextures);
     }
     glDeleteTextures(1, &m_texture);
+    if (m_paletteTexture)
+    {
+        glDeleteTextures(1, &m_paletteTexture);
+    }
     glDisable(GL_BLEND);
     glViewport(m_savedViewport[0], m_savedViewport[1], m_savedViewport[2], m_savedViewport[3]);
 }
@@ -311,14 +318,15 @@ void ShaderBlitTest::prepare()
             palette[i * 4 + 2] = 0xff - i;
             palette[i * 4 + 3] = 0xff;
         }
+        glGenTextures(1, &m_paletteTexture);
         glActiveTexture(GL_TEXTURE1);
-        glBindTexture(GL_TEXTURE_2D, 3);
+        glBindTexture(GL_TEXTURE_2D, m_paletteTexture);
         glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 256, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, palette);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
         ASSERT_GL();
         glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, 4);
+        glBindTexture(GL_TEXTURE_2D, m_texture);
         glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA, 800, 480, 0, GL_ALPHA, GL_UNSIGNED_BYTE, texture);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
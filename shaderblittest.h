@@ -32,7 +32,7 @@ class ShaderBlitTest: public Test
 protected:
     GLint m_program, m_secondaryProgram;
     GLint m_positionAttr, m_texcoordAttr;
-    GLuint m_texture;
+    GLuint m_texture, m_paletteTexture;
     int m_width, m_height;
     float m_texW, m_texH;
     float m_quadW, m_quadH;
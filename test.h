@@ -24,6 +24,7 @@
 #define TEST_H
 
 #include <string>
+#include <stdint.h>
 
 class Test
 {
@@ -36,6 +37,18 @@ public:
     {
     }
 
+    /**
+     *  Check whether the test can run with the current context. Called
+     *  before prepare(), so that tests which cannot run are skipped without
+     *  paying for their setup. Must not allocate any resources.
+     *
+     *  @returns the reason the test cannot run, or an empty string if it can
+     */
+    virtual std::string unsupportedReason() const
+    {
+        return "";
+    }
+
     /**
      *  Make the test ready to be executed
      */
@@ -63,6 +76,44 @@ public:
      */
     virtual std::string name() const = 0;
 
+    /**
+     *  @returns the name of a test whose frame time this test should be
+     *  compared against, or an empty string if there is none
+     */
+    virtual std::string baselineName() const
+    {
+        return "";
+    }
+
+    /**
+     *  @returns the number of bytes of framebuffer memory written per frame,
+     *  or zero if the test does not report its bandwidth
+     */
+    virtual int64_t bytesPerFrame() const
+    {
+        return 0;
+    }
+
+    /**
+     *  @returns true if each frame fully determines the contents of the
+     *  window, false if the test renders only offscreen or leaves parts of
+     *  the window untouched. Only tests returning true are checked against
+     *  reference frames.
+     */
+    virtual bool capturesWindow() const
+    {
+        return true;
+    }
+
+    /**
+     *  @returns additional test specific results to be printed after the
+     *  frame time, or an empty string if there are none
+     */
+    virtual std::string statistics() const
+    {
+        return "";
+    }
+
 protected:
     /**
      *  Abort a test
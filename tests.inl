@@ -1,9 +1,44 @@
-    std::string renderer = std::string(reinterpret_cast<const char*>(glGetString(GL_RENDERER)));
-    bool isPVR = renderer.find("SGX ") != std::string::npos;
-
     // Clear test
     ADD_TEST(ClearTest());
 
+    // Clear variants
+    {
+        const float areas[] = {1.0f, 0.5f, 0.25f, 0.1f};
+        const GLenum formats[][2] =
+        {
+            {GL_RGBA, GL_UNSIGNED_BYTE},
+            {GL_RGB,  GL_UNSIGNED_SHORT_5_6_5},
+            {GL_RGBA, GL_UNSIGNED_SHORT_4_4_4_4},
+        };
+        const GLbitfield masks[] =
+        {
+            GL_COLOR_BUFFER_BIT,
+            GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT,
+            GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT,
+            GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT,
+        };
+        unsigned i, j;
+
+        for (i = 0; i < sizeof(areas) / sizeof(areas[0]); i++)
+        {
+            if (areas[i] < 1.0f)
+            {
+                ADD_TEST(ClearTest(GL_COLOR_BUFFER_BIT, areas[i]));
+            }
+            ADD_TEST(ClearTest(GL_COLOR_BUFFER_BIT, areas[i], CLEAR_QUAD));
+        }
+
+        for (j = 0; j < sizeof(formats) / sizeof(formats[0]); j++)
+        {
+            for (i = 0; i < sizeof(masks) / sizeof(masks[0]); i++)
+            {
+                ADD_TEST(ClearTest(formats[j][0], formats[j][1], winWidth, winHeight, masks[i]));
+                ADD_TEST(ClearTest(formats[j][0], formats[j][1], winWidth, winHeight, masks[i], 1.0f, CLEAR_QUAD));
+            }
+            ADD_TEST(ClearTest(formats[j][0], formats[j][1], winWidth, winHeight, masks[2], 0.25f));
+        }
+    }
+
     // Normal blits
     ADD_TEST(BlitTest(GL_RGBA, GL_UNSIGNED_BYTE,              800, 480, "data/water2_800x480_rgba8888.raw"));
     ADD_TEST(BlitTest(GL_RGB,  GL_UNSIGNED_BYTE,              800, 480, "data/water2_800x480_rgb888.raw"));
@@ -12,14 +47,57 @@
     ADD_TEST(BlitTest(GL_RGBA, GL_UNSIGNED_BYTE,             1024, 512, "data/digital_nature2_1024x512_rgba8888.raw", false, 800.0 / 1024, 480.0 / 512));
     ADD_TEST(BlitTest(GL_RGB,  GL_UNSIGNED_SHORT_5_6_5,       800, 480, "data/water2_800x480_rgb565.raw"));
     ADD_TEST(BlitTest(GL_RGB,  GL_UNSIGNED_SHORT_5_6_5,      1024, 512, "data/digital_nature2_1024x512_rgb565.raw", false, 800.0 / 1024, 480.0 / 512));
-    if (isPVR)
-    {
-        ADD_TEST(BlitTest(GL_COMPRESSED_RGB_PVRTC_4BPPV1_IMG, 0, 1024, 512, "data/abstract3_1024x512_pvrtc4.raw", false, 800.0 / 1024, 480.0 / 512));
-        ADD_TEST(BlitTest(GL_COMPRESSED_RGB_PVRTC_2BPPV1_IMG, 0, 1024, 512, "data/abstract3_1024x512_pvrtc2.raw", false, 800.0 / 1024, 480.0 / 512));
-    }
+    ADD_TEST(BlitTest(GL_COMPRESSED_RGB_PVRTC_4BPPV1_IMG, 0, 1024, 512, "data/abstract3_1024x512_pvrtc4.raw", false, 800.0 / 1024, 480.0 / 512));
+    ADD_TEST(BlitTest(GL_COMPRESSED_RGB_PVRTC_2BPPV1_IMG, 0, 1024, 512, "data/abstract3_1024x512_pvrtc2.raw", false, 800.0 / 1024, 480.0 / 512));
     ADD_TEST(BlitTest(GL_ETC1_RGB8_OES,                   0, 1024, 512, "data/abstract3_1024x512_etc1.raw", false, 800.0 / 1024, 480.0 / 512));
     ADD_TEST(BlitTest(GL_LUMINANCE, GL_UNSIGNED_BYTE,         800, 480, "data/abstract3_04_800x480_r8.raw"));
     ADD_TEST(BlitTest(GL_LUMINANCE, GL_UNSIGNED_BYTE,        1024, 512, "data/abstract3_04_1024x512_r8.raw", false, 800.0 / 1024, 480.0 / 512));
+
+    // Blits of generated content at the window size
+    {
+        const GLenum formats[][2] =
+        {
+            {GL_RGBA,            GL_UNSIGNED_BYTE},
+            {GL_RGB,             GL_UNSIGNED_BYTE},
+            {GL_RGB,             GL_UNSIGNED_SHORT_5_6_5},
+            {GL_RGBA,            GL_UNSIGNED_SHORT_4_4_4_4},
+            {GL_RGBA,            GL_UNSIGNED_SHORT_5_5_5_1},
+            {GL_LUMINANCE_ALPHA, GL_UNSIGNED_BYTE},
+            {GL_LUMINANCE,       GL_UNSIGNED_BYTE},
+        };
+        unsigned i;
+
+        for (i = 0; i < sizeof(formats) / sizeof(formats[0]); i++)
+        {
+            ADD_TEST(BlitTest(formats[i][0], formats[i][1], winWidth, winHeight, ""));
+        }
+    }
+
+    // Compressed versus uncompressed blits of generated content
+    {
+        const int sizes[] = {128, 256, 512, 1024, 2048};
+        const GLenum compressedFormats[] =
+        {
+            GL_ETC1_RGB8_OES,
+            GL_COMPRESSED_RGB8_ETC2,
+            GL_COMPRESSED_RGBA8_ETC2_EAC,
+            GL_COMPRESSED_R11_EAC,
+            GL_COMPRESSED_RGBA_ASTC_4x4_KHR,
+            GL_COMPRESSED_RGBA_ASTC_6x6_KHR,
+            GL_COMPRESSED_RGBA_ASTC_8x8_KHR,
+        };
+        unsigned i, j;
+
+        for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+        {
+            ADD_TEST(BlitTest(GL_RGBA,           GL_UNSIGNED_BYTE,         sizes[i], sizes[i], ""));
+            ADD_TEST(BlitTest(GL_RGB,            GL_UNSIGNED_SHORT_5_6_5,  sizes[i], sizes[i], ""));
+            for (j = 0; j < sizeof(compressedFormats) / sizeof(compressedFormats[0]); j++)
+            {
+                ADD_TEST(BlitTest(compressedFormats[j], 0, sizes[i], sizes[i], ""));
+            }
+        }
+    }
 #if defined(SUPPORT_X11)
     ADD_TEST(PixmapBlitTest(w, h, ctx.config));
     ADD_TEST(PixmapBlitTest(w, h, config32));
@@ -37,11 +115,8 @@
     ADD_TEST(BlitTest(GL_RGBA, GL_UNSIGNED_BYTE,              512, 1024, "data/digital_nature2_512x1024_rgba8888.raw", true, 480.0 / 512, 800.0 / 1024));
     ADD_TEST(BlitTest(GL_RGB,  GL_UNSIGNED_SHORT_5_6_5,       480,  800, "data/water2_480x800_rgb565.raw", true));
     ADD_TEST(BlitTest(GL_RGB,  GL_UNSIGNED_SHORT_5_6_5,       512, 1024, "data/digital_nature2_512x1024_rgb565.raw", true, 480.0 / 512, 800.0 / 1024));
-    if (isPVR)
-    {
-        ADD_TEST(BlitTest(GL_COMPRESSED_RGB_PVRTC_4BPPV1_IMG, 0,  512, 1024, "data/abstract3_512x1024_pvrtc4.raw", true, 480.0 / 512, 800.0 / 1024));
-        ADD_TEST(BlitTest(GL_COMPRESSED_RGB_PVRTC_2BPPV1_IMG, 0,  512, 1024, "data/abstract3_512x1024_pvrtc2.raw", true, 480.0 / 512, 800.0 / 1024));
-    }
+    ADD_TEST(BlitTest(GL_COMPRESSED_RGB_PVRTC_4BPPV1_IMG, 0,  512, 1024, "data/abstract3_512x1024_pvrtc4.raw", true, 480.0 / 512, 800.0 / 1024));
+    ADD_TEST(BlitTest(GL_COMPRESSED_RGB_PVRTC_2BPPV1_IMG, 0,  512, 1024, "data/abstract3_512x1024_pvrtc2.raw", true, 480.0 / 512, 800.0 / 1024));
     ADD_TEST(BlitTest(GL_ETC1_RGB8_OES,                   0,  512, 1024, "data/abstract3_512x1024_etc1.raw", true, 480.0 / 512, 800.0 / 1024));
 #if defined(SUPPORT_X11)
     ADD_TEST(PixmapBlitTest(h, w, ctx.config, true));
@@ -91,11 +166,8 @@
     ADD_TEST(BlitTest(GL_RGBA, GL_UNSIGNED_BYTE,              128, 128, "data/xorg_128x128_rgba8888.raw", false, gridW, gridH, 128.0 / w2, 128.0 / h2, true));
     ADD_TEST(BlitTest(GL_RGB, GL_UNSIGNED_SHORT_5_6_5,        127, 127, "data/xorg_127x127_rgb565.raw",   false, gridW, gridH, 127.0 / w2, 127.0 / h2, true));
     ADD_TEST(BlitTest(GL_RGB, GL_UNSIGNED_SHORT_5_6_5,        128, 128, "data/xorg_128x128_rgb565.raw",   false, gridW, gridH, 128.0 / w2, 128.0 / h2, true));
-    if (isPVR)
-    {
-        ADD_TEST(BlitTest(GL_COMPRESSED_RGBA_PVRTC_4BPPV1_IMG, 0, 128, 128, "data/xorg_128x128_pvrtc4.raw",   false, gridW, gridH, 128.0 / w2, 128.0 / h2, true));
-        ADD_TEST(BlitTest(GL_COMPRESSED_RGBA_PVRTC_2BPPV1_IMG, 0, 128, 128, "data/xorg_128x128_pvrtc2.raw",   false, gridW, gridH, 128.0 / w2, 128.0 / h2, true));
-    }
+    ADD_TEST(BlitTest(GL_COMPRESSED_RGBA_PVRTC_4BPPV1_IMG, 0, 128, 128, "data/xorg_128x128_pvrtc4.raw",   false, gridW, gridH, 128.0 / w2, 128.0 / h2, true));
+    ADD_TEST(BlitTest(GL_COMPRESSED_RGBA_PVRTC_2BPPV1_IMG, 0, 128, 128, "data/xorg_128x128_pvrtc2.raw",   false, gridW, gridH, 128.0 / w2, 128.0 / h2, true));
     ADD_TEST(BlitTest(GL_ETC1_RGB8_OES,                    0, 128, 128, "data/xorg_128x128_etc1.raw",     false, gridW, gridH, 128.0 / w2, 128.0 / h2, true));
     ADD_TEST(ShaderBlitTest("mask", 128, 128, gridW, gridH * 0.5f, 128.0 / w2, 128.0 / h2));
 
@@ -104,11 +176,8 @@
     ADD_TEST(BlitTest(GL_RGBA, GL_UNSIGNED_BYTE,              128, 128, "data/xorg_128x128_rgba8888.raw", true, gridH, gridW, 128.0 / w2, 128.0 / h2, true));
     ADD_TEST(BlitTest(GL_RGB, GL_UNSIGNED_SHORT_5_6_5,        127, 127, "data/xorg_127x127_rgb565.raw",   true, gridH, gridW, 127.0 / w2, 127.0 / h2, true));
     ADD_TEST(BlitTest(GL_RGB, GL_UNSIGNED_SHORT_5_6_5,        128, 128, "data/xorg_128x128_rgb565.raw",   true, gridH, gridW, 128.0 / w2, 128.0 / h2, true));
-    if (isPVR)
-    {
-        ADD_TEST(BlitTest(GL_COMPRESSED_RGBA_PVRTC_4BPPV1_IMG, 0, 128, 128, "data/xorg_128x128_pvrtc4.raw",   true, gridH, gridW, 128.0 / w2, 128.0 / h2, true));
-        ADD_TEST(BlitTest(GL_COMPRESSED_RGBA_PVRTC_2BPPV1_IMG, 0, 128, 128, "data/xorg_128x128_pvrtc2.raw",   true, gridH, gridW, 128.0 / w2, 128.0 / h2, true));
-    }
+    ADD_TEST(BlitTest(GL_COMPRESSED_RGBA_PVRTC_4BPPV1_IMG, 0, 128, 128, "data/xorg_128x128_pvrtc4.raw",   true, gridH, gridW, 128.0 / w2, 128.0 / h2, true));
+    ADD_TEST(BlitTest(GL_COMPRESSED_RGBA_PVRTC_2BPPV1_IMG, 0, 128, 128, "data/xorg_128x128_pvrtc2.raw",   true, gridH, gridW, 128.0 / w2, 128.0 / h2, true));
     ADD_TEST(BlitTest(GL_ETC1_RGB8_OES,                    0, 128, 128, "data/xorg_128x128_etc1.raw",     true, gridH, gridW, 128.0 / w2, 128.0 / h2, true));
 
     // Shader tests
@@ -118,6 +187,251 @@
     ADD_TEST(ShaderBlitTest("palette", w, h));
     ADD_TEST(ShaderBlitTest("blur", w, h));
 
+    // Blur variants
+    {
+        const int taps[] = {3, 5, 9, 15, 31};
+        const int downSamples[] = {1, 2, 8};
+        const int passes[] = {2, 4};
+        unsigned i;
+
+        for (i = 0; i < sizeof(taps) / sizeof(taps[0]); i++)
+        {
+            ADD_TEST(BlurTest(BLUR_NAIVE_2D,         taps[i], 4, 1, winWidth, winHeight));
+            ADD_TEST(BlurTest(BLUR_SEPARABLE,        taps[i], 4, 1, winWidth, winHeight));
+            ADD_TEST(BlurTest(BLUR_SEPARABLE_LINEAR, taps[i], 4, 1, winWidth, winHeight));
+        }
+        for (i = 0; i < sizeof(downSamples) / sizeof(downSamples[0]); i++)
+        {
+            ADD_TEST(BlurTest(BLUR_SEPARABLE,        9, downSamples[i], 1, winWidth, winHeight));
+            ADD_TEST(BlurTest(BLUR_SEPARABLE_LINEAR, 9, downSamples[i], 1, winWidth, winHeight));
+        }
+        for (i = 0; i < sizeof(passes) / sizeof(passes[0]); i++)
+        {
+            ADD_TEST(BlurTest(BLUR_SEPARABLE_LINEAR, 9, 4, passes[i], winWidth, winHeight));
+        }
+    }
+
+    // Blend modes
+    {
+        const BlendMode modes[] =
+        {
+            BLEND_NONE, BLEND_PREMULTIPLIED, BLEND_STRAIGHT,
+            BLEND_ADDITIVE, BLEND_MULTIPLY, BLEND_SEPARATE,
+        };
+        const int layers[] = {1, 4};
+        unsigned i, j;
+
+        for (j = 0; j < sizeof(layers) / sizeof(layers[0]); j++)
+        {
+            for (i = 0; i < sizeof(modes) / sizeof(modes[0]); i++)
+            {
+                ADD_TEST(BlendTest(modes[i], layers[j], GL_RGBA, GL_UNSIGNED_BYTE, 800, 480, "data/water2_800x480_rgba8888.raw"));
+            }
+        }
+    }
+
+    // Render-to-texture chains
+    {
+        const int stages[] = {1, 2, 4, 8};
+        unsigned i;
+
+        for (i = 0; i < sizeof(stages) / sizeof(stages[0]); i++)
+        {
+            ADD_TEST(FBOChainTest(stages[i], false, false, winWidth, winHeight));
+            ADD_TEST(FBOChainTest(stages[i], false, true,  winWidth, winHeight));
+            ADD_TEST(FBOChainTest(stages[i], true,  false, winWidth, winHeight));
+            ADD_TEST(FBOChainTest(stages[i], true,  true,  winWidth, winHeight));
+        }
+    }
+
+    // Multisampled rendering
+    {
+        const int samples[] = {1, 2, 4, 8};
+        const MultisampleTarget targets[] = {MSAA_WINDOW, MSAA_FBO_TEXTURE, MSAA_FBO_BLIT};
+        unsigned i, j;
+
+        for (j = 0; j < sizeof(targets) / sizeof(targets[0]); j++)
+        {
+            for (i = 0; i < sizeof(samples) / sizeof(samples[0]); i++)
+            {
+                ADD_TEST(MultisampleTest<BlitTest>(targets[j], samples[i], GL_RGBA, GL_UNSIGNED_BYTE, 800, 480, "data/water2_800x480_rgba8888.raw"));
+                ADD_TEST(MultisampleTest<ShaderBlitTest>(targets[j], samples[i], "radgrad", w, h));
+            }
+        }
+    }
+
+    // Partial updates
+    {
+        const PartialUpdateMethod methods[] =
+        {
+            PARTIAL_BUFFER_AGE, PARTIAL_SWAP_DAMAGE, PARTIAL_UPDATE, PARTIAL_PRESERVED,
+        };
+        const float damage[] = {0.01f, 0.05f, 0.1f, 0.25f, 0.5f, 1.0f};
+        unsigned i, j;
+
+        ADD_TEST(PartialUpdateTest(PARTIAL_FULL, 1.0f));
+        for (j = 0; j < sizeof(methods) / sizeof(methods[0]); j++)
+        {
+            for (i = 0; i < sizeof(damage) / sizeof(damage[0]); i++)
+            {
+                ADD_TEST(PartialUpdateTest(methods[j], damage[i]));
+            }
+        }
+    }
+
+    // Frame pacing
+    {
+        const int intervals[] = {0, 1, 2};
+        const int cpuWork[] = {0, 4000, 12000};
+        const int gpuLayers[] = {1, 8};
+        unsigned i, j, k;
+
+        for (k = 0; k < sizeof(intervals) / sizeof(intervals[0]); k++)
+        {
+            for (j = 0; j < sizeof(gpuLayers) / sizeof(gpuLayers[0]); j++)
+            {
+                for (i = 0; i < sizeof(cpuWork) / sizeof(cpuWork[0]); i++)
+                {
+                    ADD_TEST(PacingTest(intervals[k], cpuWork[i], gpuLayers[j],
+                                       displayRefreshRate));
+                }
+            }
+        }
+    }
+
+    // Context and surface switching
+    {
+        const ContextSwitchMode modes[] = {SWITCH_SURFACES, SWITCH_CONTEXTS, SWITCH_BOTH};
+        const int counts[] = {1, 4, 16, 32};
+        unsigned i, j;
+
+        for (i = 0; i < sizeof(counts) / sizeof(counts[0]); i++)
+        {
+            ADD_TEST(ContextSwitchTest(SWITCH_NONE, SWITCH_PBUFFER, counts[i]));
+            for (j = 0; j < sizeof(modes) / sizeof(modes[0]); j++)
+            {
+                ADD_TEST(ContextSwitchTest(modes[j], SWITCH_WINDOW, counts[i]));
+                ADD_TEST(ContextSwitchTest(modes[j], SWITCH_PBUFFER, counts[i]));
+                ADD_TEST(ContextSwitchTest(modes[j], SWITCH_PIXMAP, counts[i]));
+            }
+        }
+    }
+
+    // Texture allocation churn
+    {
+        const int counts[] = {4, 16, 64};
+        const int sizes[] = {32, 128, 512};
+        unsigned i, j;
+
+        for (j = 0; j < sizeof(sizes) / sizeof(sizes[0]); j++)
+        {
+            for (i = 0; i < sizeof(counts) / sizeof(counts[0]); i++)
+            {
+                ADD_TEST(TextureChurnTest(CHURN_CREATE_DELETE, counts[i], sizes[j]));
+                ADD_TEST(TextureChurnTest(CHURN_POOL, counts[i], sizes[j]));
+            }
+        }
+    }
+
+    // Texture memory oversubscription, each size compared with the previous
+    {
+        unsigned i;
+
+        for (i = 0; i < thrashPercents.size(); i++)
+        {
+            ADD_TEST(TextureThrashTest(thrashPercents[i], i ? thrashPercents[i - 1] : 0));
+        }
+    }
+
+    // Rounded rectangle clipping
+    {
+        const int percents[] = {10, 25, 50, 100};
+        const ClipMethod methods[] =
+        {
+            CLIP_NONE, CLIP_STENCIL, CLIP_DISCARD, CLIP_ALPHA_MASK, CLIP_SDF
+        };
+        unsigned i, j;
+
+        for (i = 0; i < sizeof(percents) / sizeof(percents[0]); i++)
+        {
+            for (j = 0; j < sizeof(methods) / sizeof(methods[0]); j++)
+            {
+                ADD_TEST(ClipTest(methods[j], percents[i]));
+            }
+        }
+    }
+
+    // Text rendering from a glyph atlas
+    {
+        const int counts[] = {1000, 10000, 100000};
+        unsigned i;
+
+        for (i = 0; i < sizeof(counts) / sizeof(counts[0]); i++)
+        {
+            ADD_TEST(TextTest(TEXT_BATCHED,    GL_ALPHA, counts[i]));
+            ADD_TEST(TextTest(TEXT_PER_STRING, GL_ALPHA, counts[i]));
+        }
+        ADD_TEST(TextTest(TEXT_BATCHED,    GL_LUMINANCE, 10000));
+        ADD_TEST(TextTest(TEXT_PER_STRING, GL_LUMINANCE, 10000));
+    }
+
+    // Video upload and conversion
+    {
+        const int sizes[][2] = {{1280, 720}, {1920, 1080}};
+        const VideoFormat formats[] = {VIDEO_NV12, VIDEO_I420};
+        unsigned i, j;
+
+        for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+        {
+            for (j = 0; j < sizeof(formats) / sizeof(formats[0]); j++)
+            {
+                ADD_TEST(VideoTest(formats[j], VIDEO_TEXTURE_2D, sizes[i][0], sizes[i][1]));
+                ADD_TEST(VideoTest(formats[j], VIDEO_EGL_IMAGE,  sizes[i][0], sizes[i][1]));
+            }
+        }
+    }
+
+    // Pixel readback
+    {
+        const int sizes[][2] = {{winWidth, winHeight}, {256, 256}, {64, 64}};
+        const GLenum formats[][2] =
+        {
+            {GL_RGBA,     GL_UNSIGNED_BYTE},
+            {GL_BGRA_EXT, GL_UNSIGNED_BYTE},
+            {GL_RGB,      GL_UNSIGNED_SHORT_5_6_5},
+        };
+        const ReadbackSource sources[] = {READBACK_WINDOW, READBACK_FBO};
+        unsigned i, j, k;
+
+        for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+        {
+            for (j = 0; j < sizeof(formats) / sizeof(formats[0]); j++)
+            {
+                for (k = 0; k < sizeof(sources) / sizeof(sources[0]); k++)
+                {
+                    ADD_TEST(ReadbackTest(sources[k], READBACK_SYNC, formats[j][0], formats[j][1],
+                                          sizes[i][0], sizes[i][1]));
+                    ADD_TEST(ReadbackTest(sources[k], READBACK_PBO,  formats[j][0], formats[j][1],
+                                          sizes[i][0], sizes[i][1]));
+                }
+            }
+        }
+    }
+
+    // Compositor scenes
+    ADD_TEST(CompositorTest("data/desktop.scene"));
+    ADD_TEST(CompositorTest("data/appswitch.scene"));
+    ADD_TEST(CompositorTest("data/pixmaps.scene"));
+
+    // Captured command streams
+    {
+        std::vector<std::string> traces = listFiles("data", ".trace");
+        for (size_t i = 0; i < traces.size(); i++)
+        {
+            ADD_TEST(TraceTest(traces[i]));
+        }
+    }
+
     // CPU interleaving
     int wPOT = 1, hPOT = 1;
     while (wPOT < winWidth / 2)
@@ -125,21 +439,17 @@
     while (hPOT < winHeight / 2)
       hPOT <<= 1;
 
-#if defined(SUPPORT_X11)
     ADD_TEST(CPUInterleavingTest(CPUI_XSHM_IMAGE, 2, 16, winWidth, winHeight));
     ADD_TEST(CPUInterleavingTest(CPUI_XSHM_IMAGE, 2, 32, winWidth, winHeight));
     ADD_TEST(CPUInterleavingTest(CPUI_XSHM_IMAGE, 2, 16, wPOT, hPOT));
     ADD_TEST(CPUInterleavingTest(CPUI_XSHM_IMAGE, 2, 32, wPOT, hPOT));
-#endif
 
     ADD_TEST(CPUInterleavingTest(CPUI_TEXTURE_UPLOAD, 2, 16, winWidth, winHeight));
     ADD_TEST(CPUInterleavingTest(CPUI_TEXTURE_UPLOAD, 2, 32, winWidth, winHeight));
     ADD_TEST(CPUInterleavingTest(CPUI_TEXTURE_UPLOAD, 2, 16, wPOT, hPOT));
     ADD_TEST(CPUInterleavingTest(CPUI_TEXTURE_UPLOAD, 2, 32, wPOT, hPOT));
 
-#if !defined(SUPPORT_ANDROID)
     ADD_TEST(CPUInterleavingTest(CPUI_EGL_LOCK_SURFACE, 2, 16, winWidth, winHeight));
     ADD_TEST(CPUInterleavingTest(CPUI_EGL_LOCK_SURFACE, 2, 32, winWidth, winHeight));
     ADD_TEST(CPUInterleavingTest(CPUI_EGL_LOCK_SURFACE, 2, 16, wPOT, hPOT));
     ADD_TEST(CPUInterleavingTest(CPUI_EGL_LOCK_SURFACE, 2, 32, wPOT, hPOT));
-#endif
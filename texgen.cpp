@@ -0,0 +1,464 @@
+/**
+ * OpenGL ES 2.0 memory performance estimator
+ * Copyright (C) 2012 Google
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * \author Sami Kyöstilä <skyostil@google.com>
+ *
+ * Procedural texture generation and pixel format conversion
+ */
+#include "texgen.h"
+#include "astc.h"
+#include "etc.h"
+#include "ext.h"
+#include "util.h"
+
+#include <algorithm>
+#include <stdint.h>
+
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#define TEXGEN_NEON
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define TEXGEN_SSE2
+#endif
+
+void generateTextureContent(std::vector<unsigned char>& pixels, int width, int height)
+{
+    pixels.resize(width * height * 4);
+
+    int cx = width / 2, cy = height / 2;
+    unsigned char* p = &pixels[0];
+
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            // Integer hash for fine grained noise
+            uint32_t h = static_cast<uint32_t>(x) * 0x9e3779b1u ^ static_cast<uint32_t>(y) * 0x85ebca6bu;
+            h ^= h >> 15;
+            h *= 0xc2b2ae35u;
+            h ^= h >> 13;
+
+            int dx = x - cx, dy = y - cy;
+            int ring = ((dx * dx + dy * dy) >> 6) & 0xff;
+
+            p[0] = static_cast<unsigned char>((x * 255) / (width > 1 ? width - 1 : 1) ^ (h & 0xf));
+            p[1] = static_cast<unsigned char>((y * 255) / (height > 1 ? height - 1 : 1) ^ ((h >> 4) & 0xf));
+            p[2] = static_cast<unsigned char>(ring ^ ((x ^ y) & 0x20));
+            p[3] = static_cast<unsigned char>(0xff - (ring >> 1));
+            p += 4;
+        }
+    }
+}
+
+int pixelSize(GLenum format, GLenum type)
+{
+    switch (type)
+    {
+    case GL_UNSIGNED_BYTE:
+        switch (format)
+        {
+        case GL_RGBA:
+            return 4;
+        case GL_RGB:
+            return 3;
+        case GL_LUMINANCE_ALPHA:
+            return 2;
+        case GL_LUMINANCE:
+        case GL_ALPHA:
+            return 1;
+        }
+        return 0;
+    case GL_UNSIGNED_SHORT_5_6_5:
+        return (format == GL_RGB) ? 2 : 0;
+    case GL_UNSIGNED_SHORT_4_4_4_4:
+    case GL_UNSIGNED_SHORT_5_5_5_1:
+        return (format == GL_RGBA) ? 2 : 0;
+    }
+    return 0;
+}
+
+/*
+ * Each converter handles as many pixels as it can with SIMD and returns the
+ * number converted; the scalar loops below finish the remainder. The SIMD
+ * paths must produce exactly the same results as the scalar ones.
+ */
+
+static inline uint16_t toRGB565(const unsigned char* p)
+{
+    return ((p[0] & 0xf8) << 8) | ((p[1] & 0xfc) << 3) | (p[2] >> 3);
+}
+
+static inline uint16_t toRGBA4444(const unsigned char* p)
+{
+    return ((p[0] >> 4) << 12) | ((p[1] >> 4) << 8) | ((p[2] >> 4) << 4) | (p[3] >> 4);
+}
+
+static inline uint16_t toRGBA5551(const unsigned char* p)
+{
+    return ((p[0] >> 3) << 11) | ((p[1] >> 3) << 6) | ((p[2] >> 3) << 1) | (p[3] >> 7);
+}
+
+static inline unsigned char toLuminance(const unsigned char* p)
+{
+    // Rec. 601 weights scaled to add up to 256
+    return (p[0] * 77 + p[1] * 150 + p[2] * 29) >> 8;
+}
+
+#if defined(TEXGEN_NEON)
+static int convertRGB565SIMD(const unsigned char* src, uint16_t* dest, int count)
+{
+    int i;
+    for (i = 0; i + 8 <= count; i += 8)
+    {
+        uint8x8x4_t p = vld4_u8(src + i * 4);
+        uint16x8_t result = vshll_n_u8(p.val[0], 8);
+        result = vsriq_n_u16(result, vshll_n_u8(p.val[1], 8), 5);
+        result = vsriq_n_u16(result, vshll_n_u8(p.val[2], 8), 11);
+        vst1q_u16(dest + i, result);
+    }
+    return i;
+}
+
+static int convertRGBA4444SIMD(const unsigned char* src, uint16_t* dest, int count)
+{
+    int i;
+    for (i = 0; i + 8 <= count; i += 8)
+    {
+        uint8x8x4_t p = vld4_u8(src + i * 4);
+        uint16x8_t result = vshll_n_u8(p.val[0], 8);
+        result = vsriq_n_u16(result, vshll_n_u8(p.val[1], 8), 4);
+        result = vsriq_n_u16(result, vshll_n_u8(p.val[2], 8), 8);
+        result = vsriq_n_u16(result, vshll_n_u8(p.val[3], 8), 12);
+        vst1q_u16(dest + i, result);
+    }
+    return i;
+}
+
+static int convertRGBA5551SIMD(const unsigned char* src, uint16_t* dest, int count)
+{
+    int i;
+    for (i = 0; i + 8 <= count; i += 8)
+    {
+        uint8x8x4_t p = vld4_u8(src + i * 4);
+        uint16x8_t result = vshll_n_u8(p.val[0], 8);
+        result = vsriq_n_u16(result, vshll_n_u8(p.val[1], 8), 5);
+        result = vsriq_n_u16(result, vshll_n_u8(p.val[2], 8), 10);
+        result = vsriq_n_u16(result, vshll_n_u8(p.val[3], 8), 15);
+        vst1q_u16(dest + i, result);
+    }
+    return i;
+}
+
+static int convertLuminanceSIMD(const unsigned char* src, unsigned char* dest, int count)
+{
+    int i;
+    for (i = 0; i + 8 <= count; i += 8)
+    {
+        uint8x8x4_t p = vld4_u8(src + i * 4);
+        uint16x8_t sum = vmull_u8(p.val[0], vdup_n_u8(77));
+        sum = vmlal_u8(sum, p.val[1], vdup_n_u8(150));
+        sum = vmlal_u8(sum, p.val[2], vdup_n_u8(29));
+        vst1_u8(dest + i, vshrn_n_u16(sum, 8));
+    }
+    return i;
+}
+
+static int convertRGB888SIMD(const unsigned char* src, unsigned char* dest, int count)
+{
+    int i;
+    for (i = 0; i + 8 <= count; i += 8)
+    {
+        uint8x8x4_t p = vld4_u8(src + i * 4);
+        uint8x8x3_t result;
+        result.val[0] = p.val[0];
+        result.val[1] = p.val[1];
+        result.val[2] = p.val[2];
+        vst3_u8(dest + i * 3, result);
+    }
+    return i;
+}
+#elif defined(TEXGEN_SSE2)
+/**
+ *  Pack the low halves of eight 32-bit lanes into 16-bit lanes without
+ *  saturating
+ */
+static inline __m128i pack16(__m128i a, __m128i b)
+{
+    a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+    b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+    return _mm_packs_epi32(a, b);
+}
+
+static inline __m128i channel(__m128i p, int shift, int mask)
+{
+    return _mm_and_si128(_mm_srli_epi32(p, shift), _mm_set1_epi32(mask));
+}
+
+static inline __m128i toRGB565x4(__m128i p)
+{
+    __m128i r = _mm_slli_epi32(channel(p, 0, 0xf8), 8);
+    __m128i g = _mm_slli_epi32(channel(p, 8, 0xfc), 3);
+    __m128i b = channel(p, 19, 0x1f);
+    return _mm_or_si128(_mm_or_si128(r, g), b);
+}
+
+static inline __m128i toRGBA4444x4(__m128i p)
+{
+    __m128i r = _mm_slli_epi32(channel(p, 4, 0xf), 12);
+    __m128i g = _mm_slli_epi32(channel(p, 12, 0xf), 8);
+    __m128i b = _mm_slli_epi32(channel(p, 20, 0xf), 4);
+    __m128i a = channel(p, 28, 0xf);
+    return _mm_or_si128(_mm_or_si128(r, g), _mm_or_si128(b, a));
+}
+
+static inline __m128i toRGBA5551x4(__m128i p)
+{
+    __m128i r = _mm_slli_epi32(channel(p, 3, 0x1f), 11);
+    __m128i g = _mm_slli_epi32(channel(p, 11, 0x1f), 6);
+    __m128i b = _mm_slli_epi32(channel(p, 19, 0x1f), 1);
+    __m128i a = channel(p, 31, 0x1);
+    return _mm_or_si128(_mm_or_si128(r, g), _mm_or_si128(b, a));
+}
+
+static inline __m128i toLuminancex4(__m128i p)
+{
+    // Products fit in the low 16 bits of each 32-bit lane
+    __m128i r = _mm_mullo_epi16(channel(p, 0, 0xff), _mm_set1_epi32(77));
+    __m128i g = _mm_mullo_epi16(channel(p, 8, 0xff), _mm_set1_epi32(150));
+    __m128i b = _mm_mullo_epi16(channel(p, 16, 0xff), _mm_set1_epi32(29));
+    return _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(r, g), b), 8);
+}
+
+#define DEFINE_SSE2_CONVERTER_16(NAME, FUNC) \
+    static int NAME(const unsigned char* src, uint16_t* dest, int count) \
+    { \
+        int i; \
+        for (i = 0; i + 8 <= count; i += 8) \
+        { \
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 4)); \
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 4 + 16)); \
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), pack16(FUNC(a), FUNC(b))); \
+        } \
+        return i; \
+    }
+
+DEFINE_SSE2_CONVERTER_16(convertRGB565SIMD, toRGB565x4)
+DEFINE_SSE2_CONVERTER_16(convertRGBA4444SIMD, toRGBA4444x4)
+DEFINE_SSE2_CONVERTER_16(convertRGBA5551SIMD, toRGBA5551x4)
+#undef DEFINE_SSE2_CONVERTER_16
+
+static int convertLuminanceSIMD(const unsigned char* src, unsigned char* dest, int count)
+{
+    int i;
+    for (i = 0; i + 16 <= count; i += 16)
+    {
+        const __m128i* p = reinterpret_cast<const __m128i*>(src + i * 4);
+        __m128i lo = _mm_packs_epi32(toLuminancex4(_mm_loadu_si128(p + 0)),
+                                     toLuminancex4(_mm_loadu_si128(p + 1)));
+        __m128i hi = _mm_packs_epi32(toLuminancex4(_mm_loadu_si128(p + 2)),
+                                     toLuminancex4(_mm_loadu_si128(p + 3)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), _mm_packus_epi16(lo, hi));
+    }
+    return i;
+}
+
+static int convertRGB888SIMD(const unsigned char*, unsigned char*, int)
+{
+    return 0;
+}
+#else
+static int convertRGB565SIMD(const unsigned char*, uint16_t*, int)
+{
+    return 0;
+}
+
+static int convertRGBA4444SIMD(const unsigned char*, uint16_t*, int)
+{
+    return 0;
+}
+
+static int convertRGBA5551SIMD(const unsigned char*, uint16_t*, int)
+{
+    return 0;
+}
+
+static int convertLuminanceSIMD(const unsigned char*, unsigned char*, int)
+{
+    return 0;
+}
+
+static int convertRGB888SIMD(const unsigned char*, unsigned char*, int)
+{
+    return 0;
+}
+#endif
+
+bool convertPixels(const unsigned char* src, void* dest, int count, GLenum format, GLenum type)
+{
+    unsigned char* d8 = static_cast<unsigned char*>(dest);
+    uint16_t* d16 = static_cast<uint16_t*>(dest);
+    int i;
+
+    switch (pixelSize(format, type) ? type : 0)
+    {
+    case GL_UNSIGNED_SHORT_5_6_5:
+        for (i = convertRGB565SIMD(src, d16, count); i < count; i++)
+        {
+            d16[i] = toRGB565(src + i * 4);
+        }
+        return true;
+    case GL_UNSIGNED_SHORT_4_4_4_4:
+        for (i = convertRGBA4444SIMD(src, d16, count); i < count; i++)
+        {
+            d16[i] = toRGBA4444(src + i * 4);
+        }
+        return true;
+    case GL_UNSIGNED_SHORT_5_5_5_1:
+        for (i = convertRGBA5551SIMD(src, d16, count); i < count; i++)
+        {
+            d16[i] = toRGBA5551(src + i * 4);
+        }
+        return true;
+    case GL_UNSIGNED_BYTE:
+        break;
+    default:
+        return false;
+    }
+
+    switch (format)
+    {
+    case GL_RGBA:
+        if (d8 != src)
+        {
+            std::copy(src, src + count * 4, d8);
+        }
+        break;
+    case GL_RGB:
+        for (i = convertRGB888SIMD(src, d8, count); i < count; i++)
+        {
+            d8[i * 3 + 0] = src[i * 4 + 0];
+            d8[i * 3 + 1] = src[i * 4 + 1];
+            d8[i * 3 + 2] = src[i * 4 + 2];
+        }
+        break;
+    case GL_LUMINANCE:
+        for (i = convertLuminanceSIMD(src, d8, count); i < count; i++)
+        {
+            d8[i] = toLuminance(src + i * 4);
+        }
+        break;
+    case GL_LUMINANCE_ALPHA:
+        for (i = 0; i < count; i++)
+        {
+            d8[i * 2 + 0] = toLuminance(src + i * 4);
+            d8[i * 2 + 1] = src[i * 4 + 3];
+        }
+        break;
+    case GL_ALPHA:
+        for (i = 0; i < count; i++)
+        {
+            d8[i] = src[i * 4 + 3];
+        }
+        break;
+    }
+    return true;
+}
+
+bool generateTexture(GLenum target, int level, GLenum internalFormat, int width,
+                     int height, GLenum format, GLenum type)
+{
+    int size = pixelSize(format, type);
+    std::vector<unsigned char> rgba;
+
+    if (!size)
+    {
+        return false;
+    }
+
+    generateTextureContent(rgba, width, height);
+
+    // Convert in place; the destination is never larger than the source
+    if (!convertPixels(&rgba[0], &rgba[0], width * height, format, type))
+    {
+        return false;
+    }
+
+    glTexImage2D(target, level, internalFormat, width, height, 0, format, type, &rgba[0]);
+    ASSERT_GL();
+    return true;
+}
+
+bool isGeneratedCompressedFormat(GLenum internalFormat)
+{
+    switch (internalFormat)
+    {
+    case GL_ETC1_RGB8_OES:
+    case GL_COMPRESSED_RGB8_ETC2:
+    case GL_COMPRESSED_RGBA8_ETC2_EAC:
+    case GL_COMPRESSED_R11_EAC:
+    case GL_COMPRESSED_RGBA_ASTC_4x4_KHR:
+    case GL_COMPRESSED_RGBA_ASTC_6x6_KHR:
+    case GL_COMPRESSED_RGBA_ASTC_8x8_KHR:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool generateCompressedTexture(GLenum target, int level, GLenum internalFormat,
+                               int width, int height)
+{
+    std::vector<unsigned char> rgba, data;
+
+    if (!isGeneratedCompressedFormat(internalFormat))
+    {
+        return false;
+    }
+
+    generateTextureContent(rgba, width, height);
+
+    switch (internalFormat)
+    {
+    case GL_ETC1_RGB8_OES:
+    case GL_COMPRESSED_RGB8_ETC2:
+        encodeETC1(&rgba[0], width, height, data);
+        break;
+    case GL_COMPRESSED_RGBA8_ETC2_EAC:
+        encodeETC2RGBA8(&rgba[0], width, height, data);
+        break;
+    case GL_COMPRESSED_R11_EAC:
+        encodeEACR11(&rgba[0], width, height, data);
+        break;
+    case GL_COMPRESSED_RGBA_ASTC_4x4_KHR:
+        encodeASTC(&rgba[0], width, height, 4, 4, data);
+        break;
+    case GL_COMPRESSED_RGBA_ASTC_6x6_KHR:
+        encodeASTC(&rgba[0], width, height, 6, 6, data);
+        break;
+    case GL_COMPRESSED_RGBA_ASTC_8x8_KHR:
+        encodeASTC(&rgba[0], width, height, 8, 8, data);
+        break;
+    default:
+        return false;
+    }
+
+    glCompressedTexImage2D(target, level, internalFormat, width, height, 0, data.size(), &data[0]);
+    ASSERT_GL();
+    return true;
+}
@@ -0,0 +1,101 @@
+/**
+ * OpenGL ES 2.0 memory performance estimator
+ * Copyright (C) 2012 Google
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * \author Sami Kyöstilä <skyostil@google.com>
+ *
+ * Procedural texture generation and pixel format conversion
+ */
+#ifndef TEXGEN_H
+#define TEXGEN_H
+
+#include <GLES2/gl2.h>
+#include <vector>
+
+/**
+ *  Generate deterministic RGBA8888 test content. The image combines smooth
+ *  gradients, rings and fine noise so that it neither compresses nor caches
+ *  unrealistically well. The same size always produces the same pixels.
+ *
+ *  @param pixels               Output: width * height * 4 bytes of RGBA8888
+ *  @param width                Image width in pixels
+ *  @param height               Image height in pixels
+ */
+void generateTextureContent(std::vector<unsigned char>& pixels, int width, int height);
+
+/**
+ *  @returns the size of a pixel in bytes for an uncompressed format and
+ *  type, or zero if the combination is not supported by convertPixels()
+ */
+int pixelSize(GLenum format, GLenum type);
+
+/**
+ *  Convert RGBA8888 pixels to another uncompressed format. Uses NEON or
+ *  SSE2 when available.
+ *
+ *  @param src                  Source pixels in RGBA8888
+ *  @param dest                 Output: count pixels in the given format
+ *  @param count                Number of pixels
+ *  @param format               Destination format, e.g. GL_RGB
+ *  @param type                 Destination type, e.g. GL_UNSIGNED_SHORT_5_6_5
+ *
+ *  @returns true on success, false if the format is not supported
+ */
+bool convertPixels(const unsigned char* src, void* dest, int count, GLenum format, GLenum type);
+
+/**
+ *  Generate test content and load it into a texture. The replacement for
+ *  loadRawTexture() when no pregenerated file is available.
+ *
+ *  @param target               Texture target (usually GL_TEXTURE_2D)
+ *  @param level                Mipmap level
+ *  @param internalFormat       Internal texture format
+ *  @param width                Texture width in pixels
+ *  @param height               Texture height in pixels
+ *  @param format               Pixel format
+ *  @param type                 Data type
+ *
+ *  @returns true on success, false if the format is not supported
+ */
+bool generateTexture(GLenum target, int level, GLenum internalFormat, int width,
+                     int height, GLenum format, GLenum type);
+
+/**
+ *  @param internalFormat       Compressed texture format
+ *
+ *  @returns true if generateCompressedTexture() can encode the format
+ */
+bool isGeneratedCompressedFormat(GLenum internalFormat);
+
+/**
+ *  Generate test content, compress it and load it into a texture. The
+ *  replacement for loadCompressedTexture() when no pregenerated file is
+ *  available.
+ *
+ *  @param target               Texture target (usually GL_TEXTURE_2D)
+ *  @param level                Mipmap level
+ *  @param internalFormat       Compressed format: ETC1, ETC2 RGB8, ETC2
+ *                              RGBA8, EAC R11 or ASTC 4x4, 6x6 or 8x8
+ *  @param width                Texture width in pixels
+ *  @param height               Texture height in pixels
+ *
+ *  @returns true on success, false if the format is not supported
+ */
+bool generateCompressedTexture(GLenum target, int level, GLenum internalFormat,
+                               int width, int height);
+
+#endif // TEXGEN_H
@@ -0,0 +1,410 @@
+/**
+ * OpenGL ES 2.0 memory performance estimator
+ * Copyright (C) 2012 Google
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * \author Sami Kyöstilä <skyostil@google.com>
+ *
+ * Glyph atlas text rendering test
+ */
+#include "texttest.h"
+#include "util.h"
+
+#include <math.h>
+#include <sstream>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+static const char* textVertSource =
+    "precision mediump float;\n"
+    "attribute vec2 in_position;\n"
+    "attribute vec2 in_texcoord;\n"
+    "attribute vec4 in_color;\n"
+    "varying vec2 texcoord;\n"
+    "varying vec4 color;\n"
+    "\n"
+    "void main()\n"
+    "{\n"
+    "	gl_Position = vec4(in_position, 0.0, 1.0);\n"
+    "	texcoord = in_texcoord;\n"
+    "	color = in_color;\n"
+    "}\n";
+
+// Coverage comes from alpha for A8 atlases and from red for L8 ones
+static const char* textFragSourceA8 =
+    "precision mediump float;\n"
+    "varying vec2 texcoord;\n"
+    "varying vec4 color;\n"
+    "uniform sampler2D texture;\n"
+    "\n"
+    "void main()\n"
+    "{\n"
+    "	gl_FragColor = vec4(color.rgb, color.a * texture2D(texture, texcoord).a);\n"
+    "}\n";
+
+static const char* textFragSourceL8 =
+    "precision mediump float;\n"
+    "varying vec2 texcoord;\n"
+    "varying vec4 color;\n"
+    "uniform sampler2D texture;\n"
+    "\n"
+    "void main()\n"
+    "{\n"
+    "	gl_FragColor = vec4(color.rgb, color.a * texture2D(texture, texcoord).r);\n"
+    "}\n";
+
+/** Glyph cell size in the atlas and on screen in pixels */
+static const int glyphSize = 16;
+/** Horizontal distance between glyphs and vertical distance between lines */
+static const int glyphAdvance = 9;
+static const int lineHeight = 18;
+/** Atlas layout in glyph cells */
+static const int atlasColumns = 16;
+static const int atlasRows = 8;
+/** Longest glyph run addressable with 16-bit indices */
+static const int maxBatchGlyphs = 65536 / 4;
+
+struct GlyphVertex
+{
+    GLfloat x, y;
+    GLfloat s, t;
+    GLubyte color[4];
+};
+
+TextTest::TextTest(TextBatching batching, GLenum atlasFormat, int glyphCount):
+    m_batching(batching),
+    m_atlasFormat(atlasFormat),
+    m_glyphCount(glyphCount),
+    m_program(0),
+    m_atlas(0),
+    m_vertexBuffer(0),
+    m_indexBuffer(0),
+    m_drawCalls(0),
+    m_frames(0)
+{
+    ASSERT(m_atlasFormat == GL_ALPHA || m_atlasFormat == GL_LUMINANCE);
+    ASSERT(m_glyphCount > 0);
+}
+
+/**
+ *  @returns the distance from point p to the line segment from a to b
+ */
+static float segmentDistance(float px, float py, float ax, float ay, float bx, float by)
+{
+    float dx = bx - ax, dy = by - ay;
+    float t = ((px - ax) * dx + (py - ay) * dy) / (dx * dx + dy * dy);
+
+    t = (t < 0.0f) ? 0.0f : ((t > 1.0f) ? 1.0f : t);
+    dx = px - (ax + t * dx);
+    dy = py - (ay + t * dy);
+    return sqrtf(dx * dx + dy * dy);
+}
+
+void TextTest::prepareAtlas()
+{
+    // Each glyph is built from up to seven strokes picked by the bits of a
+    // hash of its index, giving the atlas the sparse, varied coverage of a
+    // real font
+    static const float strokes[][4] =
+    {
+        {3,  2,  3,  13},       // Left
+        {12, 2,  12, 13},       // Right
+        {3,  2,  12, 2},        // Top
+        {3,  7,  12, 7},        // Middle
+        {3,  13, 12, 13},       // Bottom
+        {3,  13, 12, 2},        // Diagonal
+        {7.5f, 2, 7.5f, 13},    // Center
+    };
+    const int strokeCount = sizeof(strokes) / sizeof(strokes[0]);
+    int width = atlasColumns * glyphSize;
+    int height = atlasRows * glyphSize;
+    std::vector<unsigned char> pixels(width * height);
+
+    for (int glyph = 0; glyph < atlasColumns * atlasRows; glyph++)
+    {
+        unsigned hash = (glyph + 1) * 2654435761u;
+        int cellX = (glyph % atlasColumns) * glyphSize;
+        int cellY = (glyph / atlasColumns) * glyphSize;
+
+        for (int y = 0; y < glyphSize; y++)
+        {
+            for (int x = 0; x < glyphSize; x++)
+            {
+                float distance = glyphSize;
+                for (int i = 0; i < strokeCount; i++)
+                {
+                    if (hash & (1 << (i + 8)))
+                    {
+                        float d = segmentDistance(x + 0.5f, y + 0.5f,
+                                                  strokes[i][0], strokes[i][1],
+                                                  strokes[i][2], strokes[i][3]);
+                        distance = (d < distance) ? d : distance;
+                    }
+                }
+
+                // One pixel wide stroke with a one pixel antialiased edge
+                float coverage = 1.5f - distance;
+                coverage = (coverage < 0.0f) ? 0.0f : ((coverage > 1.0f) ? 1.0f : coverage);
+                pixels[(cellY + y) * width + cellX + x] =
+                    static_cast<unsigned char>(coverage * 255.0f);
+            }
+        }
+    }
+
+    glGenTextures(1, &m_atlas);
+    glBindTexture(GL_TEXTURE_2D, m_atlas);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexImage2D(GL_TEXTURE_2D, 0, m_atlasFormat, width, height, 0,
+                 m_atlasFormat, GL_UNSIGNED_BYTE, &pixels[0]);
+    ASSERT_GL();
+}
+
+void TextTest::prepareGeometry()
+{
+    EGLint surfaceWidth = 0, surfaceHeight = 0;
+    eglQuerySurface(ctx.dpy, ctx.surface, EGL_WIDTH, &surfaceWidth);
+    eglQuerySurface(ctx.dpy, ctx.surface, EGL_HEIGHT, &surfaceHeight);
+    ASSERT(surfaceWidth > glyphSize && surfaceHeight > lineHeight);
+
+    std::vector<GlyphVertex> vertices(m_glyphCount * 4);
+    float scaleX = 2.0f / surfaceWidth, scaleY = 2.0f / surfaceHeight;
+    float cellS = 1.0f / atlasColumns, cellT = 1.0f / atlasRows;
+    unsigned seed = 1;
+    int x = 0, y = 0, layer = 0;
+    int glyph = 0;
+
+    m_strings.clear();
+    while (glyph < m_glyphCount)
+    {
+        String string;
+
+        // Deterministic string lengths and colors
+        seed = seed * 1103515245 + 12345;
+        string.firstGlyph = glyph;
+        string.length = 4 + (seed >> 16) % 17;
+        if (string.length > m_glyphCount - glyph)
+        {
+            string.length = m_glyphCount - glyph;
+        }
+        GLubyte color[4] =
+        {
+            static_cast<GLubyte>(seed >> 8), static_cast<GLubyte>(seed >> 16),
+            static_cast<GLubyte>(seed >> 24), 0xff
+        };
+
+        if ((x + string.length * glyphAdvance) > surfaceWidth)
+        {
+            x = 0;
+            y += lineHeight;
+        }
+        if (y + glyphSize > surfaceHeight)
+        {
+            // Once the screen is full, offset the next layer slightly so that
+            // the glyphs still land on different pixels
+            layer++;
+            x = (layer * 3) % glyphAdvance;
+            y = (layer * 5) % lineHeight;
+        }
+
+        for (int i = 0; i < string.length; i++, glyph++)
+        {
+            seed = seed * 1103515245 + 12345;
+            int index = (seed >> 16) % (atlasColumns * atlasRows);
+            float s0 = (index % atlasColumns) * cellS;
+            float t0 = (index / atlasColumns) * cellT;
+            float x0 = x * scaleX - 1.0f, x1 = (x + glyphSize) * scaleX - 1.0f;
+            float y0 = 1.0f - y * scaleY, y1 = 1.0f - (y + glyphSize) * scaleY;
+            GlyphVertex* v = &vertices[glyph * 4];
+
+            v[0].x = x0; v[0].y = y0; v[0].s = s0;         v[0].t = t0;
+            v[1].x = x0; v[1].y = y1; v[1].s = s0;         v[1].t = t0 + cellT;
+            v[2].x = x1; v[2].y = y0; v[2].s = s0 + cellS; v[2].t = t0;
+            v[3].x = x1; v[3].y = y1; v[3].s = s0 + cellS; v[3].t = t0 + cellT;
+            for (int j = 0; j < 4; j++)
+            {
+                memcpy(v[j].color, color, sizeof(color));
+            }
+            x += glyphAdvance;
+        }
+        x += glyphAdvance;
+        m_strings.push_back(string);
+    }
+
+    if (m_batching == TEXT_BATCHED)
+    {
+        m_drawCalls = (m_glyphCount + maxBatchGlyphs - 1) / maxBatchGlyphs;
+    }
+    else
+    {
+        m_drawCalls = m_strings.size();
+    }
+
+    // Every batch starts from vertex zero, so a single index buffer covering
+    // the longest batch serves all draw calls
+    int indexedGlyphs = (m_glyphCount < maxBatchGlyphs) ? m_glyphCount : maxBatchGlyphs;
+    std::vector<GLushort> indices(indexedGlyphs * 6);
+    for (int i = 0; i < indexedGlyphs; i++)
+    {
+        indices[i * 6 + 0] = i * 4 + 0;
+        indices[i * 6 + 1] = i * 4 + 1;
+        indices[i * 6 + 2] = i * 4 + 2;
+        indices[i * 6 + 3] = i * 4 + 2;
+        indices[i * 6 + 4] = i * 4 + 1;
+        indices[i * 6 + 5] = i * 4 + 3;
+    }
+
+    glGenBuffers(1, &m_vertexBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, m_vertexBuffer);
+    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(GlyphVertex), &vertices[0],
+                 GL_STATIC_DRAW);
+
+    glGenBuffers(1, &m_indexBuffer);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indexBuffer);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLushort), &indices[0],
+                 GL_STATIC_DRAW);
+    ASSERT_GL();
+}
+
+void TextTest::prepare()
+{
+    m_program = createProgram(textVertSource,
+                              (m_atlasFormat == GL_ALPHA) ? textFragSourceA8 : textFragSourceL8);
+    glUseProgram(m_program);
+
+    m_positionAttr = glGetAttribLocation(m_program, "in_position");
+    m_texcoordAttr = glGetAttribLocation(m_program, "in_texcoord");
+    m_colorAttr = glGetAttribLocation(m_program, "in_color");
+    ASSERT(m_positionAttr >= 0);
+    ASSERT(m_texcoordAttr >= 0);
+    ASSERT(m_colorAttr >= 0);
+
+    glEnableVertexAttribArray(m_positionAttr);
+    glEnableVertexAttribArray(m_texcoordAttr);
+    glEnableVertexAttribArray(m_colorAttr);
+    glUniform1i(glGetUniformLocation(m_program, "texture"), 0);
+
+    prepareAtlas();
+    prepareGeometry();
+
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glClearColor(0.9f, 0.9f, 0.9f, 1.0f);
+    ASSERT_GL();
+}
+
+void TextTest::setVertexPointers(int firstGlyph)
+{
+    const char* base = reinterpret_cast<const char*>(firstGlyph * 4 * sizeof(GlyphVertex));
+
+    glVertexAttribPointer(m_positionAttr, 2, GL_FLOAT, GL_FALSE, sizeof(GlyphVertex),
+                          base + offsetof(GlyphVertex, x));
+    glVertexAttribPointer(m_texcoordAttr, 2, GL_FLOAT, GL_FALSE, sizeof(GlyphVertex),
+                          base + offsetof(GlyphVertex, s));
+    glVertexAttribPointer(m_colorAttr, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(GlyphVertex),
+                          base + offsetof(GlyphVertex, color));
+}
+
+void TextTest::operator()(int frame)
+{
+    // Warmup frames are all numbered zero
+    clock_gettime(CLOCK_REALTIME, &m_end);
+    if (frame == 0)
+    {
+        m_frames = 0;
+        m_start = m_end;
+    }
+    m_frames++;
+
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    if (m_batching == TEXT_BATCHED)
+    {
+        for (int first = 0; first < m_glyphCount; first += maxBatchGlyphs)
+        {
+            int count = m_glyphCount - first;
+            count = (count < maxBatchGlyphs) ? count : maxBatchGlyphs;
+            setVertexPointers(first);
+            glDrawElements(GL_TRIANGLES, count * 6, GL_UNSIGNED_SHORT, 0);
+        }
+    }
+    else
+    {
+        for (size_t i = 0; i < m_strings.size(); i++)
+        {
+            setVertexPointers(m_strings[i].firstGlyph);
+            glDrawElements(GL_TRIANGLES, m_strings[i].length * 6, GL_UNSIGNED_SHORT, 0);
+        }
+    }
+}
+
+void TextTest::teardown()
+{
+    glDisable(GL_BLEND);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    glDeleteBuffers(1, &m_vertexBuffer);
+    glDeleteBuffers(1, &m_indexBuffer);
+    glDeleteTextures(1, &m_atlas);
+    m_vertexBuffer = m_indexBuffer = m_atlas = 0;
+    m_strings.clear();
+
+    glUseProgram(0);
+    glDisableVertexAttribArray(m_positionAttr);
+    glDisableVertexAttribArray(m_texcoordAttr);
+    glDisableVertexAttribArray(m_colorAttr);
+    glDeleteProgram(m_program);
+    m_program = 0;
+    ASSERT_GL();
+}
+
+std::string TextTest::name() const
+{
+    std::stringstream s;
+
+    s << "text_" << ((m_atlasFormat == GL_ALPHA) ? "a8" : "l8");
+    s << "_" << ((m_batching == TEXT_BATCHED) ? "batched" : "strings");
+    s << "_" << m_glyphCount;
+
+    return s.str();
+}
+
+std::string TextTest::baselineName() const
+{
+    if (m_batching == TEXT_BATCHED)
+    {
+        return "";
+    }
+    return TextTest(TEXT_BATCHED, m_atlasFormat, m_glyphCount).name();
+}
+
+std::string TextTest::statistics() const
+{
+    char buf[64];
+    int64_t elapsed = timeDiff(m_start, m_end);
+
+    // Only the intervals between frame starts are timed
+    if (m_frames < 2 || elapsed <= 0)
+    {
+        return "";
+    }
+    snprintf(buf, sizeof(buf), "%7.2f Mglyphs/s %d draws",
+             (1000.0 * m_glyphCount * (m_frames - 1)) / elapsed, m_drawCalls);
+    return buf;
+}
@@ -0,0 +1,85 @@
+/**
+ * OpenGL ES 2.0 memory performance estimator
+ * Copyright (C) 2012 Google
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * \author Sami Kyöstilä <skyostil@google.com>
+ *
+ * Glyph atlas text rendering test
+ */
+#ifndef TEXTTEST_H
+#define TEXTTEST_H
+
+#include "test.h"
+#include <GLES2/gl2.h>
+#include <time.h>
+#include <vector>
+
+enum TextBatching
+{
+    TEXT_BATCHED,               //< As few draw calls as the index range allows
+    TEXT_PER_STRING,            //< One draw call per string
+};
+
+/**
+ *  Draws strings of alpha blended glyph quads sampled from a procedurally
+ *  generated single channel glyph atlas.
+ */
+class TextTest: public Test
+{
+protected:
+    struct String
+    {
+        int firstGlyph;
+        int length;
+    };
+
+    TextBatching m_batching;
+    GLenum m_atlasFormat;
+    int m_glyphCount;
+
+    GLint m_program;
+    GLint m_positionAttr, m_texcoordAttr, m_colorAttr;
+    GLuint m_atlas;
+    GLuint m_vertexBuffer, m_indexBuffer;
+    std::vector<String> m_strings;
+    int m_drawCalls;
+
+    int m_frames;
+    struct timespec m_start, m_end;
+
+public:
+    /**
+     *  @param batching         Draw call granularity
+     *  @param atlasFormat      GL_ALPHA or GL_LUMINANCE glyph atlas
+     *  @param glyphCount       Number of glyphs drawn per frame
+     */
+    TextTest(TextBatching batching, GLenum atlasFormat, int glyphCount);
+
+    void prepare();
+    void operator()(int frame);
+    void teardown();
+    std::string name() const;
+    std::string baselineName() const;
+    std::string statistics() const;
+
+protected:
+    void prepareAtlas();
+    void prepareGeometry();
+    void setVertexPointers(int firstGlyph);
+};
+
+#endif // TEXTTEST_H
@@ -0,0 +1,301 @@
+/**
+ * OpenGL ES 2.0 memory performance estimator
+ * Copyright (C) 2012 Google
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * \author Sami Kyöstilä <skyostil@google.com>
+ *
+ * Texture allocation churn test
+ */
+#include "texturechurntest.h"
+#include "memory.h"
+#include "util.h"
+
+#include <math.h>
+#include <sstream>
+#include <stdio.h>
+
+static const char* churnVertSource =
+    "precision mediump float;\n"
+    "attribute vec2 in_position;\n"
+    "attribute vec2 in_texcoord;\n"
+    "varying vec2 texcoord;\n"
+    "\n"
+    "void main()\n"
+    "{\n"
+    "	gl_Position = vec4(in_position, 0.0, 1.0);\n"
+    "	texcoord = in_texcoord;\n"
+    "}\n";
+
+static const char* churnFragSource =
+    "precision mediump float;\n"
+    "varying vec2 texcoord;\n"
+    "uniform sampler2D texture;\n"
+    "\n"
+    "void main()\n"
+    "{\n"
+    "	gl_FragColor = texture2D(texture, texcoord);\n"
+    "}\n";
+
+static int nextPowerOfTwo(int n)
+{
+    int result = 1;
+    while (result < n)
+    {
+        result <<= 1;
+    }
+    return result;
+}
+
+TextureChurnTest::TextureChurnTest(ChurnMode mode, int count, int size):
+    m_mode(mode),
+    m_count(count),
+    m_size(size),
+    m_program(0),
+    m_pooledTextures(0),
+    m_seed(1),
+    m_allocTime(0),
+    m_allocations(0),
+    m_initialMemory(0),
+    m_memoryGrowth(0)
+{
+    ASSERT(m_count >= 1 && m_size >= 2);
+}
+
+void TextureChurnTest::prepare()
+{
+    m_program = createProgram(churnVertSource, churnFragSource);
+    glUseProgram(m_program);
+
+    m_positionAttr = glGetAttribLocation(m_program, "in_position");
+    m_texcoordAttr = glGetAttribLocation(m_program, "in_texcoord");
+    ASSERT(m_positionAttr >= 0);
+    ASSERT(m_texcoordAttr >= 0);
+
+    glEnableVertexAttribArray(m_positionAttr);
+    glEnableVertexAttribArray(m_texcoordAttr);
+    glUniform1i(glGetUniformLocation(m_program, "texture"), 0);
+    glClearColor(0.2f, 0.4f, 0.6f, 1.0f);
+
+    m_pixels.resize(m_size * m_size * 4);
+    for (size_t i = 0; i < m_pixels.size(); i++)
+    {
+        m_pixels[i] = static_cast<unsigned char>(i ^ (i >> 9));
+    }
+    ASSERT_GL();
+
+    m_initialMemory = residentMemory();
+}
+
+TextureChurnTest::Texture TextureChurnTest::acquire(int width, int height)
+{
+    Texture texture;
+
+    texture.width = width;
+    texture.height = height;
+
+    if (m_mode == CHURN_POOL)
+    {
+        // Power of two buckets bound the number of distinct sizes
+        texture.allocWidth = nextPowerOfTwo(width);
+        texture.allocHeight = nextPowerOfTwo(height);
+
+        std::vector<GLuint>& bucket =
+            m_pool[std::make_pair(texture.allocWidth, texture.allocHeight)];
+
+        if (bucket.size())
+        {
+            texture.name = bucket.back();
+            bucket.pop_back();
+            glBindTexture(GL_TEXTURE_2D, texture.name);
+        }
+        else
+        {
+            glGenTextures(1, &texture.name);
+            glBindTexture(GL_TEXTURE_2D, texture.name);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, texture.allocWidth, texture.allocHeight,
+                         0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+            m_pooledTextures++;
+        }
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height,
+                        GL_RGBA, GL_UNSIGNED_BYTE, &m_pixels[0]);
+    }
+    else
+    {
+        texture.allocWidth = width;
+        texture.allocHeight = height;
+
+        glGenTextures(1, &texture.name);
+        glBindTexture(GL_TEXTURE_2D, texture.name);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0,
+                     GL_RGBA, GL_UNSIGNED_BYTE, &m_pixels[0]);
+    }
+
+    return texture;
+}
+
+void TextureChurnTest::release(const Texture& texture)
+{
+    if (m_mode == CHURN_POOL)
+    {
+        m_pool[std::make_pair(texture.allocWidth, texture.allocHeight)].push_back(texture.name);
+    }
+    else
+    {
+        glDeleteTextures(1, &texture.name);
+    }
+}
+
+void TextureChurnTest::draw(const Texture& texture, int index)
+{
+    // Lay the textures out on a square grid covering the screen
+    int columns = static_cast<int>(ceilf(sqrtf(static_cast<float>(m_count))));
+    float cell = 2.0f / columns;
+    float x0 = -1.0f + (index % columns) * cell;
+    float y0 = -1.0f + (index / columns) * cell;
+    float s = static_cast<float>(texture.width) / texture.allocWidth;
+    float t = static_cast<float>(texture.height) / texture.allocHeight;
+
+    const GLfloat vertices[] =
+    {
+        x0,        y0,
+        x0,        y0 + cell,
+        x0 + cell, y0,
+        x0 + cell, y0 + cell
+    };
+
+    const GLfloat texcoords[] =
+    {
+        0, t,
+        0, 0,
+        s, t,
+        s, 0
+    };
+
+    glBindTexture(GL_TEXTURE_2D, texture.name);
+    glVertexAttribPointer(m_positionAttr, 2, GL_FLOAT, GL_FALSE, 0, vertices);
+    glVertexAttribPointer(m_texcoordAttr, 2, GL_FLOAT, GL_FALSE, 0, texcoords);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+}
+
+void TextureChurnTest::operator()(int frame)
+{
+    // Warmup frames are all numbered zero
+    if (frame == 0)
+    {
+        m_stats.reset(0);
+        m_allocTime = 0;
+        m_allocations = 0;
+        m_seed = 1;
+    }
+    m_stats.frame();
+
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    struct timespec start, end;
+    for (int i = 0; i < m_count; i++)
+    {
+        // Deterministic sizes between half and the full size
+        m_seed = m_seed * 1103515245 + 12345;
+        int width = m_size / 2 + (m_seed >> 16) % (m_size / 2 + 1);
+        m_seed = m_seed * 1103515245 + 12345;
+        int height = m_size / 2 + (m_seed >> 16) % (m_size / 2 + 1);
+
+        clock_gettime(CLOCK_REALTIME, &start);
+        m_frameTextures.push_back(acquire(width, height));
+        clock_gettime(CLOCK_REALTIME, &end);
+        m_allocTime += timeDiff(start, end);
+        m_allocations++;
+
+        draw(m_frameTextures.back(), i);
+    }
+
+    for (size_t i = 0; i < m_frameTextures.size(); i++)
+    {
+        release(m_frameTextures[i]);
+    }
+    m_frameTextures.clear();
+}
+
+void TextureChurnTest::teardown()
+{
+    int64_t memory = residentMemory();
+    m_memoryGrowth = (memory >= 0 && m_initialMemory >= 0) ? memory - m_initialMemory : 0;
+
+    std::map<std::pair<int, int>, std::vector<GLuint> >::iterator i;
+    for (i = m_pool.begin(); i != m_pool.end(); ++i)
+    {
+        if (i->second.size())
+        {
+            glDeleteTextures(i->second.size(), &i->second[0]);
+        }
+    }
+    m_pool.clear();
+    m_pooledTextures = 0;
+
+    glUseProgram(0);
+    glDisableVertexAttribArray(m_positionAttr);
+    glDisableVertexAttribArray(m_texcoordAttr);
+    glDeleteProgram(m_program);
+    m_program = 0;
+    m_pixels.clear();
+}
+
+std::string TextureChurnTest::nameForMode(ChurnMode mode) const
+{
+    std::stringstream s;
+
+    s << "texchurn_" << ((mode == CHURN_POOL) ? "pool" : "create");
+    s << "_" << m_count << "x" << m_size;
+
+    return s.str();
+}
+
+std::string TextureChurnTest::name() const
+{
+    return nameForMode(m_mode);
+}
+
+std::string TextureChurnTest::baselineName() const
+{
+    if (m_mode == CHURN_CREATE_DELETE)
+    {
+        return "";
+    }
+    return nameForMode(CHURN_CREATE_DELETE);
+}
+
+std::string TextureChurnTest::statistics() const
+{
+    char buf[96];
+
+    if (!m_allocations)
+    {
+        return "";
+    }
+    snprintf(buf, sizeof(buf), "alloc %7.1f us/tex rss %+lld kB ",
+             m_allocTime / (1000.0f * m_allocations),
+             static_cast<long long>(m_memoryGrowth / 1024));
+    return buf + m_stats.summary();
+}
@@ -0,0 +1,87 @@
+/**
+ * OpenGL ES 2.0 memory performance estimator
+ * Copyright (C) 2012 Google
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * \author Sami Kyöstilä <skyostil@google.com>
+ *
+ * Texture allocation churn test
+ */
+#ifndef TEXTURECHURNTEST_H
+#define TEXTURECHURNTEST_H
+
+#include "test.h"
+#include "framestats.h"
+#include <GLES2/gl2.h>
+#include <map>
+#include <vector>
+
+enum ChurnMode
+{
+    CHURN_CREATE_DELETE,        //< New texture objects every frame
+    CHURN_POOL,                 //< Reuse textures from a size-bucketed pool
+};
+
+class TextureChurnTest: public Test
+{
+protected:
+    struct Texture
+    {
+        GLuint name;
+        int width, height;          //< Size of the contents
+        int allocWidth, allocHeight; //< Size of the texture object
+    };
+
+    ChurnMode m_mode;
+    int m_count;
+    int m_size;
+    GLint m_program;
+    GLint m_positionAttr, m_texcoordAttr;
+    std::vector<unsigned char> m_pixels;
+    std::vector<Texture> m_frameTextures;
+    std::map<std::pair<int, int>, std::vector<GLuint> > m_pool;
+    int m_pooledTextures;
+    unsigned m_seed;
+    FrameStatistics m_stats;
+    int64_t m_allocTime;
+    int m_allocations;
+    int64_t m_initialMemory;
+    int64_t m_memoryGrowth;
+
+public:
+    /**
+     *  @param mode             Texture allocation strategy
+     *  @param count            Number of textures drawn per frame
+     *  @param size             Maximum texture dimension; actual sizes vary
+     *                          between half and the full size
+     */
+    TextureChurnTest(ChurnMode mode, int count, int size);
+
+    void prepare();
+    void operator()(int frame);
+    void teardown();
+    std::string name() const;
+    std::string baselineName() const;
+    std::string statistics() const;
+
+protected:
+    std::string nameForMode(ChurnMode mode) const;
+    Texture acquire(int width, int height);
+    void release(const Texture& texture);
+    void draw(const Texture& texture, int index);
+};
+
+#endif // TEXTURECHURNTEST_H
@@ -0,0 +1,251 @@
+/**
+ * OpenGL ES 2.0 memory performance estimator
+ * Copyright (C) 2012 Google
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * \author Sami Kyöstilä <skyostil@google.com>
+ *
+ * Texture memory oversubscription test
+ */
+#include "texturethrashtest.h"
+#include "memory.h"
+#include "util.h"
+
+#include <sstream>
+#include <stdio.h>
+#include <stdlib.h>
+
+static const char* thrashVertSource =
+    "precision mediump float;\n"
+    "attribute vec2 in_position;\n"
+    "attribute vec2 in_texcoord;\n"
+    "varying vec2 texcoord;\n"
+    "\n"
+    "void main()\n"
+    "{\n"
+    "	gl_Position = vec4(in_position, 0.0, 1.0);\n"
+    "	texcoord = in_texcoord;\n"
+    "}\n";
+
+static const char* thrashFragSource =
+    "precision mediump float;\n"
+    "varying vec2 texcoord;\n"
+    "uniform sampler2D texture;\n"
+    "\n"
+    "void main()\n"
+    "{\n"
+    "	gl_FragColor = texture2D(texture, texcoord);\n"
+    "}\n";
+
+bool parseThrashPercents(const std::string& list, std::vector<int>& percents)
+{
+    std::stringstream s(list);
+    std::string item;
+
+    percents.clear();
+    while (std::getline(s, item, ','))
+    {
+        char* end;
+        long percent = strtol(item.c_str(), &end, 10);
+        if (item.empty() || *end || percent < 1 || percent > 99)
+        {
+            return false;
+        }
+        percents.push_back(static_cast<int>(percent));
+    }
+    return !percents.empty();
+}
+
+TextureThrashTest::TextureThrashTest(int percent, int baselinePercent):
+    m_percent(percent),
+    m_baselinePercent(baselinePercent),
+    m_textureSize(512),
+    m_texturesPerFrame(16),
+    m_program(0),
+    m_allocated(0),
+    m_targetBytes(0),
+    m_outOfMemory(false),
+    m_next(0)
+{
+    ASSERT(m_percent > 0);
+}
+
+int64_t TextureThrashTest::textureBytes() const
+{
+    return static_cast<int64_t>(m_textureSize) * m_textureSize * 4;
+}
+
+void TextureThrashTest::prepare()
+{
+    int64_t total = systemMemory();
+    ASSERT(total > 0);
+    m_targetBytes = total * m_percent / 100;
+
+    m_program = createProgram(thrashVertSource, thrashFragSource);
+    glUseProgram(m_program);
+
+    m_positionAttr = glGetAttribLocation(m_program, "in_position");
+    m_texcoordAttr = glGetAttribLocation(m_program, "in_texcoord");
+    ASSERT(m_positionAttr >= 0);
+    ASSERT(m_texcoordAttr >= 0);
+
+    glEnableVertexAttribArray(m_positionAttr);
+    glEnableVertexAttribArray(m_texcoordAttr);
+    glUniform1i(glGetUniformLocation(m_program, "texture"), 0);
+    glClearColor(0.2f, 0.4f, 0.6f, 1.0f);
+    ASSERT_GL();
+
+    std::vector<unsigned char> pixels(textureBytes());
+    for (size_t i = 0; i < pixels.size(); i++)
+    {
+        pixels[i] = static_cast<unsigned char>(i ^ (i >> 11));
+    }
+
+    m_outOfMemory = false;
+    while (static_cast<int64_t>(m_textures.size()) * textureBytes() < m_targetBytes)
+    {
+        GLuint texture;
+
+        // Vary the contents so that the driver can't share storage
+        pixels[0] = static_cast<unsigned char>(m_textures.size());
+
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, m_textureSize, m_textureSize, 0,
+                     GL_RGBA, GL_UNSIGNED_BYTE, &pixels[0]);
+
+        GLenum err = glGetError();
+        if (err == GL_OUT_OF_MEMORY)
+        {
+            glDeleteTextures(1, &texture);
+            m_outOfMemory = true;
+            break;
+        }
+        if (err != GL_NO_ERROR)
+        {
+            // teardown() is not called for a test that fails to prepare, and
+            // the textures may be holding most of the system memory
+            char msg[64];
+            snprintf(msg, sizeof(msg), "GL error 0x%x after %d textures",
+                     err, static_cast<int>(m_textures.size()));
+            glDeleteTextures(1, &texture);
+            teardown();
+            fail(msg);
+        }
+        m_textures.push_back(texture);
+    }
+    if (m_textures.empty())
+    {
+        teardown();
+        fail("Out of memory before the first texture");
+    }
+    m_allocated = m_textures.size();
+    m_next = 0;
+}
+
+void TextureThrashTest::operator()(int frame)
+{
+    // Warmup frames are all numbered zero
+    if (frame == 0)
+    {
+        m_stats.reset(0);
+    }
+    m_stats.frame();
+
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    const int columns = 4;
+    const float cell = 2.0f / columns;
+    const GLfloat texcoords[] =
+    {
+        0, 1,
+        0, 0,
+        1, 1,
+        1, 0
+    };
+    glVertexAttribPointer(m_texcoordAttr, 2, GL_FLOAT, GL_FALSE, 0, texcoords);
+
+    for (int i = 0; i < m_texturesPerFrame; i++)
+    {
+        float x0 = -1.0f + (i % columns) * cell;
+        float y0 = -1.0f + ((i / columns) % columns) * cell;
+        const GLfloat vertices[] =
+        {
+            x0,        y0,
+            x0,        y0 + cell,
+            x0 + cell, y0,
+            x0 + cell, y0 + cell
+        };
+
+        // Rotate through the whole set so every texture is eventually used
+        glBindTexture(GL_TEXTURE_2D, m_textures[m_next]);
+        m_next = (m_next + 1) % m_textures.size();
+
+        glVertexAttribPointer(m_positionAttr, 2, GL_FLOAT, GL_FALSE, 0, vertices);
+        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    }
+}
+
+void TextureThrashTest::teardown()
+{
+    if (m_textures.size())
+    {
+        glDeleteTextures(m_textures.size(), &m_textures[0]);
+    }
+    m_textures.clear();
+
+    glUseProgram(0);
+    glDisableVertexAttribArray(m_positionAttr);
+    glDisableVertexAttribArray(m_texcoordAttr);
+    glDeleteProgram(m_program);
+    m_program = 0;
+}
+
+std::string TextureThrashTest::nameForPercent(int percent) const
+{
+    std::stringstream s;
+
+    s << "texthrash_" << percent << "pct";
+
+    return s.str();
+}
+
+std::string TextureThrashTest::name() const
+{
+    return nameForPercent(m_percent);
+}
+
+std::string TextureThrashTest::baselineName() const
+{
+    if (!m_baselinePercent)
+    {
+        return "";
+    }
+    return nameForPercent(m_baselinePercent);
+}
+
+std::string TextureThrashTest::statistics() const
+{
+    char buf[96];
+    int64_t setBytes = m_allocated * textureBytes();
+
+    snprintf(buf, sizeof(buf), "set %5lld MB (%d tex%s) ",
+             static_cast<long long>(setBytes / (1024 * 1024)),
+             m_allocated, m_outOfMemory ? ", out of memory" : "");
+    return buf + m_stats.summary();
+}
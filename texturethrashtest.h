@@ -0,0 +1,89 @@
+/**
+ * OpenGL ES 2.0 memory performance estimator
+ * Copyright (C) 2012 Google
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * \author Sami Kyöstilä <skyostil@google.com>
+ *
+ * Texture memory oversubscription test
+ */
+#ifndef TEXTURETHRASHTEST_H
+#define TEXTURETHRASHTEST_H
+
+#include "test.h"
+#include "framestats.h"
+#include <GLES2/gl2.h>
+#include <string>
+#include <vector>
+
+/** Default texture set sizes as percentages of total system memory */
+#define TEXTURE_THRASH_DEFAULT_PERCENTS "4,8,16,32,64"
+
+/**
+ *  Parse a comma separated list of texture set sizes
+ *
+ *  @param list                 List of percentages of total system memory,
+ *                              each between 1 and 99
+ *  @param percents             Output: parsed percentages
+ *
+ *  @returns true on success, false if the list is invalid
+ */
+bool parseThrashPercents(const std::string& list, std::vector<int>& percents);
+
+/**
+ *  Allocates textures until they add up to a given share of system memory
+ *  or the driver runs out of memory, then draws a working set that rotates
+ *  through all of them. Running the test at increasing sizes shows how the
+ *  driver copes once the textures no longer fit in memory.
+ */
+class TextureThrashTest: public Test
+{
+protected:
+    int m_percent;
+    int m_baselinePercent;
+    int m_textureSize;
+    int m_texturesPerFrame;
+    GLint m_program;
+    GLint m_positionAttr, m_texcoordAttr;
+    std::vector<GLuint> m_textures;
+    int m_allocated;
+    int64_t m_targetBytes;
+    bool m_outOfMemory;
+    size_t m_next;
+    FrameStatistics m_stats;
+
+public:
+    /**
+     *  @param percent          Size of the texture set as a percentage of
+     *                          total system memory
+     *  @param baselinePercent  Size of the texture set to compare against,
+     *                          or zero for none
+     */
+    TextureThrashTest(int percent, int baselinePercent = 0);
+
+    void prepare();
+    void operator()(int frame);
+    void teardown();
+    std::string name() const;
+    std::string baselineName() const;
+    std::string statistics() const;
+
+protected:
+    std::string nameForPercent(int percent) const;
+    int64_t textureBytes() const;
+};
+
+#endif // TEXTURETHRASHTEST_H
@@ -0,0 +1,142 @@
+/**
+ * OpenGL ES 2.0 memory performance estimator
+ * Copyright (C) 2012 Google
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * \author Sami Kyöstilä <skyostil@google.com>
+ *
+ * OpenGL ES 2.0 command stream trace format
+ *
+ * A trace starts with a TraceHeader followed by a sequence of records.
+ * Each record is a TraceRecord, argCount 32-bit arguments and dataSize bytes
+ * of inline data padded to a multiple of four bytes. Floating point
+ * arguments are stored as their bit patterns. All values are in the byte
+ * order of the capturing machine.
+ *
+ * Object names, uniform locations and attribute locations are stored as
+ * seen by the captured application; the replayer maps them to its own.
+ * Calls returning a name or location store the result as their last
+ * argument. Pointer arguments are stored as inline data, or as an offset
+ * when a buffer object provided the data, in which case dataSize is zero.
+ * Client side vertex arrays are recorded at draw time with enough data
+ * for the vertices the draw call referenced.
+ */
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+
+#define TRACE_MAGIC     0x544d4c47      // "GLMT"
+#define TRACE_VERSION   2
+
+struct TraceHeader
+{
+    uint32_t magic;
+    uint32_t version;
+};
+
+struct TraceRecord
+{
+    uint16_t opcode;
+    uint16_t argCount;
+    uint32_t dataSize;
+};
+
+enum TraceOpcode
+{
+    TRACE_SWAP_BUFFERS,             //< End of a frame
+    TRACE_ACTIVE_TEXTURE,
+    TRACE_ATTACH_SHADER,
+    TRACE_BIND_ATTRIB_LOCATION,     //< Name as data
+    TRACE_BIND_BUFFER,
+    TRACE_BIND_FRAMEBUFFER,
+    TRACE_BIND_RENDERBUFFER,
+    TRACE_BIND_TEXTURE,
+    TRACE_BLEND_COLOR,
+    TRACE_BLEND_EQUATION,
+    TRACE_BLEND_EQUATION_SEPARATE,
+    TRACE_BLEND_FUNC,
+    TRACE_BLEND_FUNC_SEPARATE,
+    TRACE_BUFFER_DATA,
+    TRACE_BUFFER_SUB_DATA,
+    TRACE_CLEAR,
+    TRACE_CLEAR_COLOR,
+    TRACE_CLEAR_DEPTH,
+    TRACE_CLEAR_STENCIL,
+    TRACE_COLOR_MASK,
+    TRACE_COMPILE_SHADER,
+    TRACE_COMPRESSED_TEX_IMAGE_2D,
+    TRACE_COMPRESSED_TEX_SUB_IMAGE_2D,
+    TRACE_COPY_TEX_IMAGE_2D,
+    TRACE_COPY_TEX_SUB_IMAGE_2D,
+    TRACE_CREATE_PROGRAM,
+    TRACE_CREATE_SHADER,
+    TRACE_CULL_FACE,
+    TRACE_DELETE_BUFFERS,           //< Names as data
+    TRACE_DELETE_FRAMEBUFFERS,
+    TRACE_DELETE_PROGRAM,
+    TRACE_DELETE_RENDERBUFFERS,
+    TRACE_DELETE_SHADER,
+    TRACE_DELETE_TEXTURES,
+    TRACE_DEPTH_FUNC,
+    TRACE_DEPTH_MASK,
+    TRACE_DEPTH_RANGE,
+    TRACE_DISABLE,
+    TRACE_DISABLE_VERTEX_ATTRIB_ARRAY,
+    TRACE_DRAW_ARRAYS,
+    TRACE_DRAW_ELEMENTS,
+    TRACE_ENABLE,
+    TRACE_ENABLE_VERTEX_ATTRIB_ARRAY,
+    TRACE_FINISH,
+    TRACE_FLUSH,
+    TRACE_FRAMEBUFFER_RENDERBUFFER,
+    TRACE_FRAMEBUFFER_TEXTURE_2D,
+    TRACE_FRONT_FACE,
+    TRACE_GEN_BUFFERS,              //< Generated names as data
+    TRACE_GEN_FRAMEBUFFERS,
+    TRACE_GEN_RENDERBUFFERS,
+    TRACE_GEN_TEXTURES,
+    TRACE_GENERATE_MIPMAP,
+    TRACE_GET_ATTRIB_LOCATION,      //< Name as data
+    TRACE_GET_UNIFORM_LOCATION,     //< Name as data
+    TRACE_HINT,
+    TRACE_LINE_WIDTH,
+    TRACE_LINK_PROGRAM,
+    TRACE_PIXEL_STOREI,
+    TRACE_POLYGON_OFFSET,
+    TRACE_RENDERBUFFER_STORAGE,
+    TRACE_SCISSOR,
+    TRACE_SHADER_SOURCE,            //< Concatenated source strings as data
+    TRACE_STENCIL_FUNC_SEPARATE,
+    TRACE_STENCIL_MASK_SEPARATE,
+    TRACE_STENCIL_OP_SEPARATE,
+    TRACE_TEX_IMAGE_2D,
+    TRACE_TEX_PARAMETERF,
+    TRACE_TEX_PARAMETERI,
+    TRACE_TEX_SUB_IMAGE_2D,
+    TRACE_UNIFORMF,                 //< Location, component count, values
+    TRACE_UNIFORMI,                 //< Location, component count, values
+    TRACE_UNIFORMFV,                //< Location, component count, count
+    TRACE_UNIFORMIV,                //< Location, component count, count
+    TRACE_UNIFORM_MATRIXFV,         //< Location, dimension, count, transpose
+    TRACE_USE_PROGRAM,
+    TRACE_VERTEX_ATTRIB_4F,
+    TRACE_VERTEX_ATTRIB_POINTER,
+    TRACE_VIEWPORT,
+    TRACE_OPCODE_COUNT
+};
+
+#endif // TRACE_H
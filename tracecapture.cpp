@@ -0,0 +1,1037 @@
+/**
+ * OpenGL ES 2.0 memory performance estimator
+ * Copyright (C) 2012 Google
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * \author Sami Kyöstilä <skyostil@google.com>
+ *
+ * OpenGL ES 2.0 command stream capture library
+ *
+ * Usage:
+ *
+ *     GLMEMPERF_TRACE=app.trace LD_PRELOAD=glmemperf-capture.so app
+ *
+ * GLMEMPERF_TRACE_FRAMES limits the number of captured frames. The
+ * application is expected to render from a single thread.
+ */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include "trace.h"
+
+#include <EGL/egl.h>
+#include <GLES2/gl2.h>
+#include <dlfcn.h>
+#include <map>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+/** Looks up the implementation being interposed */
+#define REAL(NAME) ((__typeof__(&NAME))realFunction(#NAME))
+
+static const int maxVertexAttribs = 16;
+
+/** Client side vertex array state, recorded when a draw call uses it */
+struct AttribState
+{
+    bool enabled;
+    bool client;
+    GLint size;
+    GLenum type;
+    GLboolean normalized;
+    GLsizei stride;
+    const void* pointer;
+};
+
+static pthread_mutex_t traceMutex = PTHREAD_MUTEX_INITIALIZER;
+static FILE* traceFile;
+static bool traceFinished;
+static int traceFrames;
+static int traceFrameLimit;
+
+static GLuint arrayBuffer, elementArrayBuffer;
+static AttribState attribs[maxVertexAttribs];
+
+/** Index buffer contents, which GLES 2.0 cannot read back */
+static std::map<GLuint, std::vector<char> > elementBuffers;
+
+static void* realFunction(const char* name)
+{
+    void* function = dlsym(RTLD_NEXT, name);
+    if (!function)
+    {
+        fprintf(stderr, "glmemperf-capture: %s not found\n", name);
+        abort();
+    }
+    return function;
+}
+
+static uint32_t floatBits(GLfloat value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static bool openTrace()
+{
+    if (traceFile)
+    {
+        return true;
+    }
+    if (traceFinished)
+    {
+        return false;
+    }
+
+    const char* fileName = getenv("GLMEMPERF_TRACE");
+    const char* frames = getenv("GLMEMPERF_TRACE_FRAMES");
+    traceFrameLimit = frames ? atoi(frames) : 0;
+    traceFile = fopen(fileName ? fileName : "glmemperf.trace", "wb");
+    if (!traceFile)
+    {
+        perror("glmemperf-capture: fopen");
+        traceFinished = true;
+        return false;
+    }
+
+    TraceHeader header;
+    header.magic = TRACE_MAGIC;
+    header.version = TRACE_VERSION;
+    fwrite(&header, sizeof(header), 1, traceFile);
+    return true;
+}
+
+/**
+ *  Append a record to the trace
+ *
+ *  @param opcode               Call identifier
+ *  @param data                 Inline data or NULL
+ *  @param dataSize             Size of the inline data in bytes
+ *  @param argCount             Number of 32-bit arguments that follow
+ */
+static void record(TraceOpcode opcode, const void* data, size_t dataSize, int argCount, ...)
+{
+    static const char padding[4] = {0};
+    TraceRecord rec;
+    va_list ap;
+
+    pthread_mutex_lock(&traceMutex);
+    if (!openTrace())
+    {
+        pthread_mutex_unlock(&traceMutex);
+        return;
+    }
+
+    rec.opcode = opcode;
+    rec.argCount = argCount;
+    rec.dataSize = data ? dataSize : 0;
+    fwrite(&rec, sizeof(rec), 1, traceFile);
+
+    va_start(ap, argCount);
+    for (int i = 0; i < argCount; i++)
+    {
+        uint32_t arg = va_arg(ap, uint32_t);
+        fwrite(&arg, sizeof(arg), 1, traceFile);
+    }
+    va_end(ap);
+
+    if (data && rec.dataSize)
+    {
+        fwrite(data, rec.dataSize, 1, traceFile);
+        fwrite(padding, (4 - (rec.dataSize & 3)) & 3, 1, traceFile);
+    }
+
+    if (opcode == TRACE_SWAP_BUFFERS)
+    {
+        fflush(traceFile);
+        if (traceFrameLimit && ++traceFrames >= traceFrameLimit)
+        {
+            fclose(traceFile);
+            traceFile = 0;
+            traceFinished = true;
+        }
+    }
+    pthread_mutex_unlock(&traceMutex);
+}
+
+static size_t typeSize(GLenum type)
+{
+    switch (type)
+    {
+    case GL_BYTE:
+    case GL_UNSIGNED_BYTE:
+        return 1;
+    case GL_SHORT:
+    case GL_UNSIGNED_SHORT:
+        return 2;
+    default:
+        return 4;
+    }
+}
+
+/**
+ *  @returns the size of a tightly packed client side image
+ */
+static size_t imageSize(GLsizei width, GLsizei height, GLenum format, GLenum type)
+{
+    size_t pixelSize;
+    GLint alignment = 4;
+
+    switch (type)
+    {
+    case GL_UNSIGNED_SHORT_5_6_5:
+    case GL_UNSIGNED_SHORT_4_4_4_4:
+    case GL_UNSIGNED_SHORT_5_5_5_1:
+        pixelSize = 2;
+        break;
+    default:
+        switch (format)
+        {
+        case GL_ALPHA:
+        case GL_LUMINANCE:
+            pixelSize = 1;
+            break;
+        case GL_LUMINANCE_ALPHA:
+            pixelSize = 2;
+            break;
+        case GL_RGB:
+            pixelSize = 3;
+            break;
+        default:
+            pixelSize = 4;
+            break;
+        }
+        pixelSize *= typeSize(type);
+        break;
+    }
+
+    REAL(glGetIntegerv)(GL_UNPACK_ALIGNMENT, &alignment);
+    size_t stride = (width * pixelSize + alignment - 1) / alignment * alignment;
+    return height ? stride * (height - 1) + width * pixelSize : 0;
+}
+
+/**
+ *  Record the client side vertex arrays used by a draw call that references
+ *  vertices up to, but not including, the given index
+ */
+static void recordClientArrays(GLuint vertexCount)
+{
+    if (!vertexCount)
+    {
+        return;
+    }
+
+    for (int i = 0; i < maxVertexAttribs; i++)
+    {
+        const AttribState& a = attribs[i];
+        if (!a.enabled || !a.client || !a.pointer)
+        {
+            continue;
+        }
+
+        size_t elementSize = a.size * typeSize(a.type);
+        size_t stride = a.stride ? a.stride : elementSize;
+        record(TRACE_VERTEX_ATTRIB_POINTER, a.pointer, stride * (vertexCount - 1) + elementSize,
+               6, i, a.size, a.type, a.normalized, a.stride, 0);
+    }
+}
+
+static bool hasClientArrays()
+{
+    for (int i = 0; i < maxVertexAttribs; i++)
+    {
+        if (attribs[i].enabled && attribs[i].client)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+extern "C" {
+
+GL_APICALL void GL_APIENTRY glActiveTexture(GLenum texture)
+{
+    REAL(glActiveTexture)(texture);
+    record(TRACE_ACTIVE_TEXTURE, NULL, 0, 1, texture);
+}
+
+GL_APICALL void GL_APIENTRY glAttachShader(GLuint program, GLuint shader)
+{
+    REAL(glAttachShader)(program, shader);
+    record(TRACE_ATTACH_SHADER, NULL, 0, 2, program, shader);
+}
+
+GL_APICALL void GL_APIENTRY glBindAttribLocation(GLuint program, GLuint index, const GLchar* name)
+{
+    REAL(glBindAttribLocation)(program, index, name);
+    record(TRACE_BIND_ATTRIB_LOCATION, name, strlen(name) + 1, 2, program, index);
+}
+
+GL_APICALL void GL_APIENTRY glBindBuffer(GLenum target, GLuint buffer)
+{
+    REAL(glBindBuffer)(target, buffer);
+    if (target == GL_ARRAY_BUFFER)
+    {
+        arrayBuffer = buffer;
+    }
+    else if (target == GL_ELEMENT_ARRAY_BUFFER)
+    {
+        elementArrayBuffer = buffer;
+    }
+    record(TRACE_BIND_BUFFER, NULL, 0, 2, target, buffer);
+}
+
+GL_APICALL void GL_APIENTRY glBindFramebuffer(GLenum target, GLuint framebuffer)
+{
+    REAL(glBindFramebuffer)(target, framebuffer);
+    record(TRACE_BIND_FRAMEBUFFER, NULL, 0, 2, target, framebuffer);
+}
+
+GL_APICALL void GL_APIENTRY glBindRenderbuffer(GLenum target, GLuint renderbuffer)
+{
+    REAL(glBindRenderbuffer)(target, renderbuffer);
+    record(TRACE_BIND_RENDERBUFFER, NULL, 0, 2, target, renderbuffer);
+}
+
+GL_APICALL void GL_APIENTRY glBindTexture(GLenum target, GLuint texture)
+{
+    REAL(glBindTexture)(target, texture);
+    record(TRACE_BIND_TEXTURE, NULL, 0, 2, target, texture);
+}
+
+GL_APICALL void GL_APIENTRY glBlendColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha)
+{
+    REAL(glBlendColor)(red, green, blue, alpha);
+    record(TRACE_BLEND_COLOR, NULL, 0, 4,
+           floatBits(red), floatBits(green), floatBits(blue), floatBits(alpha));
+}
+
+GL_APICALL void GL_APIENTRY glBlendEquation(GLenum mode)
+{
+    REAL(glBlendEquation)(mode);
+    record(TRACE_BLEND_EQUATION, NULL, 0, 1, mode);
+}
+
+GL_APICALL void GL_APIENTRY glBlendEquationSeparate(GLenum modeRGB, GLenum modeAlpha)
+{
+    REAL(glBlendEquationSeparate)(modeRGB, modeAlpha);
+    record(TRACE_BLEND_EQUATION_SEPARATE, NULL, 0, 2, modeRGB, modeAlpha);
+}
+
+GL_APICALL void GL_APIENTRY glBlendFunc(GLenum sfactor, GLenum dfactor)
+{
+    REAL(glBlendFunc)(sfactor, dfactor);
+    record(TRACE_BLEND_FUNC, NULL, 0, 2, sfactor, dfactor);
+}
+
+GL_APICALL void GL_APIENTRY glBlendFuncSeparate(GLenum srcRGB, GLenum dstRGB,
+                                                GLenum srcAlpha, GLenum dstAlpha)
+{
+    REAL(glBlendFuncSeparate)(srcRGB, dstRGB, srcAlpha, dstAlpha);
+    record(TRACE_BLEND_FUNC_SEPARATE, NULL, 0, 4, srcRGB, dstRGB, srcAlpha, dstAlpha);
+}
+
+GL_APICALL void GL_APIENTRY glBufferData(GLenum target, GLsizeiptr size, const void* data,
+                                         GLenum usage)
+{
+    REAL(glBufferData)(target, size, data, usage);
+    if (target == GL_ELEMENT_ARRAY_BUFFER)
+    {
+        std::vector<char>& shadow = elementBuffers[elementArrayBuffer];
+        shadow.assign(size, 0);
+        if (data && size)
+        {
+            memcpy(&shadow[0], data, size);
+        }
+    }
+    record(TRACE_BUFFER_DATA, data, size, 3, target, size, usage);
+}
+
+GL_APICALL void GL_APIENTRY glBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size,
+                                            const void* data)
+{
+    REAL(glBufferSubData)(target, offset, size, data);
+    if (target == GL_ELEMENT_ARRAY_BUFFER)
+    {
+        std::vector<char>& shadow = elementBuffers[elementArrayBuffer];
+        if (offset + size <= static_cast<GLintptr>(shadow.size()))
+        {
+            memcpy(&shadow[offset], data, size);
+        }
+    }
+    record(TRACE_BUFFER_SUB_DATA, data, size, 3, target, offset, size);
+}
+
+GL_APICALL void GL_APIENTRY glClear(GLbitfield mask)
+{
+    REAL(glClear)(mask);
+    record(TRACE_CLEAR, NULL, 0, 1, mask);
+}
+
+GL_APICALL void GL_APIENTRY glClearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha)
+{
+    REAL(glClearColor)(red, green, blue, alpha);
+    record(TRACE_CLEAR_COLOR, NULL, 0, 4,
+           floatBits(red), floatBits(green), floatBits(blue), floatBits(alpha));
+}
+
+GL_APICALL void GL_APIENTRY glClearDepthf(GLfloat d)
+{
+    REAL(glClearDepthf)(d);
+    record(TRACE_CLEAR_DEPTH, NULL, 0, 1, floatBits(d));
+}
+
+GL_APICALL void GL_APIENTRY glClearStencil(GLint s)
+{
+    REAL(glClearStencil)(s);
+    record(TRACE_CLEAR_STENCIL, NULL, 0, 1, s);
+}
+
+GL_APICALL void GL_APIENTRY glColorMask(GLboolean red, GLboolean green, GLboolean blue,
+                                        GLboolean alpha)
+{
+    REAL(glColorMask)(red, green, blue, alpha);
+    record(TRACE_COLOR_MASK, NULL, 0, 4, red, green, blue, alpha);
+}
+
+GL_APICALL void GL_APIENTRY glCompileShader(GLuint shader)
+{
+    REAL(glCompileShader)(shader);
+    record(TRACE_COMPILE_SHADER, NULL, 0, 1, shader);
+}
+
+GL_APICALL void GL_APIENTRY glCompressedTexImage2D(GLenum target, GLint level,
+                                                   GLenum internalformat, GLsizei width,
+                                                   GLsizei height, GLint border,
+                                                   GLsizei imageSize, const void* data)
+{
+    REAL(glCompressedTexImage2D)(target, level, internalformat, width, height, border,
+                                 imageSize, data);
+    record(TRACE_COMPRESSED_TEX_IMAGE_2D, data, imageSize, 7,
+           target, level, internalformat, width, height, border, imageSize);
+}
+
+GL_APICALL void GL_APIENTRY glCompressedTexSubImage2D(GLenum target, GLint level,
+                                                      GLint xoffset, GLint yoffset,
+                                                      GLsizei width, GLsizei height,
+                                                      GLenum format, GLsizei imageSize,
+                                                      const void* data)
+{
+    REAL(glCompressedTexSubImage2D)(target, level, xoffset, yoffset, width, height, format,
+                                    imageSize, data);
+    record(TRACE_COMPRESSED_TEX_SUB_IMAGE_2D, data, imageSize, 8,
+           target, level, xoffset, yoffset, width, height, format, imageSize);
+}
+
+GL_APICALL void GL_APIENTRY glCopyTexImage2D(GLenum target, GLint level,
+                                             GLenum internalformat, GLint x, GLint y,
+                                             GLsizei width, GLsizei height, GLint border)
+{
+    REAL(glCopyTexImage2D)(target, level, internalformat, x, y, width, height, border);
+    record(TRACE_COPY_TEX_IMAGE_2D, NULL, 0, 8,
+           target, level, internalformat, x, y, width, height, border);
+}
+
+GL_APICALL void GL_APIENTRY glCopyTexSubImage2D(GLenum target, GLint level, GLint xoffset,
+                                                GLint yoffset, GLint x, GLint y,
+                                                GLsizei width, GLsizei height)
+{
+    REAL(glCopyTexSubImage2D)(target, level, xoffset, yoffset, x, y, width, height);
+    record(TRACE_COPY_TEX_SUB_IMAGE_2D, NULL, 0, 8,
+           target, level, xoffset, yoffset, x, y, width, height);
+}
+
+GL_APICALL GLuint GL_APIENTRY glCreateProgram(void)
+{
+    GLuint program = REAL(glCreateProgram)();
+    record(TRACE_CREATE_PROGRAM, NULL, 0, 1, program);
+    return program;
+}
+
+GL_APICALL GLuint GL_APIENTRY glCreateShader(GLenum type)
+{
+    GLuint shader = REAL(glCreateShader)(type);
+    record(TRACE_CREATE_SHADER, NULL, 0, 2, type, shader);
+    return shader;
+}
+
+GL_APICALL void GL_APIENTRY glCullFace(GLenum mode)
+{
+    REAL(glCullFace)(mode);
+    record(TRACE_CULL_FACE, NULL, 0, 1, mode);
+}
+
+GL_APICALL void GL_APIENTRY glDeleteBuffers(GLsizei n, const GLuint* buffers)
+{
+    REAL(glDeleteBuffers)(n, buffers);
+    for (GLsizei i = 0; i < n; i++)
+    {
+        elementBuffers.erase(buffers[i]);
+    }
+    record(TRACE_DELETE_BUFFERS, buffers, n * sizeof(GLuint), 1, n);
+}
+
+GL_APICALL void GL_APIENTRY glDeleteFramebuffers(GLsizei n, const GLuint* framebuffers)
+{
+    REAL(glDeleteFramebuffers)(n, framebuffers);
+    record(TRACE_DELETE_FRAMEBUFFERS, framebuffers, n * sizeof(GLuint), 1, n);
+}
+
+GL_APICALL void GL_APIENTRY glDeleteProgram(GLuint program)
+{
+    REAL(glDeleteProgram)(program);
+    record(TRACE_DELETE_PROGRAM, NULL, 0, 1, program);
+}
+
+GL_APICALL void GL_APIENTRY glDeleteRenderbuffers(GLsizei n, const GLuint* renderbuffers)
+{
+    REAL(glDeleteRenderbuffers)(n, renderbuffers);
+    record(TRACE_DELETE_RENDERBUFFERS, renderbuffers, n * sizeof(GLuint), 1, n);
+}
+
+GL_APICALL void GL_APIENTRY glDeleteShader(GLuint shader)
+{
+    REAL(glDeleteShader)(shader);
+    record(TRACE_DELETE_SHADER, NULL, 0, 1, shader);
+}
+
+GL_APICALL void GL_APIENTRY glDeleteTextures(GLsizei n, const GLuint* textures)
+{
+    REAL(glDeleteTextures)(n, textures);
+    record(TRACE_DELETE_TEXTURES, textures, n * sizeof(GLuint), 1, n);
+}
+
+GL_APICALL void GL_APIENTRY glDepthFunc(GLenum func)
+{
+    REAL(glDepthFunc)(func);
+    record(TRACE_DEPTH_FUNC, NULL, 0, 1, func);
+}
+
+GL_APICALL void GL_APIENTRY glDepthMask(GLboolean flag)
+{
+    REAL(glDepthMask)(flag);
+    record(TRACE_DEPTH_MASK, NULL, 0, 1, flag);
+}
+
+GL_APICALL void GL_APIENTRY glDepthRangef(GLfloat n, GLfloat f)
+{
+    REAL(glDepthRangef)(n, f);
+    record(TRACE_DEPTH_RANGE, NULL, 0, 2, floatBits(n), floatBits(f));
+}
+
+GL_APICALL void GL_APIENTRY glDisable(GLenum cap)
+{
+    REAL(glDisable)(cap);
+    record(TRACE_DISABLE, NULL, 0, 1, cap);
+}
+
+GL_APICALL void GL_APIENTRY glDisableVertexAttribArray(GLuint index)
+{
+    REAL(glDisableVertexAttribArray)(index);
+    if (index < maxVertexAttribs)
+    {
+        attribs[index].enabled = false;
+    }
+    record(TRACE_DISABLE_VERTEX_ATTRIB_ARRAY, NULL, 0, 1, index);
+}
+
+GL_APICALL void GL_APIENTRY glDrawArrays(GLenum mode, GLint first, GLsizei count)
+{
+    REAL(glDrawArrays)(mode, first, count);
+    if (hasClientArrays())
+    {
+        recordClientArrays(first + count);
+    }
+    record(TRACE_DRAW_ARRAYS, NULL, 0, 3, mode, first, count);
+}
+
+GL_APICALL void GL_APIENTRY glDrawElements(GLenum mode, GLsizei count, GLenum type,
+                                           const void* indices)
+{
+    const char* data = static_cast<const char*>(indices);
+    size_t size = count * typeSize(type);
+
+    REAL(glDrawElements)(mode, count, type, indices);
+
+    // Client side vertex arrays need the index range
+    if (elementArrayBuffer)
+    {
+        std::vector<char>& shadow = elementBuffers[elementArrayBuffer];
+        size_t offset = reinterpret_cast<size_t>(indices);
+        data = (offset + size <= shadow.size()) ? &shadow[offset] : NULL;
+    }
+    if (hasClientArrays() && data)
+    {
+        GLuint maxIndex = 0;
+        for (GLsizei i = 0; i < count; i++)
+        {
+            GLuint index;
+            switch (type)
+            {
+            case GL_UNSIGNED_BYTE:
+                index = reinterpret_cast<const GLubyte*>(data)[i];
+                break;
+            case GL_UNSIGNED_SHORT:
+                index = reinterpret_cast<const GLushort*>(data)[i];
+                break;
+            default:
+                index = reinterpret_cast<const GLuint*>(data)[i];
+                break;
+            }
+            maxIndex = (index > maxIndex) ? index : maxIndex;
+        }
+        recordClientArrays(count ? maxIndex + 1 : 0);
+    }
+
+    if (elementArrayBuffer)
+    {
+        record(TRACE_DRAW_ELEMENTS, NULL, 0, 4, mode, count, type,
+               static_cast<uint32_t>(reinterpret_cast<size_t>(indices)));
+    }
+    else
+    {
+        record(TRACE_DRAW_ELEMENTS, indices, size, 4, mode, count, type, 0);
+    }
+}
+
+GL_APICALL void GL_APIENTRY glEnable(GLenum cap)
+{
+    REAL(glEnable)(cap);
+    record(TRACE_ENABLE, NULL, 0, 1, cap);
+}
+
+GL_APICALL void GL_APIENTRY glEnableVertexAttribArray(GLuint index)
+{
+    REAL(glEnableVertexAttribArray)(index);
+    if (index < maxVertexAttribs)
+    {
+        attribs[index].enabled = true;
+    }
+    record(TRACE_ENABLE_VERTEX_ATTRIB_ARRAY, NULL, 0, 1, index);
+}
+
+GL_APICALL void GL_APIENTRY glFinish(void)
+{
+    REAL(glFinish)();
+    record(TRACE_FINISH, NULL, 0, 0);
+}
+
+GL_APICALL void GL_APIENTRY glFlush(void)
+{
+    REAL(glFlush)();
+    record(TRACE_FLUSH, NULL, 0, 0);
+}
+
+GL_APICALL void GL_APIENTRY glFramebufferRenderbuffer(GLenum target, GLenum attachment,
+                                                      GLenum renderbuffertarget,
+                                                      GLuint renderbuffer)
+{
+    REAL(glFramebufferRenderbuffer)(target, attachment, renderbuffertarget, renderbuffer);
+    record(TRACE_FRAMEBUFFER_RENDERBUFFER, NULL, 0, 4,
+           target, attachment, renderbuffertarget, renderbuffer);
+}
+
+GL_APICALL void GL_APIENTRY glFramebufferTexture2D(GLenum target, GLenum attachment,
+                                                   GLenum textarget, GLuint texture, GLint level)
+{
+    REAL(glFramebufferTexture2D)(target, attachment, textarget, texture, level);
+    record(TRACE_FRAMEBUFFER_TEXTURE_2D, NULL, 0, 5, target, attachment, textarget, texture, level);
+}
+
+GL_APICALL void GL_APIENTRY glFrontFace(GLenum mode)
+{
+    REAL(glFrontFace)(mode);
+    record(TRACE_FRONT_FACE, NULL, 0, 1, mode);
+}
+
+GL_APICALL void GL_APIENTRY glGenBuffers(GLsizei n, GLuint* buffers)
+{
+    REAL(glGenBuffers)(n, buffers);
+    record(TRACE_GEN_BUFFERS, buffers, n * sizeof(GLuint), 1, n);
+}
+
+GL_APICALL void GL_APIENTRY glGenFramebuffers(GLsizei n, GLuint* framebuffers)
+{
+    REAL(glGenFramebuffers)(n, framebuffers);
+    record(TRACE_GEN_FRAMEBUFFERS, framebuffers, n * sizeof(GLuint), 1, n);
+}
+
+GL_APICALL void GL_APIENTRY glGenRenderbuffers(GLsizei n, GLuint* renderbuffers)
+{
+    REAL(glGenRenderbuffers)(n, renderbuffers);
+    record(TRACE_GEN_RENDERBUFFERS, renderbuffers, n * sizeof(GLuint), 1, n);
+}
+
+GL_APICALL void GL_APIENTRY glGenTextures(GLsizei n, GLuint* textures)
+{
+    REAL(glGenTextures)(n, textures);
+    record(TRACE_GEN_TEXTURES, textures, n * sizeof(GLuint), 1, n);
+}
+
+GL_APICALL void GL_APIENTRY glGenerateMipmap(GLenum target)
+{
+    REAL(glGenerateMipmap)(target);
+    record(TRACE_GENERATE_MIPMAP, NULL, 0, 1, target);
+}
+
+GL_APICALL GLint GL_APIENTRY glGetAttribLocation(GLuint program, const GLchar* name)
+{
+    GLint location = REAL(glGetAttribLocation)(program, name);
+    record(TRACE_GET_ATTRIB_LOCATION, name, strlen(name) + 1, 2, program, location);
+    return location;
+}
+
+GL_APICALL GLint GL_APIENTRY glGetUniformLocation(GLuint program, const GLchar* name)
+{
+    GLint location = REAL(glGetUniformLocation)(program, name);
+    record(TRACE_GET_UNIFORM_LOCATION, name, strlen(name) + 1, 2, program, location);
+    return location;
+}
+
+GL_APICALL void GL_APIENTRY glHint(GLenum target, GLenum mode)
+{
+    REAL(glHint)(target, mode);
+    record(TRACE_HINT, NULL, 0, 2, target, mode);
+}
+
+GL_APICALL void GL_APIENTRY glLineWidth(GLfloat width)
+{
+    REAL(glLineWidth)(width);
+    record(TRACE_LINE_WIDTH, NULL, 0, 1, floatBits(width));
+}
+
+GL_APICALL void GL_APIENTRY glLinkProgram(GLuint program)
+{
+    REAL(glLinkProgram)(program);
+    record(TRACE_LINK_PROGRAM, NULL, 0, 1, program);
+}
+
+GL_APICALL void GL_APIENTRY glPixelStorei(GLenum pname, GLint param)
+{
+    REAL(glPixelStorei)(pname, param);
+    record(TRACE_PIXEL_STOREI, NULL, 0, 2, pname, param);
+}
+
+GL_APICALL void GL_APIENTRY glPolygonOffset(GLfloat factor, GLfloat units)
+{
+    REAL(glPolygonOffset)(factor, units);
+    record(TRACE_POLYGON_OFFSET, NULL, 0, 2, floatBits(factor), floatBits(units));
+}
+
+GL_APICALL void GL_APIENTRY glRenderbufferStorage(GLenum target, GLenum internalformat,
+                                                  GLsizei width, GLsizei height)
+{
+    REAL(glRenderbufferStorage)(target, internalformat, width, height);
+    record(TRACE_RENDERBUFFER_STORAGE, NULL, 0, 4, target, internalformat, width, height);
+}
+
+GL_APICALL void GL_APIENTRY glScissor(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+    REAL(glScissor)(x, y, width, height);
+    record(TRACE_SCISSOR, NULL, 0, 4, x, y, width, height);
+}
+
+GL_APICALL void GL_APIENTRY glShaderSource(GLuint shader, GLsizei count,
+                                           const GLchar* const* string, const GLint* length)
+{
+    std::string source;
+
+    REAL(glShaderSource)(shader, count, string, length);
+    for (GLsizei i = 0; i < count; i++)
+    {
+        if (length && length[i] >= 0)
+        {
+            source.append(string[i], length[i]);
+        }
+        else
+        {
+            source.append(string[i]);
+        }
+    }
+    record(TRACE_SHADER_SOURCE, source.c_str(), source.size() + 1, 1, shader);
+}
+
+GL_APICALL void GL_APIENTRY glStencilFunc(GLenum func, GLint ref, GLuint mask)
+{
+    REAL(glStencilFunc)(func, ref, mask);
+    record(TRACE_STENCIL_FUNC_SEPARATE, NULL, 0, 4, GL_FRONT_AND_BACK, func, ref, mask);
+}
+
+GL_APICALL void GL_APIENTRY glStencilFuncSeparate(GLenum face, GLenum func, GLint ref, GLuint mask)
+{
+    REAL(glStencilFuncSeparate)(face, func, ref, mask);
+    record(TRACE_STENCIL_FUNC_SEPARATE, NULL, 0, 4, face, func, ref, mask);
+}
+
+GL_APICALL void GL_APIENTRY glStencilMask(GLuint mask)
+{
+    REAL(glStencilMask)(mask);
+    record(TRACE_STENCIL_MASK_SEPARATE, NULL, 0, 2, GL_FRONT_AND_BACK, mask);
+}
+
+GL_APICALL void GL_APIENTRY glStencilMaskSeparate(GLenum face, GLuint mask)
+{
+    REAL(glStencilMaskSeparate)(face, mask);
+    record(TRACE_STENCIL_MASK_SEPARATE, NULL, 0, 2, face, mask);
+}
+
+GL_APICALL void GL_APIENTRY glStencilOp(GLenum fail, GLenum zfail, GLenum zpass)
+{
+    REAL(glStencilOp)(fail, zfail, zpass);
+    record(TRACE_STENCIL_OP_SEPARATE, NULL, 0, 4, GL_FRONT_AND_BACK, fail, zfail, zpass);
+}
+
+GL_APICALL void GL_APIENTRY glStencilOpSeparate(GLenum face, GLenum sfail, GLenum dpfail,
+                                                GLenum dppass)
+{
+    REAL(glStencilOpSeparate)(face, sfail, dpfail, dppass);
+    record(TRACE_STENCIL_OP_SEPARATE, NULL, 0, 4, face, sfail, dpfail, dppass);
+}
+
+GL_APICALL void GL_APIENTRY glTexImage2D(GLenum target, GLint level, GLint internalformat,
+                                         GLsizei width, GLsizei height, GLint border,
+                                         GLenum format, GLenum type, const void* pixels)
+{
+    REAL(glTexImage2D)(target, level, internalformat, width, height, border, format, type, pixels);
+    record(TRACE_TEX_IMAGE_2D, pixels, imageSize(width, height, format, type), 8,
+           target, level, internalformat, width, height, border, format, type);
+}
+
+GL_APICALL void GL_APIENTRY glTexParameterf(GLenum target, GLenum pname, GLfloat param)
+{
+    REAL(glTexParameterf)(target, pname, param);
+    record(TRACE_TEX_PARAMETERF, NULL, 0, 3, target, pname, floatBits(param));
+}
+
+GL_APICALL void GL_APIENTRY glTexParameteri(GLenum target, GLenum pname, GLint param)
+{
+    REAL(glTexParameteri)(target, pname, param);
+    record(TRACE_TEX_PARAMETERI, NULL, 0, 3, target, pname, param);
+}
+
+GL_APICALL void GL_APIENTRY glTexSubImage2D(GLenum target, GLint level, GLint xoffset,
+                                            GLint yoffset, GLsizei width, GLsizei height,
+                                            GLenum format, GLenum type, const void* pixels)
+{
+    REAL(glTexSubImage2D)(target, level, xoffset, yoffset, width, height, format, type, pixels);
+    record(TRACE_TEX_SUB_IMAGE_2D, pixels, imageSize(width, height, format, type), 8,
+           target, level, xoffset, yoffset, width, height, format, type);
+}
+
+GL_APICALL void GL_APIENTRY glUniform1f(GLint location, GLfloat v0)
+{
+    REAL(glUniform1f)(location, v0);
+    record(TRACE_UNIFORMF, NULL, 0, 3, location, 1, floatBits(v0));
+}
+
+GL_APICALL void GL_APIENTRY glUniform2f(GLint location, GLfloat v0, GLfloat v1)
+{
+    REAL(glUniform2f)(location, v0, v1);
+    record(TRACE_UNIFORMF, NULL, 0, 4, location, 2, floatBits(v0), floatBits(v1));
+}
+
+GL_APICALL void GL_APIENTRY glUniform3f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2)
+{
+    REAL(glUniform3f)(location, v0, v1, v2);
+    record(TRACE_UNIFORMF, NULL, 0, 5, location, 3, floatBits(v0), floatBits(v1), floatBits(v2));
+}
+
+GL_APICALL void GL_APIENTRY glUniform4f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2,
+                                        GLfloat v3)
+{
+    REAL(glUniform4f)(location, v0, v1, v2, v3);
+    record(TRACE_UNIFORMF, NULL, 0, 6, location, 4,
+           floatBits(v0), floatBits(v1), floatBits(v2), floatBits(v3));
+}
+
+GL_APICALL void GL_APIENTRY glUniform1i(GLint location, GLint v0)
+{
+    REAL(glUniform1i)(location, v0);
+    record(TRACE_UNIFORMI, NULL, 0, 3, location, 1, v0);
+}
+
+GL_APICALL void GL_APIENTRY glUniform2i(GLint location, GLint v0, GLint v1)
+{
+    REAL(glUniform2i)(location, v0, v1);
+    record(TRACE_UNIFORMI, NULL, 0, 4, location, 2, v0, v1);
+}
+
+GL_APICALL void GL_APIENTRY glUniform3i(GLint location, GLint v0, GLint v1, GLint v2)
+{
+    REAL(glUniform3i)(location, v0, v1, v2);
+    record(TRACE_UNIFORMI, NULL, 0, 5, location, 3, v0, v1, v2);
+}
+
+GL_APICALL void GL_APIENTRY glUniform4i(GLint location, GLint v0, GLint v1, GLint v2, GLint v3)
+{
+    REAL(glUniform4i)(location, v0, v1, v2, v3);
+    record(TRACE_UNIFORMI, NULL, 0, 6, location, 4, v0, v1, v2, v3);
+}
+
+GL_APICALL void GL_APIENTRY glUniform1fv(GLint location, GLsizei count, const GLfloat* value)
+{
+    REAL(glUniform1fv)(location, count, value);
+    record(TRACE_UNIFORMFV, value, count * sizeof(GLfloat), 3, location, 1, count);
+}
+
+GL_APICALL void GL_APIENTRY glUniform2fv(GLint location, GLsizei count, const GLfloat* value)
+{
+    REAL(glUniform2fv)(location, count, value);
+    record(TRACE_UNIFORMFV, value, 2 * count * sizeof(GLfloat), 3, location, 2, count);
+}
+
+GL_APICALL void GL_APIENTRY glUniform3fv(GLint location, GLsizei count, const GLfloat* value)
+{
+    REAL(glUniform3fv)(location, count, value);
+    record(TRACE_UNIFORMFV, value, 3 * count * sizeof(GLfloat), 3, location, 3, count);
+}
+
+GL_APICALL void GL_APIENTRY glUniform4fv(GLint location, GLsizei count, const GLfloat* value)
+{
+    REAL(glUniform4fv)(location, count, value);
+    record(TRACE_UNIFORMFV, value, 4 * count * sizeof(GLfloat), 3, location, 4, count);
+}
+
+GL_APICALL void GL_APIENTRY glUniform1iv(GLint location, GLsizei count, const GLint* value)
+{
+    REAL(glUniform1iv)(location, count, value);
+    record(TRACE_UNIFORMIV, value, count * sizeof(GLint), 3, location, 1, count);
+}
+
+GL_APICALL void GL_APIENTRY glUniform2iv(GLint location, GLsizei count, const GLint* value)
+{
+    REAL(glUniform2iv)(location, count, value);
+    record(TRACE_UNIFORMIV, value, 2 * count * sizeof(GLint), 3, location, 2, count);
+}
+
+GL_APICALL void GL_APIENTRY glUniform3iv(GLint location, GLsizei count, const GLint* value)
+{
+    REAL(glUniform3iv)(location, count, value);
+    record(TRACE_UNIFORMIV, value, 3 * count * sizeof(GLint), 3, location, 3, count);
+}
+
+GL_APICALL void GL_APIENTRY glUniform4iv(GLint location, GLsizei count, const GLint* value)
+{
+    REAL(glUniform4iv)(location, count, value);
+    record(TRACE_UNIFORMIV, value, 4 * count * sizeof(GLint), 3, location, 4, count);
+}
+
+GL_APICALL void GL_APIENTRY glUniformMatrix2fv(GLint location, GLsizei count,
+                                               GLboolean transpose, const GLfloat* value)
+{
+    REAL(glUniformMatrix2fv)(location, count, transpose, value);
+    record(TRACE_UNIFORM_MATRIXFV, value, 4 * count * sizeof(GLfloat), 4,
+           location, 2, count, transpose);
+}
+
+GL_APICALL void GL_APIENTRY glUniformMatrix3fv(GLint location, GLsizei count,
+                                               GLboolean transpose, const GLfloat* value)
+{
+    REAL(glUniformMatrix3fv)(location, count, transpose, value);
+    record(TRACE_UNIFORM_MATRIXFV, value, 9 * count * sizeof(GLfloat), 4,
+           location, 3, count, transpose);
+}
+
+GL_APICALL void GL_APIENTRY glUniformMatrix4fv(GLint location, GLsizei count,
+                                               GLboolean transpose, const GLfloat* value)
+{
+    REAL(glUniformMatrix4fv)(location, count, transpose, value);
+    record(TRACE_UNIFORM_MATRIXFV, value, 16 * count * sizeof(GLfloat), 4,
+           location, 4, count, transpose);
+}
+
+GL_APICALL void GL_APIENTRY glUseProgram(GLuint program)
+{
+    REAL(glUseProgram)(program);
+    record(TRACE_USE_PROGRAM, NULL, 0, 1, program);
+}
+
+GL_APICALL void GL_APIENTRY glVertexAttrib4f(GLuint index, GLfloat x, GLfloat y, GLfloat z,
+                                             GLfloat w)
+{
+    REAL(glVertexAttrib4f)(index, x, y, z, w);
+    record(TRACE_VERTEX_ATTRIB_4F, NULL, 0, 5,
+           index, floatBits(x), floatBits(y), floatBits(z), floatBits(w));
+}
+
+GL_APICALL void GL_APIENTRY glVertexAttrib4fv(GLuint index, const GLfloat* v)
+{
+    REAL(glVertexAttrib4fv)(index, v);
+    record(TRACE_VERTEX_ATTRIB_4F, NULL, 0, 5,
+           index, floatBits(v[0]), floatBits(v[1]), floatBits(v[2]), floatBits(v[3]));
+}
+
+GL_APICALL void GL_APIENTRY glVertexAttribPointer(GLuint index, GLint size, GLenum type,
+                                                  GLboolean normalized, GLsizei stride,
+                                                  const void* pointer)
+{
+    REAL(glVertexAttribPointer)(index, size, type, normalized, stride, pointer);
+
+    // Client side arrays are recorded by the draw calls that use them
+    if (index < maxVertexAttribs)
+    {
+        AttribState& a = attribs[index];
+        a.client = !arrayBuffer;
+        a.size = size;
+        a.type = type;
+        a.normalized = normalized;
+        a.stride = stride;
+        a.pointer = pointer;
+        if (a.client)
+        {
+            return;
+        }
+    }
+    record(TRACE_VERTEX_ATTRIB_POINTER, NULL, 0, 6, index, size, type, normalized, stride,
+           static_cast<uint32_t>(reinterpret_cast<size_t>(pointer)));
+}
+
+GL_APICALL void GL_APIENTRY glViewport(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+    REAL(glViewport)(x, y, width, height);
+    record(TRACE_VIEWPORT, NULL, 0, 4, x, y, width, height);
+}
+
+EGLAPI EGLBoolean EGLAPIENTRY eglSwapBuffers(EGLDisplay dpy, EGLSurface surface)
+{
+    record(TRACE_SWAP_BUFFERS, NULL, 0, 0);
+    return REAL(eglSwapBuffers)(dpy, surface);
+}
+
+EGLAPI __eglMustCastToProperFunctionPointerType EGLAPIENTRY eglGetProcAddress(const char* procname)
+{
+    // Hand out the interposed version of core functions; lookups fall
+    // through to the real library for anything not traced here
+    if (!strncmp(procname, "gl", 2))
+    {
+        void* function = dlsym(RTLD_DEFAULT, procname);
+        if (function)
+        {
+            return reinterpret_cast<__eglMustCastToProperFunctionPointerType>(function);
+        }
+    }
+    return REAL(eglGetProcAddress)(procname);
+}
+
+} // extern "C"
@@ -0,0 +1,844 @@
+/**
+ * OpenGL ES 2.0 memory performance estimator
+ * Copyright (C) 2012 Google
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * \author Sami Kyöstilä <skyostil@google.com>
+ *
+ * Command stream trace replay test
+ */
+#include "tracetest.h"
+#include "util.h"
+
+#include <sstream>
+#include <string.h>
+
+#if !defined(SUPPORT_ANDROID)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ *  Minimum number of arguments for each opcode
+ */
+static const uint8_t argCounts[] =
+{
+    0, 1, 2, 2, 2, 2, 2, 2,         // TRACE_SWAP_BUFFERS...
+    4, 1, 2, 2, 4, 3, 3, 1,         // TRACE_BLEND_COLOR...
+    4, 1, 1, 4, 1, 7, 8, 8,         // TRACE_CLEAR_COLOR...
+    8, 1, 2, 1, 1, 1, 1, 1,         // TRACE_COPY_TEX_SUB_IMAGE_2D...
+    1, 1, 1, 1, 2, 1, 1, 3,         // TRACE_DELETE_SHADER...
+    4, 1, 1, 0, 0, 4, 5, 1,         // TRACE_DRAW_ELEMENTS...
+    1, 1, 1, 1, 1, 2, 2, 2,         // TRACE_GEN_BUFFERS...
+    1, 1, 2, 2, 4, 4, 1, 4,         // TRACE_LINE_WIDTH...
+    2, 4, 8, 3, 3, 8, 2, 2,         // TRACE_STENCIL_MASK_SEPARATE...
+    3, 3, 4, 1, 5, 6, 4,            // TRACE_UNIFORMFV...
+};
+
+typedef char argCountsMatchOpcodes[sizeof(argCounts) == TRACE_OPCODE_COUNT ? 1 : -1];
+
+static GLfloat toFloat(uint32_t bits)
+{
+    GLfloat value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static size_t paddedSize(size_t size)
+{
+    return (size + 3) & ~3;
+}
+
+static void GL_APIENTRY deletePrograms(GLsizei n, const GLuint* names)
+{
+    for (GLsizei i = 0; i < n; i++)
+    {
+        glDeleteProgram(names[i]);
+    }
+}
+
+static void GL_APIENTRY deleteShaders(GLsizei n, const GLuint* names)
+{
+    for (GLsizei i = 0; i < n; i++)
+    {
+        glDeleteShader(names[i]);
+    }
+}
+
+TraceTest::TraceTest(const std::string& fileName):
+    m_fileName(fileName),
+    m_data(0),
+    m_size(0),
+    m_nextFrame(0),
+    m_program(0),
+    m_arrayBuffer(0),
+    m_calls(0),
+    m_frames(0)
+{
+}
+
+void TraceTest::loadTrace()
+{
+#if defined(SUPPORT_ANDROID)
+    if (!loadFile(m_fileName, m_buffer))
+    {
+        fail("Unable to load trace " + m_fileName);
+    }
+    m_data = m_buffer.empty() ? 0 : &m_buffer[0];
+    m_size = m_buffer.size();
+#else
+    int fd = open(m_fileName.c_str(), O_RDONLY);
+    struct stat sb;
+
+    if (fd == -1)
+    {
+        fail("Unable to open trace " + m_fileName);
+    }
+    if (fstat(fd, &sb) == -1 || !sb.st_size)
+    {
+        close(fd);
+        fail("Unable to read trace " + m_fileName);
+    }
+
+    void* data = mmap(0, sb.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        fail("Unable to map trace " + m_fileName);
+    }
+    m_data = static_cast<const char*>(data);
+    m_size = sb.st_size;
+#endif
+}
+
+void TraceTest::indexFrames()
+{
+    const TraceHeader* header = reinterpret_cast<const TraceHeader*>(m_data);
+    size_t offset = sizeof(TraceHeader);
+
+    if (m_size < sizeof(TraceHeader) || header->magic != TRACE_MAGIC)
+    {
+        fail(m_fileName + " is not a trace");
+    }
+    if (header->version != TRACE_VERSION)
+    {
+        fail(m_fileName + ": unsupported trace version");
+    }
+
+    // Each frame is delimited by a swap; anything after the last one is an
+    // incomplete frame and is ignored
+    m_frameOffsets.clear();
+    m_frameOffsets.push_back(offset);
+    while (offset + sizeof(TraceRecord) <= m_size)
+    {
+        const TraceRecord* rec = reinterpret_cast<const TraceRecord*>(m_data + offset);
+        size_t size = sizeof(TraceRecord) + rec->argCount * sizeof(uint32_t) +
+                      paddedSize(rec->dataSize);
+
+        if (rec->opcode >= TRACE_OPCODE_COUNT || rec->argCount < argCounts[rec->opcode] ||
+            size > m_size - offset)
+        {
+            std::stringstream s;
+            s << m_fileName << ": corrupt record at offset " << offset;
+            fail(s.str());
+        }
+        offset += size;
+
+        if (rec->opcode == TRACE_SWAP_BUFFERS)
+        {
+            m_frameOffsets.push_back(offset);
+        }
+    }
+
+    if (m_frameOffsets.size() < 2)
+    {
+        fail(m_fileName + " has no complete frames");
+    }
+}
+
+void TraceTest::prepare()
+{
+    loadTrace();
+
+    // teardown() is not called for a test that fails to prepare, so the
+    // mapping and whatever the setup frame created are released here
+    try
+    {
+        indexFrames();
+
+        glGetError();
+        replayFrame(0);
+        glFinish();
+        ASSERT_GL();
+    }
+    catch (...)
+    {
+        releaseResources();
+        throw;
+    }
+
+    // A single frame trace is replayed as is; otherwise the setup frame is
+    // left out of the loop and the objects it created are kept
+    m_nextFrame = (m_frameOffsets.size() > 2) ? 1 : 0;
+    if (m_nextFrame)
+    {
+        m_setupBuffers = m_buffers;
+        m_setupTextures = m_textures;
+        m_setupFramebuffers = m_framebuffers;
+        m_setupRenderbuffers = m_renderbuffers;
+        m_setupPrograms = m_programs;
+        m_setupShaders = m_shaders;
+    }
+    else
+    {
+        restartLoop();
+    }
+}
+
+void TraceTest::replayFrame(int frame)
+{
+    size_t offset = m_frameOffsets[frame];
+    size_t end = m_frameOffsets[frame + 1];
+
+    while (offset < end)
+    {
+        const TraceRecord* rec = reinterpret_cast<const TraceRecord*>(m_data + offset);
+        const uint32_t* args = reinterpret_cast<const uint32_t*>(rec + 1);
+        const char* data = reinterpret_cast<const char*>(args + rec->argCount);
+
+        // The swap is left to the runner
+        if (rec->opcode != TRACE_SWAP_BUFFERS)
+        {
+            replay(*rec, args, rec->dataSize ? data : 0);
+            m_calls++;
+        }
+        offset = (data - m_data) + paddedSize(rec->dataSize);
+    }
+}
+
+void TraceTest::restartLoop()
+{
+    deleteLoopNames(m_buffers, m_setupBuffers, glDeleteBuffers);
+    deleteLoopNames(m_textures, m_setupTextures, glDeleteTextures);
+    deleteLoopNames(m_framebuffers, m_setupFramebuffers, glDeleteFramebuffers);
+    deleteLoopNames(m_renderbuffers, m_setupRenderbuffers, glDeleteRenderbuffers);
+    deleteLoopNames(m_programs, m_setupPrograms, deletePrograms);
+    deleteLoopNames(m_shaders, m_setupShaders, deleteShaders);
+
+    // Deleting the bound array buffer unbinds it
+    GLint arrayBuffer = 0;
+    glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &arrayBuffer);
+    m_arrayBuffer = arrayBuffer;
+}
+
+void TraceTest::deleteLoopNames(NameMap& names, const NameMap& setupNames, DeleteFunc del)
+{
+    NameMap::iterator i = names.begin();
+
+    // A captured name that was deleted and generated again inside the loop
+    // maps to a new object even though the setup frame also used it
+    while (i != names.end())
+    {
+        NameMap::const_iterator j = setupNames.find(i->first);
+        if (j == setupNames.end() || j->second != i->second)
+        {
+            del(1, &i->second);
+            names.erase(i++);
+        }
+        else
+        {
+            ++i;
+        }
+    }
+}
+
+GLuint TraceTest::mapName(NameMap& names, GLuint name, GenFunc gen)
+{
+    if (!name)
+    {
+        return 0;
+    }
+
+    NameMap::const_iterator i = names.find(name);
+    if (i != names.end())
+    {
+        return i->second;
+    }
+
+    // Names may be bound without being generated first
+    GLuint newName = 0;
+    if (gen)
+    {
+        gen(1, &newName);
+        names[name] = newName;
+    }
+    return newName;
+}
+
+void TraceTest::genNames(NameMap& names, const TraceRecord& rec, const uint32_t* args,
+                         const char* data, GenFunc gen)
+{
+    GLsizei n = args[0];
+    ASSERT(rec.dataSize >= n * sizeof(GLuint));
+
+    const GLuint* captured = reinterpret_cast<const GLuint*>(data);
+    std::vector<GLuint> generated(n);
+    if (n)
+    {
+        gen(n, &generated[0]);
+    }
+    for (GLsizei i = 0; i < n; i++)
+    {
+        names[captured[i]] = generated[i];
+    }
+}
+
+void TraceTest::deleteNames(NameMap& names, const TraceRecord& rec, const uint32_t* args,
+                            const char* data)
+{
+    GLsizei n = args[0];
+    ASSERT(rec.dataSize >= n * sizeof(GLuint));
+
+    const GLuint* captured = reinterpret_cast<const GLuint*>(data);
+    std::vector<GLuint> deleted;
+    for (GLsizei i = 0; i < n; i++)
+    {
+        NameMap::iterator j = names.find(captured[i]);
+        if (j != names.end())
+        {
+            deleted.push_back(j->second);
+            names.erase(j);
+        }
+    }
+    if (deleted.empty())
+    {
+        return;
+    }
+
+    switch (rec.opcode)
+    {
+    case TRACE_DELETE_BUFFERS:
+        glDeleteBuffers(deleted.size(), &deleted[0]);
+        break;
+    case TRACE_DELETE_FRAMEBUFFERS:
+        glDeleteFramebuffers(deleted.size(), &deleted[0]);
+        break;
+    case TRACE_DELETE_RENDERBUFFERS:
+        glDeleteRenderbuffers(deleted.size(), &deleted[0]);
+        break;
+    case TRACE_DELETE_TEXTURES:
+        glDeleteTextures(deleted.size(), &deleted[0]);
+        break;
+    }
+}
+
+GLint TraceTest::uniformLocation(GLint location) const
+{
+    if (location < 0)
+    {
+        return -1;
+    }
+
+    // Array elements are addressed relative to the queried location
+    LocationMap::const_iterator i = m_uniforms.upper_bound(std::make_pair(m_program, location));
+    if (i == m_uniforms.begin())
+    {
+        return -1;
+    }
+    --i;
+    if (i->first.first != m_program || i->second < 0)
+    {
+        return -1;
+    }
+    return i->second + (location - i->first.second);
+}
+
+GLuint TraceTest::attribLocation(GLuint index) const
+{
+    LocationMap::const_iterator i = m_attribs.find(std::make_pair(m_program, (GLint)index));
+    if (i == m_attribs.end() || i->second < 0)
+    {
+        return index;
+    }
+    return i->second;
+}
+
+void TraceTest::replay(const TraceRecord& rec, const uint32_t* args, const char* data)
+{
+    const GLfloat* floats = reinterpret_cast<const GLfloat*>(data);
+    const GLint* ints = reinterpret_cast<const GLint*>(data);
+    const char* str = (data && data[rec.dataSize - 1] == '\0') ? data : 0;
+
+    switch (rec.opcode)
+    {
+    case TRACE_ACTIVE_TEXTURE:
+        glActiveTexture(args[0]);
+        break;
+    case TRACE_ATTACH_SHADER:
+        glAttachShader(mapName(m_programs, args[0]), mapName(m_shaders, args[1]));
+        break;
+    case TRACE_BIND_ATTRIB_LOCATION:
+        ASSERT(str);
+        glBindAttribLocation(mapName(m_programs, args[0]), args[1], str);
+        break;
+    case TRACE_BIND_BUFFER:
+        {
+            GLuint buffer = mapName(m_buffers, args[1], glGenBuffers);
+            if (args[0] == GL_ARRAY_BUFFER)
+            {
+                m_arrayBuffer = buffer;
+            }
+            glBindBuffer(args[0], buffer);
+        }
+        break;
+    case TRACE_BIND_FRAMEBUFFER:
+        glBindFramebuffer(args[0], mapName(m_framebuffers, args[1], glGenFramebuffers));
+        break;
+    case TRACE_BIND_RENDERBUFFER:
+        glBindRenderbuffer(args[0], mapName(m_renderbuffers, args[1], glGenRenderbuffers));
+        break;
+    case TRACE_BIND_TEXTURE:
+        glBindTexture(args[0], mapName(m_textures, args[1], glGenTextures));
+        break;
+    case TRACE_BLEND_COLOR:
+        glBlendColor(toFloat(args[0]), toFloat(args[1]), toFloat(args[2]), toFloat(args[3]));
+        break;
+    case TRACE_BLEND_EQUATION:
+        glBlendEquation(args[0]);
+        break;
+    case TRACE_BLEND_EQUATION_SEPARATE:
+        glBlendEquationSeparate(args[0], args[1]);
+        break;
+    case TRACE_BLEND_FUNC:
+        glBlendFunc(args[0], args[1]);
+        break;
+    case TRACE_BLEND_FUNC_SEPARATE:
+        glBlendFuncSeparate(args[0], args[1], args[2], args[3]);
+        break;
+    case TRACE_BUFFER_DATA:
+        ASSERT(!data || rec.dataSize >= args[1]);
+        glBufferData(args[0], args[1], data, args[2]);
+        break;
+    case TRACE_BUFFER_SUB_DATA:
+        ASSERT(data && rec.dataSize >= args[2]);
+        glBufferSubData(args[0], args[1], args[2], data);
+        break;
+    case TRACE_CLEAR:
+        glClear(args[0]);
+        break;
+    case TRACE_CLEAR_COLOR:
+        glClearColor(toFloat(args[0]), toFloat(args[1]), toFloat(args[2]), toFloat(args[3]));
+        break;
+    case TRACE_CLEAR_DEPTH:
+        glClearDepthf(toFloat(args[0]));
+        break;
+    case TRACE_CLEAR_STENCIL:
+        glClearStencil(args[0]);
+        break;
+    case TRACE_COLOR_MASK:
+        glColorMask(args[0], args[1], args[2], args[3]);
+        break;
+    case TRACE_COMPILE_SHADER:
+        glCompileShader(mapName(m_shaders, args[0]));
+        break;
+    case TRACE_COMPRESSED_TEX_IMAGE_2D:
+        ASSERT(data && rec.dataSize >= args[6]);
+        glCompressedTexImage2D(args[0], args[1], args[2], args[3], args[4], args[5],
+                               args[6], data);
+        break;
+    case TRACE_COMPRESSED_TEX_SUB_IMAGE_2D:
+        ASSERT(data && rec.dataSize >= args[7]);
+        glCompressedTexSubImage2D(args[0], args[1], args[2], args[3], args[4], args[5],
+                                  args[6], args[7], data);
+        break;
+    case TRACE_COPY_TEX_IMAGE_2D:
+        glCopyTexImage2D(args[0], args[1], args[2], args[3], args[4], args[5], args[6],
+                         args[7]);
+        break;
+    case TRACE_COPY_TEX_SUB_IMAGE_2D:
+        glCopyTexSubImage2D(args[0], args[1], args[2], args[3], args[4], args[5], args[6],
+                            args[7]);
+        break;
+    case TRACE_CREATE_PROGRAM:
+        m_programs[args[0]] = glCreateProgram();
+        break;
+    case TRACE_CREATE_SHADER:
+        m_shaders[args[1]] = glCreateShader(args[0]);
+        break;
+    case TRACE_CULL_FACE:
+        glCullFace(args[0]);
+        break;
+    case TRACE_DELETE_BUFFERS:
+        deleteNames(m_buffers, rec, args, data);
+        break;
+    case TRACE_DELETE_FRAMEBUFFERS:
+        deleteNames(m_framebuffers, rec, args, data);
+        break;
+    case TRACE_DELETE_PROGRAM:
+        glDeleteProgram(mapName(m_programs, args[0]));
+        m_programs.erase(args[0]);
+        break;
+    case TRACE_DELETE_RENDERBUFFERS:
+        deleteNames(m_renderbuffers, rec, args, data);
+        break;
+    case TRACE_DELETE_SHADER:
+        glDeleteShader(mapName(m_shaders, args[0]));
+        m_shaders.erase(args[0]);
+        break;
+    case TRACE_DELETE_TEXTURES:
+        deleteNames(m_textures, rec, args, data);
+        break;
+    case TRACE_DEPTH_FUNC:
+        glDepthFunc(args[0]);
+        break;
+    case TRACE_DEPTH_MASK:
+        glDepthMask(args[0]);
+        break;
+    case TRACE_DEPTH_RANGE:
+        glDepthRangef(toFloat(args[0]), toFloat(args[1]));
+        break;
+    case TRACE_DISABLE:
+        glDisable(args[0]);
+        break;
+    case TRACE_DISABLE_VERTEX_ATTRIB_ARRAY:
+        glDisableVertexAttribArray(attribLocation(args[0]));
+        break;
+    case TRACE_DRAW_ARRAYS:
+        glDrawArrays(args[0], args[1], args[2]);
+        break;
+    case TRACE_DRAW_ELEMENTS:
+        glDrawElements(args[0], args[1], args[2],
+                       data ? static_cast<const void*>(data) :
+                              reinterpret_cast<const void*>(static_cast<size_t>(args[3])));
+        break;
+    case TRACE_ENABLE:
+        glEnable(args[0]);
+        break;
+    case TRACE_ENABLE_VERTEX_ATTRIB_ARRAY:
+        glEnableVertexAttribArray(attribLocation(args[0]));
+        break;
+    case TRACE_FINISH:
+        glFinish();
+        break;
+    case TRACE_FLUSH:
+        glFlush();
+        break;
+    case TRACE_FRAMEBUFFER_RENDERBUFFER:
+        glFramebufferRenderbuffer(args[0], args[1], args[2],
+                                  mapName(m_renderbuffers, args[3], glGenRenderbuffers));
+        break;
+    case TRACE_FRAMEBUFFER_TEXTURE_2D:
+        glFramebufferTexture2D(args[0], args[1], args[2],
+                               mapName(m_textures, args[3], glGenTextures), args[4]);
+        break;
+    case TRACE_FRONT_FACE:
+        glFrontFace(args[0]);
+        break;
+    case TRACE_GEN_BUFFERS:
+        genNames(m_buffers, rec, args, data, glGenBuffers);
+        break;
+    case TRACE_GEN_FRAMEBUFFERS:
+        genNames(m_framebuffers, rec, args, data, glGenFramebuffers);
+        break;
+    case TRACE_GEN_RENDERBUFFERS:
+        genNames(m_renderbuffers, rec, args, data, glGenRenderbuffers);
+        break;
+    case TRACE_GEN_TEXTURES:
+        genNames(m_textures, rec, args, data, glGenTextures);
+        break;
+    case TRACE_GENERATE_MIPMAP:
+        glGenerateMipmap(args[0]);
+        break;
+    case TRACE_GET_ATTRIB_LOCATION:
+        ASSERT(str);
+        m_attribs[std::make_pair(args[0], (GLint)args[1])] =
+            glGetAttribLocation(mapName(m_programs, args[0]), str);
+        break;
+    case TRACE_GET_UNIFORM_LOCATION:
+        ASSERT(str);
+        m_uniforms[std::make_pair(args[0], (GLint)args[1])] =
+            glGetUniformLocation(mapName(m_programs, args[0]), str);
+        break;
+    case TRACE_HINT:
+        glHint(args[0], args[1]);
+        break;
+    case TRACE_LINE_WIDTH:
+        glLineWidth(toFloat(args[0]));
+        break;
+    case TRACE_LINK_PROGRAM:
+        glLinkProgram(mapName(m_programs, args[0]));
+        break;
+    case TRACE_PIXEL_STOREI:
+        glPixelStorei(args[0], args[1]);
+        break;
+    case TRACE_POLYGON_OFFSET:
+        glPolygonOffset(toFloat(args[0]), toFloat(args[1]));
+        break;
+    case TRACE_RENDERBUFFER_STORAGE:
+        glRenderbufferStorage(args[0], args[1], args[2], args[3]);
+        break;
+    case TRACE_SCISSOR:
+        glScissor(args[0], args[1], args[2], args[3]);
+        break;
+    case TRACE_SHADER_SOURCE:
+        ASSERT(str);
+        glShaderSource(mapName(m_shaders, args[0]), 1, &str, 0);
+        break;
+    case TRACE_STENCIL_FUNC_SEPARATE:
+        glStencilFuncSeparate(args[0], args[1], args[2], args[3]);
+        break;
+    case TRACE_STENCIL_MASK_SEPARATE:
+        glStencilMaskSeparate(args[0], args[1]);
+        break;
+    case TRACE_STENCIL_OP_SEPARATE:
+        glStencilOpSeparate(args[0], args[1], args[2], args[3]);
+        break;
+    case TRACE_TEX_IMAGE_2D:
+        glTexImage2D(args[0], args[1], args[2], args[3], args[4], args[5], args[6], args[7],
+                     data);
+        break;
+    case TRACE_TEX_PARAMETERF:
+        glTexParameterf(args[0], args[1], toFloat(args[2]));
+        break;
+    case TRACE_TEX_PARAMETERI:
+        glTexParameteri(args[0], args[1], args[2]);
+        break;
+    case TRACE_TEX_SUB_IMAGE_2D:
+        ASSERT(data);
+        glTexSubImage2D(args[0], args[1], args[2], args[3], args[4], args[5], args[6], args[7],
+                        data);
+        break;
+    case TRACE_UNIFORMF:
+        {
+            GLfloat v[4];
+            GLint n = args[1];
+            ASSERT(n >= 1 && n <= 4 && rec.argCount >= 2 + n);
+            for (GLint i = 0; i < n; i++)
+            {
+                v[i] = toFloat(args[2 + i]);
+            }
+            switch (n)
+            {
+            case 1: glUniform1fv(uniformLocation(args[0]), 1, v); break;
+            case 2: glUniform2fv(uniformLocation(args[0]), 1, v); break;
+            case 3: glUniform3fv(uniformLocation(args[0]), 1, v); break;
+            case 4: glUniform4fv(uniformLocation(args[0]), 1, v); break;
+            }
+        }
+        break;
+    case TRACE_UNIFORMI:
+        {
+            const GLint* v = reinterpret_cast<const GLint*>(args + 2);
+            GLint n = args[1];
+            ASSERT(n >= 1 && n <= 4 && rec.argCount >= 2 + n);
+            switch (n)
+            {
+            case 1: glUniform1iv(uniformLocation(args[0]), 1, v); break;
+            case 2: glUniform2iv(uniformLocation(args[0]), 1, v); break;
+            case 3: glUniform3iv(uniformLocation(args[0]), 1, v); break;
+            case 4: glUniform4iv(uniformLocation(args[0]), 1, v); break;
+            }
+        }
+        break;
+    case TRACE_UNIFORMFV:
+        ASSERT(args[1] >= 1 && args[1] <= 4 && rec.dataSize >= args[1] * args[2] * sizeof(GLfloat));
+        switch (args[1])
+        {
+        case 1: glUniform1fv(uniformLocation(args[0]), args[2], floats); break;
+        case 2: glUniform2fv(uniformLocation(args[0]), args[2], floats); break;
+        case 3: glUniform3fv(uniformLocation(args[0]), args[2], floats); break;
+        case 4: glUniform4fv(uniformLocation(args[0]), args[2], floats); break;
+        }
+        break;
+    case TRACE_UNIFORMIV:
+        ASSERT(args[1] >= 1 && args[1] <= 4 && rec.dataSize >= args[1] * args[2] * sizeof(GLint));
+        switch (args[1])
+        {
+        case 1: glUniform1iv(uniformLocation(args[0]), args[2], ints); break;
+        case 2: glUniform2iv(uniformLocation(args[0]), args[2], ints); break;
+        case 3: glUniform3iv(uniformLocation(args[0]), args[2], ints); break;
+        case 4: glUniform4iv(uniformLocation(args[0]), args[2], ints); break;
+        }
+        break;
+    case TRACE_UNIFORM_MATRIXFV:
+        ASSERT(args[1] >= 2 && args[1] <= 4 &&
+               rec.dataSize >= args[1] * args[1] * args[2] * sizeof(GLfloat));
+        switch (args[1])
+        {
+        case 2: glUniformMatrix2fv(uniformLocation(args[0]), args[2], args[3], floats); break;
+        case 3: glUniformMatrix3fv(uniformLocation(args[0]), args[2], args[3], floats); break;
+        case 4: glUniformMatrix4fv(uniformLocation(args[0]), args[2], args[3], floats); break;
+        }
+        break;
+    case TRACE_USE_PROGRAM:
+        m_program = args[0];
+        glUseProgram(mapName(m_programs, args[0]));
+        break;
+    case TRACE_VERTEX_ATTRIB_4F:
+        glVertexAttrib4f(attribLocation(args[0]), toFloat(args[1]), toFloat(args[2]),
+                         toFloat(args[3]), toFloat(args[4]));
+        break;
+    case TRACE_VERTEX_ATTRIB_POINTER:
+        if (data)
+        {
+            // Client side array captured at draw time
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+            glVertexAttribPointer(attribLocation(args[0]), args[1], args[2], args[3], args[4],
+                                  data);
+            glBindBuffer(GL_ARRAY_BUFFER, m_arrayBuffer);
+        }
+        else
+        {
+            glVertexAttribPointer(attribLocation(args[0]), args[1], args[2], args[3], args[4],
+                                  reinterpret_cast<const void*>(static_cast<size_t>(args[5])));
+        }
+        break;
+    case TRACE_VIEWPORT:
+        glViewport(args[0], args[1], args[2], args[3]);
+        break;
+    }
+}
+
+void TraceTest::operator()(int frame)
+{
+    if (frame == 0)
+    {
+        m_stats.reset(0);
+        m_calls = 0;
+        m_frames = 0;
+    }
+    m_stats.frame();
+
+    replayFrame(m_nextFrame);
+    m_frames++;
+
+    if (++m_nextFrame == static_cast<int>(m_frameOffsets.size()) - 1)
+    {
+        m_nextFrame = (m_frameOffsets.size() > 2) ? 1 : 0;
+        restartLoop();
+    }
+}
+
+void TraceTest::releaseResources()
+{
+    NameMap::const_iterator i;
+    GLint maxAttribs = 0;
+
+    for (i = m_buffers.begin(); i != m_buffers.end(); ++i)
+    {
+        glDeleteBuffers(1, &i->second);
+    }
+    for (i = m_textures.begin(); i != m_textures.end(); ++i)
+    {
+        glDeleteTextures(1, &i->second);
+    }
+    for (i = m_framebuffers.begin(); i != m_framebuffers.end(); ++i)
+    {
+        glDeleteFramebuffers(1, &i->second);
+    }
+    for (i = m_renderbuffers.begin(); i != m_renderbuffers.end(); ++i)
+    {
+        glDeleteRenderbuffers(1, &i->second);
+    }
+    for (i = m_programs.begin(); i != m_programs.end(); ++i)
+    {
+        glDeleteProgram(i->second);
+    }
+    for (i = m_shaders.begin(); i != m_shaders.end(); ++i)
+    {
+        glDeleteShader(i->second);
+    }
+    m_buffers.clear();
+    m_textures.clear();
+    m_framebuffers.clear();
+    m_renderbuffers.clear();
+    m_programs.clear();
+    m_shaders.clear();
+    m_setupBuffers.clear();
+    m_setupTextures.clear();
+    m_setupFramebuffers.clear();
+    m_setupRenderbuffers.clear();
+    m_setupPrograms.clear();
+    m_setupShaders.clear();
+    m_uniforms.clear();
+    m_attribs.clear();
+
+    // Leave the state the trace may have changed as the other tests expect it
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    glUseProgram(0);
+    glActiveTexture(GL_TEXTURE0);
+    glGetIntegerv(GL_MAX_VERTEX_ATTRIBS, &maxAttribs);
+    for (GLint attr = 0; attr < maxAttribs; attr++)
+    {
+        glDisableVertexAttribArray(attr);
+    }
+    glDisable(GL_BLEND);
+    glDisable(GL_CULL_FACE);
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_POLYGON_OFFSET_FILL);
+    glDisable(GL_SCISSOR_TEST);
+    glDisable(GL_STENCIL_TEST);
+    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+    glDepthMask(GL_TRUE);
+    glStencilMask(~0);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    m_program = 0;
+    m_arrayBuffer = 0;
+
+    GLint width = 0, height = 0;
+    eglQuerySurface(ctx.dpy, ctx.surface, EGL_WIDTH, &width);
+    eglQuerySurface(ctx.dpy, ctx.surface, EGL_HEIGHT, &height);
+    glViewport(0, 0, width, height);
+
+#if !defined(SUPPORT_ANDROID)
+    if (m_data)
+    {
+        munmap(const_cast<char*>(m_data), m_size);
+    }
+#endif
+    m_buffer.clear();
+    m_data = 0;
+    m_size = 0;
+}
+
+void TraceTest::teardown()
+{
+    releaseResources();
+    ASSERT_GL();
+}
+
+std::string TraceTest::name() const
+{
+    std::string base = m_fileName.substr(m_fileName.rfind('/') + 1);
+    return "trace_" + base.substr(0, base.rfind('.'));
+}
+
+std::string TraceTest::statistics() const
+{
+    std::stringstream s;
+
+    s << (m_frameOffsets.size() - 1) << " trace frames, ";
+    if (m_frames)
+    {
+        s << (m_calls / m_frames) << " calls/frame, ";
+    }
+    s << m_stats.summary();
+    return s.str();
+}
@@ -0,0 +1,96 @@
+/**
+ * OpenGL ES 2.0 memory performance estimator
+ * Copyright (C) 2012 Google
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * \author Sami Kyöstilä <skyostil@google.com>
+ *
+ * Command stream trace replay test
+ */
+#ifndef TRACETEST_H
+#define TRACETEST_H
+
+#include "test.h"
+#include "trace.h"
+#include "framestats.h"
+#include <GLES2/gl2.h>
+#include <map>
+#include <vector>
+
+/**
+ *  Replays a command stream captured with glmemperf-capture.so. The first
+ *  frame of the trace is replayed in prepare() so that the buffers, textures
+ *  and programs it creates are not part of the measurement; the remaining
+ *  frames are then replayed in a loop. Objects created inside the loop are
+ *  deleted whenever it starts over since the trace creates them again.
+ */
+class TraceTest: public Test
+{
+protected:
+    typedef std::map<GLuint, GLuint> NameMap;
+    typedef std::map<std::pair<GLuint, GLint>, GLint> LocationMap;
+    typedef void (GL_APIENTRY *GenFunc)(GLsizei n, GLuint* names);
+    typedef void (GL_APIENTRY *DeleteFunc)(GLsizei n, const GLuint* names);
+
+    std::string m_fileName;
+    const char* m_data;
+    size_t m_size;
+    std::vector<char> m_buffer;
+    std::vector<size_t> m_frameOffsets;
+    int m_nextFrame;
+
+    NameMap m_buffers, m_textures, m_framebuffers, m_renderbuffers;
+    NameMap m_programs, m_shaders;
+    NameMap m_setupBuffers, m_setupTextures, m_setupFramebuffers, m_setupRenderbuffers;
+    NameMap m_setupPrograms, m_setupShaders;    //< Names that outlive each loop
+    LocationMap m_uniforms, m_attribs;
+    GLuint m_program;               //< Current program as named in the trace
+    GLuint m_arrayBuffer;
+
+    int m_calls;
+    int m_frames;
+    FrameStatistics m_stats;
+
+public:
+    /**
+     *  @param fileName         Trace file
+     */
+    TraceTest(const std::string& fileName);
+
+    void prepare();
+    void operator()(int frame);
+    void teardown();
+    std::string name() const;
+    std::string statistics() const;
+
+protected:
+    void loadTrace();
+    void indexFrames();
+    void replayFrame(int frame);
+    void restartLoop();
+    void deleteLoopNames(NameMap& names, const NameMap& setupNames, DeleteFunc del);
+    void releaseResources();
+    void replay(const TraceRecord& rec, const uint32_t* args, const char* data);
+    GLuint mapName(NameMap& names, GLuint name, GenFunc gen = 0);
+    void genNames(NameMap& names, const TraceRecord& rec, const uint32_t* args,
+                  const char* data, GenFunc gen);
+    void deleteNames(NameMap& names, const TraceRecord& rec, const uint32_t* args,
+                     const char* data);
+    GLint uniformLocation(GLint location) const;
+    GLuint attribLocation(GLuint index) const;
+};
+
+#endif // TRACETEST_H
@@ -29,20 +29,174 @@
 
 #include <stdio.h>
 #include <string.h>
+#include <algorithm>
+#include <dirent.h>
 #include <fcntl.h>
+#include <unistd.h>
 
 #if defined(SUPPORT_ANDROID)
 #include <android/asset_manager.h>
 #endif
 
+static std::vector<EGLint> swapDamage;
+
+void setSwapDamage(const EGLint* rects, int count)
+{
+    swapDamage.assign(rects, rects + 4 * count);
+}
+
+static SyncMode currentSyncMode = SYNC_SWAP;
+static EGLSurface windowSurface = EGL_NO_SURFACE;
+static PFNEGLCREATESYNCKHRPROC eglCreateSyncKHR = 0;
+static PFNEGLDESTROYSYNCKHRPROC eglDestroySyncKHR = 0;
+static PFNEGLCLIENTWAITSYNCKHRPROC eglClientWaitSyncKHR = 0;
+
+static void waitForFence()
+{
+    EGLSyncKHR sync = eglCreateSyncKHR(ctx.dpy, EGL_SYNC_FENCE_KHR, NULL);
+    ASSERT(sync != EGL_NO_SYNC_KHR);
+    eglClientWaitSyncKHR(ctx.dpy, sync, EGL_SYNC_FLUSH_COMMANDS_BIT_KHR, EGL_FOREVER_KHR);
+    eglDestroySyncKHR(ctx.dpy, sync);
+}
+
 void swapBuffers()
 {
-#if 1
-    eglSwapBuffers(ctx.dpy, ctx.surface);
-#else
-    GLint pixel[4];
-    glReadPixels(0, 0, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, pixel);
-#endif
+    static PFNEGLSWAPBUFFERSWITHDAMAGEKHRPROC eglSwapBuffersWithDamage = 0;
+    static bool swapWithDamageResolved = false;
+
+    if (currentSyncMode == SYNC_READPIXELS)
+    {
+        GLint pixel[4];
+        glReadPixels(0, 0, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, pixel);
+        swapDamage.clear();
+        return;
+    }
+    else if (currentSyncMode == SYNC_OFFSCREEN)
+    {
+        // Swapping a pbuffer has no effect
+        waitForFence();
+        swapDamage.clear();
+        return;
+    }
+
+    if (swapDamage.size() && !swapWithDamageResolved)
+    {
+        // Both extensions define an identical entry point
+        if (isEGLExtensionSupported("EGL_KHR_swap_buffers_with_damage"))
+        {
+            eglSwapBuffersWithDamage = (PFNEGLSWAPBUFFERSWITHDAMAGEKHRPROC)
+                eglGetProcAddress("eglSwapBuffersWithDamageKHR");
+        }
+        else if (isEGLExtensionSupported("EGL_EXT_swap_buffers_with_damage"))
+        {
+            eglSwapBuffersWithDamage = (PFNEGLSWAPBUFFERSWITHDAMAGEKHRPROC)
+                eglGetProcAddress("eglSwapBuffersWithDamageEXT");
+        }
+        swapWithDamageResolved = true;
+    }
+
+    if (swapDamage.size() && eglSwapBuffersWithDamage)
+    {
+        eglSwapBuffersWithDamage(ctx.dpy, ctx.surface, &swapDamage[0], swapDamage.size() / 4);
+    }
+    else
+    {
+        eglSwapBuffers(ctx.dpy, ctx.surface);
+    }
+    swapDamage.clear();
+
+    if (currentSyncMode == SYNC_FINISH)
+    {
+        glFinish();
+    }
+    else if (currentSyncMode == SYNC_FENCE)
+    {
+        waitForFence();
+    }
+}
+
+bool setSyncMode(SyncMode mode)
+{
+    if (mode == SYNC_FENCE || mode == SYNC_OFFSCREEN)
+    {
+        if (!isEGLExtensionSupported("EGL_KHR_fence_sync"))
+        {
+            LOGW("EGL_KHR_fence_sync not supported\n");
+            return false;
+        }
+        eglCreateSyncKHR = (PFNEGLCREATESYNCKHRPROC)eglGetProcAddress("eglCreateSyncKHR");
+        eglDestroySyncKHR = (PFNEGLDESTROYSYNCKHRPROC)eglGetProcAddress("eglDestroySyncKHR");
+        eglClientWaitSyncKHR = (PFNEGLCLIENTWAITSYNCKHRPROC)eglGetProcAddress("eglClientWaitSyncKHR");
+        ASSERT(eglCreateSyncKHR && eglDestroySyncKHR && eglClientWaitSyncKHR);
+    }
+
+    if (mode == SYNC_OFFSCREEN && windowSurface == EGL_NO_SURFACE)
+    {
+        EGLint width, height;
+        eglQuerySurface(ctx.dpy, ctx.surface, EGL_WIDTH, &width);
+        eglQuerySurface(ctx.dpy, ctx.surface, EGL_HEIGHT, &height);
+
+        const EGLint surfaceAttrs[] =
+        {
+            EGL_WIDTH, width,
+            EGL_HEIGHT, height,
+            EGL_NONE
+        };
+
+        EGLSurface pbuffer = eglCreatePbufferSurface(ctx.dpy, ctx.config, surfaceAttrs);
+        if (pbuffer == EGL_NO_SURFACE)
+        {
+            LOGW("Unable to create a pbuffer\n");
+            return false;
+        }
+
+        windowSurface = ctx.surface;
+        ctx.surface = pbuffer;
+        eglMakeCurrent(ctx.dpy, ctx.surface, ctx.surface, ctx.context);
+    }
+    else if (mode != SYNC_OFFSCREEN && windowSurface != EGL_NO_SURFACE)
+    {
+        eglMakeCurrent(ctx.dpy, windowSurface, windowSurface, ctx.context);
+        eglDestroySurface(ctx.dpy, ctx.surface);
+        ctx.surface = windowSurface;
+        windowSurface = EGL_NO_SURFACE;
+    }
+    ASSERT_EGL();
+
+    currentSyncMode = mode;
+    return true;
+}
+
+SyncMode syncMode()
+{
+    return currentSyncMode;
+}
+
+static const char* syncModeNames[] =
+{
+    "swap",
+    "finish",
+    "fence",
+    "readpixels",
+    "offscreen",
+};
+
+std::string syncModeName(SyncMode mode)
+{
+    return syncModeNames[mode];
+}
+
+bool parseSyncMode(const std::string& name, SyncMode& mode)
+{
+    for (unsigned i = 0; i < sizeof(syncModeNames) / sizeof(syncModeNames[0]); i++)
+    {
+        if (name == syncModeNames[i])
+        {
+            mode = static_cast<SyncMode>(i);
+            return true;
+        }
+    }
+    return false;
 }
 
 bool loadRawTexture(GLenum target, int level, GLenum internalFormat, int width,
@@ -190,10 +344,22 @@ std::string textureFormatName(GLenum format, GLenum type)
         {
             return "r8";
         }
+        else if (format == GL_ALPHA)
+        {
+            return "a8";
+        }
+        else if (format == GL_LUMINANCE_ALPHA)
+        {
+            return "ra88";
+        }
         else if (format == GL_RGB)
         {
             return "rgb888";
         }
+        else if (format == GL_BGRA_EXT)
+        {
+            return "bgra8888";
+        }
         else
         {
             return "rgba8888";
@@ -214,6 +380,18 @@ std::string textureFormatName(GLenum format, GLenum type)
         return "rgba_pvrtc2";
     case GL_ETC1_RGB8_OES:
         return "rgb_etc1";
+    case GL_COMPRESSED_RGB8_ETC2:
+        return "rgb_etc2";
+    case GL_COMPRESSED_RGBA8_ETC2_EAC:
+        return "rgba_etc2_eac";
+    case GL_COMPRESSED_R11_EAC:
+        return "r11_eac";
+    case GL_COMPRESSED_RGBA_ASTC_4x4_KHR:
+        return "rgba_astc4x4";
+    case GL_COMPRESSED_RGBA_ASTC_6x6_KHR:
+        return "rgba_astc6x6";
+    case GL_COMPRESSED_RGBA_ASTC_8x8_KHR:
+        return "rgba_astc8x8";
     default:
         return "unknown";
     }
@@ -379,6 +557,118 @@ static bool isExtensionSupported(const std::string& extensions, const std::strin
     return 0;
 }
 
+bool loadFile(const std::string& fileName, std::vector<char>& data)
+{
+#if defined(SUPPORT_ANDROID)
+    AAsset* asset = AAssetManager_open(ctx.assetManager, fileName.c_str(), O_RDONLY);
+    if (!asset)
+    {
+        LOGW("Unable to open asset %s", fileName.c_str());
+        return false;
+    }
+    data.resize(AAsset_getLength(asset));
+    AAsset_read(asset, &data[0], data.size());
+    AAsset_close(asset);
+#else // !SUPPORT_ANDROID
+    int fd = open(fileName.c_str(), O_RDONLY);
+
+    if (fd == -1)
+    {
+        perror("open");
+        return false;
+    }
+
+    struct stat sb;
+    if (fstat(fd, &sb) == -1)
+    {
+        perror("stat");
+        close(fd);
+        return false;
+    }
+
+    data.resize(sb.st_size);
+    ssize_t offset = 0;
+    while (offset < sb.st_size)
+    {
+        ssize_t n = read(fd, &data[offset], sb.st_size - offset);
+        if (n <= 0)
+        {
+            perror("read");
+            close(fd);
+            return false;
+        }
+        offset += n;
+    }
+    close(fd);
+#endif // !SUPPORT_ANDROID
+
+    return true;
+}
+
+static bool hasSuffix(const std::string& s, const std::string& suffix)
+{
+    return s.size() >= suffix.size() &&
+           s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+bool fileExists(const std::string& fileName)
+{
+#if defined(SUPPORT_ANDROID)
+    AAsset* asset = AAssetManager_open(ctx.assetManager, fileName.c_str(), AASSET_MODE_UNKNOWN);
+    if (!asset)
+    {
+        return false;
+    }
+    AAsset_close(asset);
+    return true;
+#else
+    struct stat sb;
+    return stat(fileName.c_str(), &sb) == 0;
+#endif
+}
+
+std::vector<std::string> listFiles(const std::string& dir, const std::string& suffix)
+{
+    std::vector<std::string> files;
+
+#if defined(SUPPORT_ANDROID)
+    AAssetDir* assetDir = AAssetManager_openDir(ctx.assetManager, dir.c_str());
+    const char* name;
+
+    if (!assetDir)
+    {
+        return files;
+    }
+    while ((name = AAssetDir_getNextFileName(assetDir)))
+    {
+        if (hasSuffix(name, suffix))
+        {
+            files.push_back(dir + "/" + name);
+        }
+    }
+    AAssetDir_close(assetDir);
+#else // !SUPPORT_ANDROID
+    DIR* d = opendir(dir.c_str());
+    struct dirent* entry;
+
+    if (!d)
+    {
+        return files;
+    }
+    while ((entry = readdir(d)))
+    {
+        if (entry->d_name[0] != '.' && hasSuffix(entry->d_name, suffix))
+        {
+            files.push_back(dir + "/" + entry->d_name);
+        }
+    }
+    closedir(d);
+#endif // !SUPPORT_ANDROID
+
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
 bool isEGLExtensionSupported(const std::string& name)
 {
     return isExtensionSupported(eglQueryString(ctx.dpy, EGL_EXTENSIONS), name);
@@ -389,6 +679,94 @@ bool isGLExtensionSupported(const std::string& name)
     return isExtensionSupported((const char*)glGetString(GL_EXTENSIONS), name);
 }
 
+bool isCompressedFormatSupported(GLenum format)
+{
+    GLint count = 0;
+
+    glGetIntegerv(GL_NUM_COMPRESSED_TEXTURE_FORMATS, &count);
+    if (count <= 0)
+    {
+        return false;
+    }
+
+    std::vector<GLint> formats(count);
+    glGetIntegerv(GL_COMPRESSED_TEXTURE_FORMATS, &formats[0]);
+    return std::find(formats.begin(), formats.end(), static_cast<GLint>(format)) != formats.end();
+}
+
+int glesVersion()
+{
+    const char* version = reinterpret_cast<const char*>(glGetString(GL_VERSION));
+    int major = 0;
+
+    if (!version || sscanf(version, "OpenGL ES %d", &major) != 1)
+    {
+        return 2;
+    }
+    return major;
+}
+
+int chooseConfig(EGLDisplay dpy, const EGLint* configAttrs, EGLConfig* config)
+{
+    std::vector<EGLint> attrs;
+    EGLint configCount = 0;
+    int major = 0, minor = 0;
+
+    for (int i = 0; configAttrs[i] != EGL_NONE; i += 2)
+    {
+        if (configAttrs[i] != EGL_RENDERABLE_TYPE)
+        {
+            attrs.push_back(configAttrs[i]);
+            attrs.push_back(configAttrs[i + 1]);
+        }
+    }
+    attrs.push_back(EGL_RENDERABLE_TYPE);
+    attrs.push_back(EGL_OPENGL_ES3_BIT_KHR);
+    attrs.push_back(EGL_NONE);
+
+    // The OpenGL ES 3.0 renderable bit is only defined with EGL 1.5 or
+    // EGL_KHR_create_context
+    const char* version = eglQueryString(dpy, EGL_VERSION);
+    if (version)
+    {
+        sscanf(version, "%d.%d", &major, &minor);
+    }
+    if (major > 1 || minor >= 5 ||
+        isExtensionSupported(eglQueryString(dpy, EGL_EXTENSIONS), "EGL_KHR_create_context"))
+    {
+        if (eglChooseConfig(dpy, &attrs[0], config, 1, &configCount) && configCount)
+        {
+            return 3;
+        }
+        eglGetError();
+    }
+
+    attrs[attrs.size() - 2] = EGL_OPENGL_ES2_BIT;
+    if (eglChooseConfig(dpy, &attrs[0], config, 1, &configCount) && configCount)
+    {
+        return 2;
+    }
+    return 0;
+}
+
+EGLContext createContext(EGLDisplay dpy, EGLConfig config, int clientVersion)
+{
+    EGLint contextAttrs[] =
+    {
+        EGL_CONTEXT_CLIENT_VERSION, clientVersion,
+        EGL_NONE
+    };
+
+    EGLContext context = eglCreateContext(dpy, config, EGL_NO_CONTEXT, contextAttrs);
+    if (context == EGL_NO_CONTEXT && clientVersion > 2)
+    {
+        eglGetError();
+        contextAttrs[1] = 2;
+        context = eglCreateContext(dpy, config, EGL_NO_CONTEXT, contextAttrs);
+    }
+    return context;
+}
+
 int64_t timeDiff(const struct timespec& start, const struct timespec& end)
 {
     int64_t s = start.tv_sec * (1000 * 1000 * 1000LL) + start.tv_nsec;
@@ -24,6 +24,7 @@
 #define UTIL_H
 
 #include <string>
+#include <vector>
 #include <stdio.h>
 #include <GLES2/gl2.h>
 #include <EGL/egl.h>
@@ -108,11 +109,67 @@ struct Context
 
 extern struct Context ctx;
 
+/**
+ *  Ways of completing a frame in swapBuffers()
+ */
+enum SyncMode
+{
+    SYNC_SWAP,                  //< eglSwapBuffers only
+    SYNC_FINISH,                //< eglSwapBuffers followed by glFinish
+    SYNC_FENCE,                 //< eglSwapBuffers followed by an EGL fence wait
+    SYNC_READPIXELS,            //< Read back a single pixel instead of swapping
+    SYNC_OFFSCREEN,             //< Render to a pbuffer and wait on an EGL fence
+};
+
 /**
  *  Indicate that a frame is complete
  */
 void swapBuffers();
 
+/**
+ *  Select how swapBuffers() completes a frame. SYNC_OFFSCREEN replaces the
+ *  current surface with a pbuffer of the same size, which requires a config
+ *  with EGL_PBUFFER_BIT; selecting another mode restores the window surface.
+ *
+ *  @param mode                 Synchronization mode
+ *
+ *  @returns true on success, false if the mode is not supported
+ */
+bool setSyncMode(SyncMode mode);
+
+/**
+ *  @returns the current synchronization mode
+ */
+SyncMode syncMode();
+
+/**
+ *  Describe a synchronization mode
+ *
+ *  @param mode                 Synchronization mode
+ */
+std::string syncModeName(SyncMode mode);
+
+/**
+ *  Look up a synchronization mode by its name
+ *
+ *  @param name                 Name as returned by syncModeName()
+ *  @param mode                 Output: synchronization mode
+ *
+ *  @returns true on success, false if the name is unknown
+ */
+bool parseSyncMode(const std::string& name, SyncMode& mode);
+
+/**
+ *  Limit the screen update done by the next swapBuffers() call to the given
+ *  region. Has no effect if neither EGL_KHR_swap_buffers_with_damage nor
+ *  EGL_EXT_swap_buffers_with_damage is supported.
+ *
+ *  @param rects                Rectangles as x, y, width, height quadruples
+ *                              with the origin at the bottom left corner
+ *  @param count                Number of rectangles
+ */
+void setSwapDamage(const EGLint* rects, int count);
+
 /**
  *  Load a texture from a binary file
  *
@@ -143,6 +200,37 @@ bool loadRawTexture(GLenum target, int level, GLenum internalFormat, int width,
 bool loadCompressedTexture(GLenum target, int level, GLenum internalFormat, int width,
                            int height, const std::string& fileName);
 
+/**
+ *  Read the contents of a data file into memory
+ *
+ *  @param fileName             File to read
+ *  @param data                 Output: file contents
+ *
+ *  @returns true on success, false on failure
+ */
+bool loadFile(const std::string& fileName, std::vector<char>& data);
+
+/**
+ *  Check whether a data file exists without reporting an error if it does
+ *  not
+ *
+ *  @param fileName             File name
+ *
+ *  @returns true if the file exists
+ */
+bool fileExists(const std::string& fileName);
+
+/**
+ *  List the data files in a directory
+ *
+ *  @param dir                  Directory to search
+ *  @param suffix               File name suffix to match, e.g. ".trace"
+ *
+ *  @returns the matching paths relative to the current directory, sorted
+ *  by name
+ */
+std::vector<std::string> listFiles(const std::string& dir, const std::string& suffix);
+
 /**
  *  Check whether an EGL extension is supported
  *
@@ -161,6 +249,49 @@ bool isEGLExtensionSupported(const std::string& name);
  */
 bool isGLExtensionSupported(const std::string& name);
 
+/**
+ *  Check whether a compressed texture format is listed in
+ *  GL_COMPRESSED_TEXTURE_FORMATS
+ *
+ *  @param format               Compressed internal format
+ *
+ *  @returns true if the format is supported
+ */
+bool isCompressedFormatSupported(GLenum format);
+
+/**
+ *  Query the version of the current OpenGL ES context
+ *
+ *  @returns the major version number, e.g. 2 for OpenGL ES 2.0
+ */
+int glesVersion();
+
+/**
+ *  Choose a config for the newest OpenGL ES version that has one, trying
+ *  OpenGL ES 3.0 before 2.0. Any EGL_RENDERABLE_TYPE in the attributes is
+ *  replaced.
+ *
+ *  @param dpy                  EGL display
+ *  @param configAttrs          Config attributes
+ *  @param config               Output: chosen config
+ *
+ *  @returns the major version to request with EGL_CONTEXT_CLIENT_VERSION,
+ *  or zero if no config was found
+ */
+int chooseConfig(EGLDisplay dpy, const EGLint* configAttrs, EGLConfig* config);
+
+/**
+ *  Create a context for a config chosen with chooseConfig(), falling back
+ *  to OpenGL ES 2.0 if the requested version can't be created
+ *
+ *  @param dpy                  EGL display
+ *  @param config               EGL config
+ *  @param clientVersion        Major version returned by chooseConfig()
+ *
+ *  @returns the new context or EGL_NO_CONTEXT on failure
+ */
+EGLContext createContext(EGLDisplay dpy, EGLConfig config, int clientVersion);
+
 /**
  *  Compile a vertex and fragment shader and create a new program from the
  *  result
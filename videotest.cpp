@@ -0,0 +1,455 @@
+/**
+ * OpenGL ES 2.0 memory performance estimator
+ * Copyright (C) 2012 Google
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * \author Sami Kyöstilä <skyostil@google.com>
+ *
+ * YUV video upload and conversion test
+ */
+#include "videotest.h"
+#include "util.h"
+
+#include <sstream>
+#include <stdio.h>
+
+static const char* videoVertSource =
+    "precision mediump float;\n"
+    "attribute vec2 in_position;\n"
+    "attribute vec2 in_texcoord;\n"
+    "varying vec2 texcoord;\n"
+    "\n"
+    "void main()\n"
+    "{\n"
+    "	gl_Position = vec4(in_position, 0.0, 1.0);\n"
+    "	texcoord = in_texcoord;\n"
+    "}\n";
+
+// BT.601 limited range YUV to RGB; the columns are the Y, U and V weights
+static const char* videoConvertSource =
+    "	vec3 yuv = vec3(y - 0.0625, uv.x - 0.5, uv.y - 0.5);\n"
+    "	mat3 m = mat3(1.164,  1.164, 1.164,\n"
+    "	              0.0,   -0.392, 2.017,\n"
+    "	              1.596, -0.813, 0.0);\n"
+    "	gl_FragColor = vec4(m * yuv, 1.0);\n"
+    "}\n";
+
+VideoTest::VideoTest(VideoFormat format, VideoSampler sampler, int width, int height):
+    m_format(format),
+    m_sampler(sampler),
+    m_width(width),
+    m_height(height),
+    m_planes((format == VIDEO_NV12) ? 2 : 3),
+    m_program(0),
+    m_positionAttr(-1),
+    m_texcoordAttr(-1),
+    m_uploadTime(0),
+    m_convertTime(0),
+    m_measuredFrames(0)
+{
+    ASSERT(!(m_width & 1) && !(m_height & 1));
+
+    for (int i = 0; i < VIDEO_MAX_PLANES; i++)
+    {
+        m_textures[i] = 0;
+        m_externalTextures[i] = 0;
+        m_images[i] = EGL_NO_IMAGE_KHR;
+    }
+}
+
+std::string VideoTest::unsupportedReason() const
+{
+    if (m_sampler == VIDEO_EGL_IMAGE)
+    {
+        if (!isGLExtensionSupported("GL_OES_EGL_image_external"))
+        {
+            return "GL_OES_EGL_image_external not supported";
+        }
+        if (!isEGLExtensionSupported("EGL_KHR_image_base"))
+        {
+            return "EGL_KHR_image_base not supported";
+        }
+        if (!isEGLExtensionSupported("EGL_KHR_gl_texture_2D_image"))
+        {
+            return "EGL_KHR_gl_texture_2D_image not supported";
+        }
+    }
+    return "";
+}
+
+void VideoTest::planeLayout(int plane, int& width, int& height, GLenum& format,
+                            size_t& offset) const
+{
+    size_t lumaSize = m_width * m_height;
+    size_t chromaSize = (m_width / 2) * (m_height / 2);
+
+    if (plane == 0)
+    {
+        width = m_width;
+        height = m_height;
+        format = GL_LUMINANCE;
+        offset = 0;
+        return;
+    }
+
+    width = m_width / 2;
+    height = m_height / 2;
+    format = (m_format == VIDEO_NV12) ? GL_LUMINANCE_ALPHA : GL_LUMINANCE;
+    offset = lumaSize + (plane - 1) * chromaSize;
+}
+
+void VideoTest::generateFrame(std::vector<unsigned char>& pixels, int frame) const
+{
+    int chromaW = m_width / 2, chromaH = m_height / 2;
+    int x, y;
+
+    pixels.resize(m_width * m_height * 3 / 2);
+    unsigned char* luma = &pixels[0];
+    unsigned char* chroma = luma + m_width * m_height;
+
+    // Diagonal luma bands over horizontal and vertical chroma ramps
+    for (y = 0; y < m_height; y++)
+    {
+        for (x = 0; x < m_width; x++)
+        {
+            luma[y * m_width + x] = 16 + ((x + y + frame * 32) & 0xff) * 219 / 255;
+        }
+    }
+
+    for (y = 0; y < chromaH; y++)
+    {
+        for (x = 0; x < chromaW; x++)
+        {
+            unsigned char u = 16 + x * 224 / chromaW;
+            unsigned char v = 16 + y * 224 / chromaH;
+
+            if (m_format == VIDEO_NV12)
+            {
+                chroma[(y * chromaW + x) * 2 + 0] = u;
+                chroma[(y * chromaW + x) * 2 + 1] = v;
+            }
+            else
+            {
+                chroma[y * chromaW + x] = u;
+                chroma[chromaW * chromaH + y * chromaW + x] = v;
+            }
+        }
+    }
+}
+
+void VideoTest::prepareExternalTextures()
+{
+    m_eglCreateImageKHR =
+        (PFNEGLCREATEIMAGEKHRPROC)eglGetProcAddress("eglCreateImageKHR");
+    m_eglDestroyImageKHR =
+        (PFNEGLDESTROYIMAGEKHRPROC)eglGetProcAddress("eglDestroyImageKHR");
+    m_glEGLImageTargetTexture2DOES =
+        (PFNGLEGLIMAGETARGETTEXTURE2DOESPROC)eglGetProcAddress("glEGLImageTargetTexture2DOES");
+    ASSERT(m_eglCreateImageKHR);
+    ASSERT(m_eglDestroyImageKHR);
+    ASSERT(m_glEGLImageTargetTexture2DOES);
+
+    // The uploaded planes are shared with external textures through EGL
+    // images, which is how decoder output usually reaches the GPU
+    glGenTextures(m_planes, m_externalTextures);
+    for (int i = 0; i < m_planes; i++)
+    {
+        m_images[i] = m_eglCreateImageKHR(ctx.dpy, ctx.context, EGL_GL_TEXTURE_2D_KHR,
+                                          (EGLClientBuffer)(intptr_t)m_textures[i], NULL);
+        if (m_images[i] == EGL_NO_IMAGE_KHR)
+        {
+            fail("EGL image creation from a luminance texture failed");
+        }
+
+        glBindTexture(GL_TEXTURE_EXTERNAL_OES, m_externalTextures[i]);
+        glTexParameteri(GL_TEXTURE_EXTERNAL_OES, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_EXTERNAL_OES, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        m_glEGLImageTargetTexture2DOES(GL_TEXTURE_EXTERNAL_OES, m_images[i]);
+        ASSERT_GL();
+    }
+}
+
+void VideoTest::prepare()
+{
+    std::stringstream frag;
+    const char* samplerType = (m_sampler == VIDEO_EGL_IMAGE) ? "samplerExternalOES" : "sampler2D";
+    int i;
+
+    if (m_sampler == VIDEO_EGL_IMAGE)
+    {
+        frag << "#extension GL_OES_EGL_image_external : require\n";
+    }
+    frag << "precision mediump float;\n"
+            "varying vec2 texcoord;\n";
+    for (i = 0; i < m_planes; i++)
+    {
+        frag << "uniform " << samplerType << " plane" << i << ";\n";
+    }
+    frag << "\n"
+            "void main()\n"
+            "{\n"
+            "	float y = texture2D(plane0, texcoord).r;\n";
+    if (m_format == VIDEO_NV12)
+    {
+        frag << "	vec2 uv = texture2D(plane1, texcoord).ra;\n";
+    }
+    else
+    {
+        frag << "	vec2 uv = vec2(texture2D(plane1, texcoord).r,\n"
+                "	               texture2D(plane2, texcoord).r);\n";
+    }
+    frag << videoConvertSource;
+
+    // teardown() is not called for a test that fails to prepare
+    try
+    {
+        prepareResources(frag.str());
+    }
+    catch (...)
+    {
+        releaseResources();
+        throw;
+    }
+}
+
+void VideoTest::prepareResources(const std::string& fragSource)
+{
+    int i;
+
+    m_program = createProgram(videoVertSource, fragSource);
+    glUseProgram(m_program);
+
+    m_positionAttr = glGetAttribLocation(m_program, "in_position");
+    m_texcoordAttr = glGetAttribLocation(m_program, "in_texcoord");
+    ASSERT(m_positionAttr >= 0);
+    ASSERT(m_texcoordAttr >= 0);
+
+    for (i = 0; i < m_planes; i++)
+    {
+        std::stringstream unif;
+        unif << "plane" << i;
+        glUniform1i(glGetUniformLocation(m_program, unif.str().c_str()), i);
+    }
+
+    for (i = 0; i < VIDEO_SOURCE_FRAMES; i++)
+    {
+        generateFrame(m_frames[i], i);
+    }
+
+    glGenTextures(m_planes, m_textures);
+    for (i = 0; i < m_planes; i++)
+    {
+        int width, height;
+        GLenum format;
+        size_t offset;
+
+        planeLayout(i, width, height, format, offset);
+        glBindTexture(GL_TEXTURE_2D, m_textures[i]);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format,
+                     GL_UNSIGNED_BYTE, &m_frames[0][offset]);
+    }
+    ASSERT_GL();
+
+    if (m_sampler == VIDEO_EGL_IMAGE)
+    {
+        prepareExternalTextures();
+    }
+
+    glEnableVertexAttribArray(m_positionAttr);
+    glEnableVertexAttribArray(m_texcoordAttr);
+    ASSERT_GL();
+}
+
+void VideoTest::upload(int frame)
+{
+    const std::vector<unsigned char>& pixels = m_frames[frame % VIDEO_SOURCE_FRAMES];
+
+    for (int i = 0; i < m_planes; i++)
+    {
+        int width, height;
+        GLenum format;
+        size_t offset;
+
+        planeLayout(i, width, height, format, offset);
+        glBindTexture(GL_TEXTURE_2D, m_textures[i]);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, format,
+                        GL_UNSIGNED_BYTE, &pixels[offset]);
+    }
+}
+
+void VideoTest::convert()
+{
+    const GLfloat vertices[] =
+    {
+        -1, -1,
+        -1,  1,
+         1, -1,
+         1,  1
+    };
+
+    const GLfloat texcoords[] =
+    {
+        0, 1,
+        0, 0,
+        1, 1,
+        1, 0
+    };
+
+    for (int i = 0; i < m_planes; i++)
+    {
+        glActiveTexture(GL_TEXTURE0 + i);
+        if (m_sampler == VIDEO_EGL_IMAGE)
+        {
+            glBindTexture(GL_TEXTURE_EXTERNAL_OES, m_externalTextures[i]);
+        }
+        else
+        {
+            glBindTexture(GL_TEXTURE_2D, m_textures[i]);
+        }
+    }
+
+    glVertexAttribPointer(m_positionAttr, 2, GL_FLOAT, GL_FALSE, 0, vertices);
+    glVertexAttribPointer(m_texcoordAttr, 2, GL_FLOAT, GL_FALSE, 0, texcoords);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    glActiveTexture(GL_TEXTURE0);
+}
+
+void VideoTest::operator()(int frame)
+{
+    struct timespec start, uploaded, converted;
+
+    // Warmup frames are all numbered zero
+    if (frame == 0)
+    {
+        m_stats.reset(0);
+        m_uploadTime = 0;
+        m_convertTime = 0;
+        m_measuredFrames = 0;
+    }
+    m_stats.frame();
+
+    clock_gettime(CLOCK_REALTIME, &start);
+    glActiveTexture(GL_TEXTURE0);
+    upload(frame);
+    glFinish();
+    clock_gettime(CLOCK_REALTIME, &uploaded);
+
+    convert();
+    glFinish();
+    clock_gettime(CLOCK_REALTIME, &converted);
+
+    m_uploadTime += timeDiff(start, uploaded);
+    m_convertTime += timeDiff(uploaded, converted);
+    m_measuredFrames++;
+}
+
+void VideoTest::releaseResources()
+{
+    for (int i = 0; i < m_planes; i++)
+    {
+        if (m_images[i] != EGL_NO_IMAGE_KHR)
+        {
+            m_eglDestroyImageKHR(ctx.dpy, m_images[i]);
+            m_images[i] = EGL_NO_IMAGE_KHR;
+        }
+    }
+    if (m_sampler == VIDEO_EGL_IMAGE)
+    {
+        glDeleteTextures(m_planes, m_externalTextures);
+    }
+    glDeleteTextures(m_planes, m_textures);
+    for (int i = 0; i < m_planes; i++)
+    {
+        m_textures[i] = 0;
+        m_externalTextures[i] = 0;
+    }
+
+    glUseProgram(0);
+    if (m_positionAttr >= 0)
+    {
+        glDisableVertexAttribArray(m_positionAttr);
+        m_positionAttr = -1;
+    }
+    if (m_texcoordAttr >= 0)
+    {
+        glDisableVertexAttribArray(m_texcoordAttr);
+        m_texcoordAttr = -1;
+    }
+    glDeleteProgram(m_program);
+    m_program = 0;
+
+    for (int i = 0; i < VIDEO_SOURCE_FRAMES; i++)
+    {
+        m_frames[i].clear();
+    }
+}
+
+void VideoTest::teardown()
+{
+    releaseResources();
+    ASSERT_GL();
+}
+
+std::string VideoTest::name() const
+{
+    std::stringstream s;
+
+    s << "video_" << ((m_format == VIDEO_NV12) ? "nv12" : "i420");
+    s << "_" << m_width << "x" << m_height;
+    if (m_sampler == VIDEO_EGL_IMAGE)
+    {
+        s << "_eglimage";
+    }
+
+    return s.str();
+}
+
+std::string VideoTest::baselineName() const
+{
+    if (m_sampler == VIDEO_EGL_IMAGE)
+    {
+        return VideoTest(m_format, VIDEO_TEXTURE_2D, m_width, m_height).name();
+    }
+    if (m_format == VIDEO_I420)
+    {
+        return VideoTest(VIDEO_NV12, VIDEO_TEXTURE_2D, m_width, m_height).name();
+    }
+    return "";
+}
+
+int64_t VideoTest::bytesPerFrame() const
+{
+    return m_width * m_height * 3 / 2;
+}
+
+std::string VideoTest::statistics() const
+{
+    char buf[96];
+
+    if (!m_measuredFrames)
+    {
+        return "";
+    }
+    snprintf(buf, sizeof(buf), "upload %5.2f ms convert %5.2f ms total %5.2f ms ",
+             m_uploadTime / (1000.0f * 1000.0f * m_measuredFrames),
+             m_convertTime / (1000.0f * 1000.0f * m_measuredFrames),
+             (m_uploadTime + m_convertTime) / (1000.0f * 1000.0f * m_measuredFrames));
+    return buf + m_stats.summary();
+}
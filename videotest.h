@@ -0,0 +1,113 @@
+/**
+ * OpenGL ES 2.0 memory performance estimator
+ * Copyright (C) 2012 Google
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * \author Sami Kyöstilä <skyostil@google.com>
+ *
+ * YUV video upload and conversion test
+ */
+#ifndef VIDEOTEST_H
+#define VIDEOTEST_H
+
+#include "test.h"
+#include "framestats.h"
+#include "ext.h"
+#include <GLES2/gl2.h>
+#include <EGL/egl.h>
+#include <vector>
+
+enum VideoFormat
+{
+    VIDEO_NV12,                 //< Y plane and interleaved UV plane
+    VIDEO_I420,                 //< Separate Y, U and V planes
+};
+
+enum VideoSampler
+{
+    VIDEO_TEXTURE_2D,           //< Planes sampled as regular 2D textures
+    VIDEO_EGL_IMAGE,            //< Plane textures shared through EGL images and
+                                //  sampled as GL_OES_EGL_image_external
+};
+
+const int VIDEO_MAX_PLANES = 3;
+const int VIDEO_SOURCE_FRAMES = 2;
+
+/**
+ *  Streams synthetic YUV 4:2:0 frames into one texture per plane and
+ *  converts them to RGB in a fragment shader while drawing to the screen.
+ *  The upload and the conversion are each followed by glFinish() so that
+ *  their costs can be reported separately.
+ *
+ *  The EGL image variant wraps each uploaded single-channel plane in an EGL
+ *  image and samples it through an external texture. It measures the cost of
+ *  the external sampler path over GL-owned planes; it does not cover native
+ *  YUV buffers that a driver samples with its own color conversion.
+ */
+class VideoTest: public Test
+{
+protected:
+    VideoFormat m_format;
+    VideoSampler m_sampler;
+    int m_width, m_height;
+    int m_planes;
+
+    GLint m_program;
+    GLint m_positionAttr, m_texcoordAttr;
+    GLuint m_textures[VIDEO_MAX_PLANES];
+    GLuint m_externalTextures[VIDEO_MAX_PLANES];
+    EGLImageKHR m_images[VIDEO_MAX_PLANES];
+    std::vector<unsigned char> m_frames[VIDEO_SOURCE_FRAMES];
+
+    FrameStatistics m_stats;
+    int64_t m_uploadTime;
+    int64_t m_convertTime;
+    int m_measuredFrames;
+
+    PFNEGLCREATEIMAGEKHRPROC m_eglCreateImageKHR;
+    PFNEGLDESTROYIMAGEKHRPROC m_eglDestroyImageKHR;
+    PFNGLEGLIMAGETARGETTEXTURE2DOESPROC m_glEGLImageTargetTexture2DOES;
+
+public:
+    /**
+     *  @param format           Plane layout of the video frames
+     *  @param sampler          How the planes are sampled by the shader
+     *  @param width            Frame width, must be even
+     *  @param height           Frame height, must be even
+     */
+    VideoTest(VideoFormat format, VideoSampler sampler, int width, int height);
+
+    std::string unsupportedReason() const;
+    void prepare();
+    void operator()(int frame);
+    void teardown();
+    std::string name() const;
+    std::string baselineName() const;
+    int64_t bytesPerFrame() const;
+    std::string statistics() const;
+
+protected:
+    void planeLayout(int plane, int& width, int& height, GLenum& format,
+                     size_t& offset) const;
+    void generateFrame(std::vector<unsigned char>& pixels, int frame) const;
+    void prepareResources(const std::string& fragSource);
+    void prepareExternalTextures();
+    void releaseResources();
+    void upload(int frame);
+    void convert();
+};
+
+#endif // VIDEOTEST_H